@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
+#include <cctype>
+#include <fstream>
 
 #include "err.hpp"
 #include "lilc_compiler.hpp"
@@ -8,25 +10,110 @@
 
 using namespace LILC;
 
+static int usage(){
+	std::cout << "Usage: lilcc [-O<level>] [-f<opt>] [-fno-<opt>]"
+		" [--time-passes] [--mem-stats] [--stats-json=<file>]"
+		" [--inline-limit=<n>]"
+		" [--tokens=<file>] [--unparse=<file>] [-S <file>]"
+		" <infile> [<outfile>]" << std::endl;
+	return 1;
+}
+
 int 
 main( const int argc, const char **argv )
 {
-	if (argc != 3){
-		std::cout << "Usage: lilcc <infile> <outfile>" 
-			<< std::endl;
-		return 1;
+	LILC::LilC_Compiler compiler;
+	LILC::LilC_Options& options = compiler.getOptions();
+	const char * files[2];
+	int numFiles = 0;
+	bool timePasses = false;
+	bool memStats = false;
+	std::string statsJson = "";
+	const char * tokensFile = nullptr;
+	const char * unparseFile = nullptr;
+	const char * asmFile = nullptr;
+	for (int i = 1; i < argc; i++){
+		std::string arg = argv[i];
+		if (arg.compare(0, 2, "-O") == 0 && arg.size() == 3
+			&& isdigit(arg[2])){
+			options.setOptLevel(arg[2] - '0');
+		} else if (arg == "--time-passes"){
+			timePasses = true;
+		} else if (arg == "--mem-stats"){
+			memStats = true;
+		} else if (arg.compare(0, 13, "--stats-json=") == 0
+			&& arg.size() > 13){
+			statsJson = arg.substr(13);
+		} else if (arg.compare(0, 15, "--inline-limit=") == 0
+			&& arg.size() > 15 && isdigit(arg[15])){
+			options.inlineLimit = atoi(argv[i] + 15);
+		} else if (arg.compare(0, 9, "--tokens=") == 0
+			&& arg.size() > 9){
+			tokensFile = argv[i] + 9;
+		} else if (arg.compare(0, 10, "--unparse=") == 0
+			&& arg.size() > 10){
+			unparseFile = argv[i] + 10;
+		} else if (arg == "-S" && i + 1 < argc){
+			asmFile = argv[++i];
+		} else if (arg.compare(0, 5, "-fno-") == 0){
+			if (!options.setFlag(arg.substr(5), false)){
+				return usage();
+			}
+		} else if (arg.compare(0, 2, "-f") == 0){
+			if (!options.setFlag(arg.substr(2), true)){
+				return usage();
+			}
+		} else if (numFiles < 2 && arg[0] != '-'){
+			files[numFiles++] = argv[i];
+		} else {
+			return usage();
+		}
+	}
+	if (numFiles == 2 && asmFile == nullptr){
+		asmFile = files[1];
+	} else if (numFiles != 1){
+		return usage();
+	}
+	if (tokensFile == nullptr && unparseFile == nullptr
+		&& asmFile == nullptr){
+		return usage();
+	}
+	LILC::LilC_PassStats& stats = compiler.getStats();
+	if (timePasses || memStats || statsJson != ""){
+		stats.enable();
 	}
 
-	LILC::LilC_Compiler compiler;
 	try {
-		if (compiler.codeGen(argv[1], argv[2])){
+		compiler.open(files[0]);
+		bool ok = true;
+		if (tokensFile != nullptr){
+			compiler.writeTokens(tokensFile);
+		}
+		if (unparseFile != nullptr){
+			ok = compiler.unparse(unparseFile) && ok;
+		}
+		if (asmFile != nullptr){
+			ok = compiler.codeGen(asmFile) && ok;
+		}
+		LILC::LilC_Arena& arena = compiler.getArena();
+		stats.setArenaBytes(arena.bytesUsed(), arena.bytesReserved());
+		if (timePasses || memStats){
+			stats.printText(std::cerr, timePasses, memStats);
+		}
+		if (statsJson == "-"){
+			stats.printJson(std::cerr);
+		} else if (statsJson != ""){
+			std::ofstream json(statsJson);
+			stats.printJson(json);
+		}
+		if (ok){
 			return 0;
 		}
 	} catch (LILC::ToDoError& err){
 		std::cerr << err.what() << std::endl;
 	} catch (LILC::InternalError& err){
 		std::cerr << err.what() << std::endl;
-	} catch (std::runtime_error err){
+	} catch (std::runtime_error& err){
 		std::cerr << "runtime error" << std::endl;
 		std::cerr << err.what() << std::endl;
 	}
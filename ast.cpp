@@ -5,4 +5,8 @@
 
 namespace LILC {
 
+// The parser passes this by reference when it builds nodes in
+// the arena, so it needs a definition
+const int VarDeclNode::NOT_STRUCT;
+
 } // End namespace LIL' C
@@ -7,12 +7,13 @@
 #include "tokens.hpp"
 #include "symbol_table.hpp"
 #include "lilc_mips.hpp"
+#include "ir.hpp"
+#include "lilc_arena.hpp"
 
 enum BinOpKind { REL, LOG, MATH, EQ};
 
 namespace LILC{
 	class SymbolTable;
-	class ScopeTable;
 	class SymbolTableEntry;
 	class VarSymbol;
 }
@@ -30,20 +31,35 @@ class TypeNode;
 class ExpNode;
 class IdNode;
 
+/* The concrete node classes, one kind each, so a pass can switch
+  on getNodeKind() instead of adding a virtual method to every
+  class (see ast_visitor.hpp).
+*/
+enum class NodeKind {
+	PROGRAM, DECL_LIST, FORMALS_LIST, EXP_LIST, STMT_LIST, FN_BODY,
+	VAR_DECL, FN_DECL, FORMAL_DECL, STRUCT_DECL,
+	INT_TYPE, BOOL_TYPE, VOID_TYPE, STRUCT_TYPE,
+	ID, INT_LIT, STR_LIT, TRUE_LIT, FALSE_LIT,
+	DOT_ACCESS, ASSIGN, CALL_EXP,
+	UNARY_MINUS, NOT, SHIFT_LEFT, SHIFT_RIGHT,
+	PLUS, MINUS, TIMES, DIVIDE, AND, OR,
+	EQUALS, NOT_EQUALS, LESS, GREATER, LESS_EQ, GREATER_EQ,
+	ASSIGN_STMT, POST_INC_STMT, POST_DEC_STMT, READ_STMT,
+	WRITE_STMT, IF_STMT, IF_ELSE_STMT, WHILE_STMT, CALL_STMT,
+	RETURN_STMT
+};
+
 class ASTNode{
 public:
-	ASTNode(size_t lineIn, size_t colIn){
+	ASTNode(NodeKind kindIn, size_t lineIn, size_t colIn)
+	: myKind(kindIn){
 		this->line = lineIn;
 		this->col = colIn;
 		has_main = false;
 	}
-	virtual void unparse(std::ostream& out, int indent) = 0;
 	virtual bool nameAnalysis(SymbolTable * symTab) = 0;
 	virtual bool typeAnalysis();
 	virtual bool codeGen(LilC_Backend* backend);
-	void doIndent(std::ostream& out, int indent){
-		for (int k = 0 ; k < indent; k++){ out << " "; }
-	}
 	virtual size_t getLine(){ return line; }
 	virtual size_t getCol(){ return col; }
 	virtual std::string getPosition() {
@@ -55,7 +71,9 @@ public:
 		return res;
 	}
 	virtual bool hasMain() {return has_main;}
+	NodeKind getNodeKind() const { return myKind; }
 protected:
+	const NodeKind myKind;
 	size_t line;
 	size_t col;
 	bool has_main;
@@ -63,24 +81,31 @@ protected:
 
 class ProgramNode : public ASTNode{
 public:
-	ProgramNode(DeclListNode * declList) : ASTNode(0,0){
+	ProgramNode(DeclListNode * declList)
+	: ASTNode(NodeKind::PROGRAM, 0,0){
 		myDeclList = declList;
 	}
 	bool nameAnalysis(SymbolTable * symTab) override;
 	bool typeAnalysis() override;
 	virtual bool codeGen(LilC_Backend* backend);
-	void unparse(std::ostream& out, int indent) override;
+	// Defined in ir_lowering.cpp, on top of ASTVisitor
+	void lower(IRModule& module);
+	// Defined in constant_folding.cpp, on top of ASTVisitor
+	void constFold(LilC_Arena& arena);
+	// Defined in dead_code.cpp, on top of ASTVisitor
+	void removeDeadCode();
+	// Defined in unparse.cpp, on top of ASTVisitor
+	void unparse(std::ostream& out, int indent);
 	virtual ~ProgramNode(){ }
+	DeclListNode * getDeclList() { return myDeclList; }
 private:
 	DeclListNode * myDeclList;
 };
 
 class TypeNode : public ASTNode{
 public:
-	TypeNode(size_t lineIn, size_t colIn)
-	: ASTNode(lineIn, colIn){ }
-	virtual void unparse(std::ostream& out, int indent)
-		override = 0;
+	TypeNode(NodeKind kindIn, size_t lineIn, size_t colIn)
+	: ASTNode(kindIn, lineIn, colIn){ }
 	virtual bool nameAnalysis(SymbolTable * symTab)
 		override = 0;
 	virtual std::string getTypeString() = 0;
@@ -95,7 +120,8 @@ protected:
 
 class DeclListNode : public ASTNode{
 public:
-	DeclListNode(std::list<DeclNode *> * decls) : ASTNode(0,0){
+	DeclListNode(NodeList<DeclNode *> * decls)
+	: ASTNode(NodeKind::DECL_LIST, 0,0){
         	myDecls = decls;
 	}
 	FieldMap * fieldNameAnalysis(SymbolTable * symTab);
@@ -105,10 +131,10 @@ public:
 	bool globalNameAnalysis(SymbolTable * symTab);
 	bool codeGen(LilC_Backend* backend);
 	bool typeAnalysis();
-	void unparse(std::ostream& out, int indent);
 	int sizeOfDecls() {return myDecls->size() * 4;}
+	NodeList<DeclNode *>& getDecls() { return *myDecls; }
 private:
-	std::list<DeclNode *> * myDecls;
+	NodeList<DeclNode *> * myDecls;
 	bool fieldNameAnalysis(SymbolTable * symTab, FieldMap * m);
 };
 
@@ -116,12 +142,11 @@ private:
 
 class ExpNode : public ASTNode{
 public:
-	ExpNode(size_t lIn, size_t cIn) : ASTNode(lIn, cIn){ }
-	virtual void unparse(std::ostream& out, int indent)
-		override = 0;
+	ExpNode(NodeKind kindIn, size_t lIn, size_t cIn)
+	: ASTNode(kindIn, lIn, cIn){ }
 	virtual bool nameAnalysis(SymbolTable * symTab)
 		override = 0;
-	virtual std::string expTypeAnalysis() = 0;
+	virtual const LilC_Type * expTypeAnalysis() = 0;
 	virtual bool codeGen(LilC_Backend* backend) {
 		throw runtime_error("ExpNode not implemented");
 	}
@@ -138,26 +163,52 @@ public:
 	virtual bool genJumpAndLink(LilC_Backend* backend) {
 		throw runtime_error("ExpNode not implemented");
 	}
+
+	// Register-allocating code generation: evaluate into a
+	// register from the backend's pool and return it
+	virtual int codeGenReg(LilC_Backend* backend) {
+		throw runtime_error("ExpNode not implemented");
+	}
+	// Store the value in reg to the location this expression
+	// names (only meaningful for lvalues)
+	virtual void genStore(LilC_Backend* backend, int reg) {
+		throw runtime_error("ExpNode not implemented");
+	}
+	// Sethi-Ullman number: registers needed to evaluate this
+	// expression without spilling
+	virtual int regNeed() { return 1; }
+	virtual bool hasSideEffects() { return false; }
+	int genValue(LilC_Backend* backend, int dest);
+
+	// Jumping code for conditions: branch to label if this
+	// (bool) expression evaluates to jumpIf, else fall through
+	virtual void genBranch(LilC_Backend* backend,
+		MipsOperand label, bool jumpIf);
+
+	// If this is an int or bool literal, set value to it
+	virtual bool constValue(int& value) { return false; }
 };
 
 class IdNode : public ExpNode{
 public:
-	IdNode(IDToken * token)
-	: ExpNode(token->line, token->column){
-		if (token->line == 0){
+	IdNode(TokenRef token)
+	: ExpNode(NodeKind::ID, token.line(), token.column()),
+	  myNameId(token.nameId()), myStrVal(token.name()){
+		if (token.line() == 0){
 			throw InternalError("bad token pos");
 		}
-		myStrVal = token->value();
 	}
-	void unparse(std::ostream& out, int indent) override;
 	bool nameAnalysis(SymbolTable * symTab) override;
 	bool genAddr(LilC_Backend* backend) override;
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 	bool genJumpAndLink(LilC_Backend* backend) override;
+	void genStore(LilC_Backend* backend, int reg) override;
 	StructSymbol * dotNameAnalysis(
 		SymbolTable * symTab) override;
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	virtual std::string getString() { return myStrVal; }
+	int getNameId() { return myNameId; }
 	virtual SymbolTableEntry * getSymbol() { return mySymbol; }
 	void setSymbol(SymbolTableEntry * symbolIn){
 		this->mySymbol = symbolIn;
@@ -165,16 +216,17 @@ public:
 
 private:
 	SymbolTableEntry * mySymbol;
-	std::string myStrVal;
+	int myNameId;
+	// interned by the scanner
+	const std::string& myStrVal;
 };
 
 class DeclNode : public ASTNode{
 public:
-	DeclNode(size_t lIn, size_t cIn, IdNode * id)
-	: ASTNode(lIn, cIn) {
+	DeclNode(NodeKind kindIn, size_t lIn, size_t cIn, IdNode * id)
+	: ASTNode(kindIn, lIn, cIn) {
 		this->myDeclaredID = id;
 	}
-	virtual void unparse(std::ostream& out, int indent) = 0;
 	virtual bool nameAnalysis(SymbolTable * symTab) = 0;
 	virtual bool typeAnalysis();
 	virtual bool globalCodeGen(LilC_Backend* backend) = 0;
@@ -182,6 +234,7 @@ public:
 	virtual std::string getName() {
 		return myDeclaredID->getString();
 	}
+	int getNameId() { return myDeclaredID->getNameId(); }
 	virtual IdNode * getDeclaredID() { return myDeclaredID; }
 	virtual DeclKind getKind() = 0;
 protected:
@@ -191,76 +244,79 @@ protected:
 
 class StmtNode : public ASTNode{
 public:
-	StmtNode(size_t lIn, size_t cIn) : ASTNode(lIn, cIn){ }
-	virtual void unparse(std::ostream& out, int indent) = 0;
+	StmtNode(NodeKind kindIn, size_t lIn, size_t cIn)
+	: ASTNode(kindIn, lIn, cIn){ }
 	virtual bool nameAnalysis(SymbolTable * symTab) = 0;
 	virtual bool nameAnalysisWithOffset(SymbolTable * symTab,int offset) { return nameAnalysis(symTab);};
 	virtual bool stmtTypeAnalysis(FuncSymbol * fnSym) = 0;
 	virtual bool codeGen(LilC_Backend* backend) = 0;
-	virtual bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
+	virtual bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
 		return codeGen(backend);
 	}
 };
 
 class FormalsListNode : public ASTNode{
 public:
-	FormalsListNode(std::list<FormalDeclNode *> * formalsIn)
-	: ASTNode(0, 0){
+	FormalsListNode(NodeList<FormalDeclNode *> * formalsIn)
+	: ASTNode(NodeKind::FORMALS_LIST, 0, 0){
 		myFormals = formalsIn;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	std::list<VarSymbol *> * getSymbols();
 	virtual std::string getTypeString();
 	int offsetSize() {return myFormals->size() * 4;}
+	NodeList<FormalDeclNode *>& getFormals() { return *myFormals; }
 
 private:
-	std::list<FormalDeclNode *> * myFormals;
+	NodeList<FormalDeclNode *> * myFormals;
 };
 
 class ExpListNode : public ASTNode{
 public:
-	ExpListNode(std::list<ExpNode *> * exps) : ASTNode(0,0){
-		myExps = *exps;
+	ExpListNode(NodeList<ExpNode *> * exps)
+	: ASTNode(NodeKind::EXP_LIST, 0,0){
+		myExps = exps;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	virtual bool nameAnalysis(SymbolTable * symTab) override;
-	std::list<ExpNode *> * getExps() { return &myExps; }
+	NodeList<ExpNode *> * getExps() { return myExps; }
 	bool codeGen(LilC_Backend* backend) override;
 
 private:
-	std::list<ExpNode *> myExps;
+	NodeList<ExpNode *> * myExps;
 };
 
 class StmtListNode : public ASTNode{
 public:
-	StmtListNode(std::list<StmtNode *> * stmtsIn) : ASTNode(0,0){
+	StmtListNode(NodeList<StmtNode *> * stmtsIn)
+	: ASTNode(NodeKind::STMT_LIST, 0,0){
 		myStmts = stmtsIn;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	bool nameAnalysis(SymbolTable * symTab) override;
 	bool nameAnalysisWithOffset(SymbolTable * symTab, int offset);
 	bool codeGen(LilC_Backend* backend) override;
-	bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel);
+	bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel);
 	bool stmtTypeAnalysis(FuncSymbol * fnSym);
+	NodeList<StmtNode *>& getStmts() { return *myStmts; }
 
 private:
-	std::list<StmtNode *> * myStmts;
+	NodeList<StmtNode *> * myStmts;
 };
 
 class FnBodyNode : public ASTNode{
 public:
-	FnBodyNode(size_t lIn, size_t cIn, DeclListNode * decls, StmtListNode * stmts) : ASTNode(lIn, cIn){
+	FnBodyNode(size_t lIn, size_t cIn, DeclListNode * decls, StmtListNode * stmts)
+	: ASTNode(NodeKind::FN_BODY, lIn, cIn){
 		myDeclList = decls;
 		myStmtList = stmts;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	bool nameAnalysis(SymbolTable * symTab) override;
 	bool nameAnalysisWithOffset(SymbolTable* symTab, int offset);
 	bool codeGen(LilC_Backend* backend) override;
-	bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel);
+	bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel);
 	virtual bool fnTypeAnalysis(FuncSymbol * fnSym);
 	int getLocalsSize() {return myDeclList->sizeOfDecls();}
+	DeclListNode * getDeclList() { return myDeclList; }
+	StmtListNode * getStmtList() { return myStmtList; }
 
 private:
 	DeclListNode * myDeclList;
@@ -275,20 +331,23 @@ public:
 		IdNode * id,
 		FormalsListNode * formals,
 		FnBodyNode * fnBody)
-		: DeclNode(type->getLine(), type->getCol(), id)
+		: DeclNode(NodeKind::FN_DECL,
+			type->getLine(), type->getCol(), id)
 	{
 		myRetType = type;
 		myId = id;
 		myFormals = formals;
 		myBody = fnBody;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	virtual bool nameAnalysis(SymbolTable * symTab) override;
 	virtual bool globalCodeGen(LilC_Backend* backend) override;
 	bool typeAnalysis() override;
 	virtual std::string getTypeString() override;
 	VarSymbol * makeRetSymbol(SymbolTable * symTab);
 	virtual DeclKind getKind() override { return DeclKind::FUNC; }
+	TypeNode * getRetType() { return myRetType; }
+	FormalsListNode * getFormals() { return myFormals; }
+	FnBodyNode * getBody() { return myBody; }
 
 private:
 	TypeNode * myRetType;
@@ -301,10 +360,10 @@ private:
 class FormalDeclNode : public DeclNode{
 public:
 	FormalDeclNode(TypeNode * type, IdNode * id)
-	: DeclNode(type->getLine(), type->getCol(), id){
+	: DeclNode(NodeKind::FORMAL_DECL,
+		type->getLine(), type->getCol(), id){
 		myType = type;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	virtual bool nameAnalysis(SymbolTable * symTab) override;
 	virtual bool globalCodeGen(LilC_Backend* backend) override;
 	VarSymbol * getSymbol();
@@ -312,6 +371,7 @@ public:
 	virtual DeclKind getKind() override {
 		return DeclKind::FORMAL;
 	}
+	TypeNode * getTypeNode() { return myType; }
 
 private:
 	TypeNode * myType;
@@ -322,10 +382,9 @@ class StructDeclNode : public DeclNode{
 public:
 	StructDeclNode(size_t lIn, size_t cIn,
 		IdNode * id, DeclListNode * decls )
-	: DeclNode(id->getLine(), id->getCol(), id){
+	: DeclNode(NodeKind::STRUCT_DECL, id->getLine(), id->getCol(), id){
 		myDeclList = decls;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	bool nameAnalysis(SymbolTable * symTab) override;
 	virtual bool globalCodeGen(LilC_Backend* backend) override;
 	virtual std::string getTypeString() override;
@@ -334,6 +393,7 @@ public:
 	}
 	static const int NOT_STRUCT = -1; //Use this value for mySize
 					  // if this is not a struct type
+	DeclListNode * getDeclList() { return myDeclList; }
 private:
 	DeclListNode * myDeclList;
 };
@@ -341,24 +401,21 @@ private:
 
 class IntNode : public TypeNode{
 public:
-	IntNode(size_t lIn, size_t cIn) : TypeNode(lIn, cIn) { }
-	void unparse(std::ostream& out, int indent);
+	IntNode(size_t lIn, size_t cIn) : TypeNode(NodeKind::INT_TYPE, lIn, cIn) { }
 	bool nameAnalysis(SymbolTable * symTab) { return true; }
 	std::string getTypeString() { return "int"; }
 };
 
 class BoolNode : public TypeNode{
 public:
-	BoolNode(size_t lIn, size_t cIn) : TypeNode(lIn, cIn) { }
-	void unparse(std::ostream& out, int indent);
+	BoolNode(size_t lIn, size_t cIn) : TypeNode(NodeKind::BOOL_TYPE, lIn, cIn) { }
 	bool nameAnalysis(SymbolTable * symTab) { return true; }
 	std::string getTypeString() { return "bool"; }
 };
 
 class VoidNode : public TypeNode{
 public:
-	VoidNode(size_t lIn, size_t cIn) : TypeNode(lIn, cIn){ }
-	void unparse(std::ostream& out, int indent) override;
+	VoidNode(size_t lIn, size_t cIn) : TypeNode(NodeKind::VOID_TYPE, lIn, cIn){ }
 	bool nameAnalysis(SymbolTable * symTab)
 		override { return true; }
 	std::string getTypeString() override { return "void"; }
@@ -368,17 +425,17 @@ public:
 class StructNode : public TypeNode{
 public:
 	StructNode(IdNode * id, size_t lIn, size_t cIn)
-	: TypeNode(lIn, cIn)
+	: TypeNode(NodeKind::STRUCT_TYPE, lIn, cIn)
 	{
 		if (id == nullptr){
 			throw std::runtime_error("null ID");
 		}
 		myId = id;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	bool nameAnalysis(SymbolTable * symTab) override;
 	std::string getTypeString() override;
 	virtual bool isPrimitive() override { return false; }
+	IdNode * getId() { return myId; }
 
 private:
 	IdNode * myId;
@@ -386,68 +443,91 @@ private:
 
 class IntLitNode : public ExpNode{
 public:
-	IntLitNode(IntLitToken * token)
-	: ExpNode(token->line, token->column){
-		myInt = token->value();
+	IntLitNode(TokenRef token)
+	: ExpNode(NodeKind::INT_LIT, token.line(), token.column()){
+		myInt = token.intValue();
+	}
+	IntLitNode(size_t lIn, size_t cIn, int value)
+	: ExpNode(NodeKind::INT_LIT, lIn, cIn){
+		myInt = value;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab) { return true; }
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	std::string getString() { return std::to_string(myInt); }
+	int getValue() { return myInt; }
+	bool constValue(int& value) override {
+		value = myInt;
+		return true;
+	}
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 private:
 	int myInt;
 };
 
 class StrLitNode : public ExpNode{
 public:
-	StrLitNode(StringLitToken * token)
-	: ExpNode(token->line, token->column){
-		myString = token->value();
+	StrLitNode(TokenRef token)
+	: ExpNode(NodeKind::STR_LIT, token.line(), token.column()){
+		myToken = token;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab) { return true; }
-	std::string expTypeAnalysis() override;
-	std::string getString() const { return myString; }
+	const LilC_Type * expTypeAnalysis() override;
+	std::string getString() const { return myToken.stringValue(); }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 private:
-	 std::string myString;
+	// the text stays in the source until codegen needs it
+	TokenRef myToken;
 };
 
 
 class TrueNode : public ExpNode{
 public:
-	TrueNode(size_t lIn, size_t cIn): ExpNode(lIn, cIn){ }
-	void unparse(std::ostream& out, int indent);
+	TrueNode(size_t lIn, size_t cIn): ExpNode(NodeKind::TRUE_LIT, lIn, cIn){ }
 	bool nameAnalysis(SymbolTable * symTab) { return true; }
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	std::string getString() const { return "true"; }
+	bool constValue(int& value) override {
+		value = 1;
+		return true;
+	}
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class FalseNode : public ExpNode{
 public:
-	FalseNode(size_t lIn, size_t cIn): ExpNode(lIn, cIn){ }
-	void unparse(std::ostream& out, int indent);
+	FalseNode(size_t lIn, size_t cIn): ExpNode(NodeKind::FALSE_LIT, lIn, cIn){ }
 	bool nameAnalysis(SymbolTable * symTab) { return true; }
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	std::string getString() const { return "false"; }
+	bool constValue(int& value) override {
+		value = 0;
+		return true;
+	}
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class DotAccessNode : public ExpNode{
 public:
 	DotAccessNode(ExpNode * exp, IdNode * id)
-	: ExpNode(id->getLine(), id->getCol()){
+	: ExpNode(NodeKind::DOT_ACCESS, id->getLine(), id->getCol()){
 		myExp = exp;
 		myId = id;
 	}
-	void unparse(std::ostream& out, int indent) override;
 	bool nameAnalysis(SymbolTable * symTab) override;
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	StructSymbol * dotNameAnalysis(SymbolTable * symTab)
 		override;
 	std::string getString();
+	ExpNode * getExp() { return myExp; }
+	IdNode * getId() { return myId; }
 
 private:
 	ExpNode * myExp;
@@ -459,14 +539,18 @@ public:
 	AssignNode(
 		size_t lIn, size_t cIn,
 		ExpNode * expLHS, ExpNode * expRHS)
-	: ExpNode(lIn, cIn){
+	: ExpNode(NodeKind::ASSIGN, lIn, cIn){
 		myExpLHS = expLHS;
 		myExpRHS = expRHS;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	bool hasSideEffects() override { return true; }
+	ExpNode * getLHS() { return myExpLHS; }
+	ExpNode * getRHS() { return myExpRHS; }
+	void setRHS(ExpNode * exp) { myExpRHS = exp; }
 
 private:
 	ExpNode * myExpLHS;
@@ -476,14 +560,17 @@ private:
 class CallExpNode : public ExpNode{
 public:
 	CallExpNode(IdNode * id, ExpListNode * expList)
-	: ExpNode(id->getLine(), id->getCol()){
+	: ExpNode(NodeKind::CALL_EXP, id->getLine(), id->getCol()){
 		myId = id;
 		myExpList = expList;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	bool hasSideEffects() override { return true; }
+	IdNode * getId() { return myId; }
+	ExpListNode * getExpList() { return myExpList; }
 
 private:
 	IdNode * myId;
@@ -493,15 +580,21 @@ private:
 
 class UnaryExpNode : public ExpNode {
 public:
-	UnaryExpNode(size_t lIn, size_t cIn, ExpNode * expIn)
-	: ExpNode(lIn, cIn){
+	UnaryExpNode(NodeKind kindIn, size_t lIn, size_t cIn,
+		ExpNode * expIn)
+	: ExpNode(kindIn, lIn, cIn){
 		this->myExp = expIn;
 	}
-	virtual void unparse(std::ostream& out, int indent) = 0;
 	virtual bool nameAnalysis(SymbolTable * symTab){
 		return myExp->nameAnalysis(symTab);
 	}
-	virtual std::string expTypeAnalysis() = 0;
+	virtual const LilC_Type * expTypeAnalysis() = 0;
+	int regNeed() override { return myExp->regNeed(); }
+	bool hasSideEffects() override {
+		return myExp->hasSideEffects();
+	}
+	ExpNode * getExp() { return myExp; }
+	void setExp(ExpNode * exp) { myExp = exp; }
 protected:
 	ExpNode * myExp;
 };
@@ -509,45 +602,96 @@ protected:
 class UnaryMinusNode : public UnaryExpNode{
 public:
 	UnaryMinusNode(ExpNode * exp)
-	: UnaryExpNode(line, col, exp){ }
-	void unparse(std::ostream& out, int indent);
-	std::string expTypeAnalysis() override;
+	: UnaryExpNode(NodeKind::UNARY_MINUS,
+		exp->getLine(), exp->getCol(), exp){ }
+	const LilC_Type * expTypeAnalysis() override;
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 };
 
 class NotNode : public UnaryExpNode{
 public:
 	NotNode(size_t lIn, size_t cIn, ExpNode * exp)
-	: UnaryExpNode(lIn, cIn, exp){ }
-	void unparse(std::ostream& out, int indent);
-	std::string expTypeAnalysis() override;
+	: UnaryExpNode(NodeKind::NOT, lIn, cIn, exp){ }
+	const LilC_Type * expTypeAnalysis() override;
+	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
+};
+
+// Multiplication by 2^bits, introduced by constant folding in
+// place of a TimesNode
+class ShiftLeftNode : public UnaryExpNode{
+public:
+	ShiftLeftNode(size_t lIn, size_t cIn, ExpNode * exp, int bitsIn)
+	: UnaryExpNode(NodeKind::SHIFT_LEFT, lIn, cIn, exp){
+		bits = bitsIn;
+	}
+	const LilC_Type * expTypeAnalysis() override {
+		return LilC_Type::intType();
+	}
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	int getBits() { return bits; }
+private:
+	int bits;
+};
+
+// Division by 2^bits, introduced by constant folding in place of
+// a DivideNode. Rounds toward zero like div does.
+class ShiftRightNode : public UnaryExpNode{
+public:
+	ShiftRightNode(size_t lIn, size_t cIn, ExpNode * exp, int bitsIn)
+	: UnaryExpNode(NodeKind::SHIFT_RIGHT, lIn, cIn, exp){
+		bits = bitsIn;
+	}
+	const LilC_Type * expTypeAnalysis() override {
+		return LilC_Type::intType();
+	}
+	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	int getBits() { return bits; }
+private:
+	int bits;
 };
 
 class BinaryExpNode : public ExpNode{
 public:
-	BinaryExpNode(
+	BinaryExpNode(NodeKind kindIn,
 		size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: ExpNode(lIn, cIn) {
+	: ExpNode(kindIn, lIn, cIn) {
 		this->myExp1 = exp1;
 		this->myExp2 = exp2;
 	}
-	virtual void unparse(std::ostream& out, int indent)
-		override;
 	virtual bool nameAnalysis(SymbolTable * symTab)
 		override
 	{
 		bool result1 = myExp1->nameAnalysis(symTab);
 		return myExp2->nameAnalysis(symTab) && result1;
 	}
-	std::string expTypeAnalysis() override;
+	const LilC_Type * expTypeAnalysis() override;
 	virtual BinOpKind binOpKind() = 0;
-	std::string expectedResType();
-	std::string reportOpErr(std::string);
-	bool acceptsOperandType(std::string opIn);
+	const LilC_Type * expectedResType();
+	const LilC_Type * reportOpErr(std::string);
+	bool acceptsOperandType(const LilC_Type * opIn);
 	virtual std::string myOp() = 0;
+	int regNeed() override;
+	bool hasSideEffects() override {
+		return myExp1->hasSideEffects()
+			|| myExp2->hasSideEffects();
+	}
+	ExpNode * getExp1() { return myExp1; }
+	ExpNode * getExp2() { return myExp2; }
+	void setExp1(ExpNode * exp) { myExp1 = exp; }
+	void setExp2(ExpNode * exp) { myExp2 = exp; }
 protected:
+	void genOperandsReg(LilC_Backend* backend,
+		int& reg1, int& reg2);
+	// Branch on comparing the operands with opcode op
+	void genCompareBranch(LilC_Backend* backend, MipsOp op,
+		MipsOperand label);
 	ExpNode * myExp1;
 	ExpNode * myExp2;
 };
@@ -556,140 +700,171 @@ class PlusNode : public BinaryExpNode{
 public:
 	PlusNode(size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lIn, cIn, exp1, exp2) { }
+	: BinaryExpNode(NodeKind::PLUS, lIn, cIn, exp1, exp2) { }
 	virtual std::string myOp(){ return "+"; }
 	BinOpKind binOpKind() override
 		{ return BinOpKind::MATH; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 };
 
 class MinusNode : public BinaryExpNode{
 public:
 	MinusNode(size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lIn, cIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::MINUS, lIn, cIn, exp1, exp2){ }
 	virtual std::string myOp(){ return "-"; }
 	BinOpKind binOpKind() override
 		{ return BinOpKind::MATH; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 };
 
 class TimesNode : public BinaryExpNode{
 public:
 	TimesNode(size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(line, col, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::TIMES, lIn, cIn, exp1, exp2){ }
 	virtual std::string myOp(){ return "*"; }
 	BinOpKind binOpKind() override
 		{ return BinOpKind::MATH; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 };
 
 class DivideNode : public BinaryExpNode{
 public:
 	DivideNode(size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(line, col, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::DIVIDE, lIn, cIn, exp1, exp2){ }
 	virtual std::string myOp(){ return "/"; }
 	BinOpKind binOpKind() override
 		{ return BinOpKind::MATH; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
 };
 
 class AndNode : public BinaryExpNode{
 public:
 	AndNode(size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lIn, cIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::AND, lIn, cIn, exp1, exp2){ }
 	virtual std::string myOp(){ return "&&"; }
 	BinOpKind binOpKind() override
 		{ return BinOpKind::LOG; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
+	int regNeed() override;
 };
 
 class OrNode : public BinaryExpNode{
 public:
 	OrNode(size_t lIn, size_t cIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lIn, cIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::OR, lIn, cIn, exp1, exp2){ }
 	virtual std::string myOp() override { return "||"; }
 	BinOpKind binOpKind() override
 		{ return BinOpKind::LOG; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
+	int regNeed() override;
 };
 
 class EqualsNode : public BinaryExpNode{
 public:
 	EqualsNode(size_t lineIn, size_t colIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::EQUALS, lineIn, colIn, exp1, exp2){ }
 	virtual std::string myOp(){ return "=="; }
 	BinOpKind binOpKind() override ;
-	std::string expTypeAnalysis();
+	const LilC_Type * expTypeAnalysis();
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class NotEqualsNode : public BinaryExpNode{
 public:
 	NotEqualsNode(size_t lineIn, size_t colIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::NOT_EQUALS, lineIn, colIn, exp1, exp2){ }
 	virtual std::string myOp() override { return "!="; }
 	BinOpKind binOpKind() override ;
-	std::string expTypeAnalysis();
+	const LilC_Type * expTypeAnalysis();
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class LessNode : public BinaryExpNode{
 public:
 	LessNode(size_t lineIn, size_t colIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::LESS, lineIn, colIn, exp1, exp2){ }
 	virtual std::string myOp() override { return "<"; }
 	virtual BinOpKind binOpKind(){ return BinOpKind::REL; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class GreaterNode : public BinaryExpNode{
 public:
 	GreaterNode(size_t lineIn, size_t colIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::GREATER, lineIn, colIn, exp1, exp2){ }
 	virtual std::string myOp() override { return ">"; }
 	virtual BinOpKind binOpKind(){ return BinOpKind::REL; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class LessEqNode : public BinaryExpNode{
 public:
 	LessEqNode(size_t lineIn, size_t colIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::LESS_EQ, lineIn, colIn, exp1, exp2){ }
 	virtual std::string myOp() override { return "<="; }
 	virtual BinOpKind binOpKind(){ return BinOpKind::REL; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class GreaterEqNode : public BinaryExpNode{
 public:
 	GreaterEqNode(size_t lineIn, size_t colIn,
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(line, col, exp1, exp2){ }
+	: BinaryExpNode(NodeKind::GREATER_EQ, lineIn, colIn, exp1, exp2){ }
 	virtual std::string myOp() override { return ">="; }
 	virtual BinOpKind binOpKind(){ return BinOpKind::REL; }
 	bool codeGen(LilC_Backend* backend) override;
+	int codeGenReg(LilC_Backend* backend) override;
+	void genBranch(LilC_Backend* backend, MipsOperand label,
+		bool jumpIf) override;
 };
 
 class AssignStmtNode : public StmtNode{
 public:
 	AssignStmtNode(AssignNode * assignment)
-	: StmtNode(assignment->getLine(), assignment->getCol()){
+	: StmtNode(NodeKind::ASSIGN_STMT,
+		assignment->getLine(), assignment->getCol()){
 		myAssign = assignment;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab) override;
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
+	AssignNode * getAssign() { return myAssign; }
 
 private:
 	AssignNode * myAssign;
@@ -698,16 +873,16 @@ private:
 class PostIncStmtNode : public StmtNode{
 public:
 	PostIncStmtNode(ExpNode * exp)
-	: StmtNode(exp->getLine(), exp->getCol()){
+	: StmtNode(NodeKind::POST_INC_STMT, exp->getLine(), exp->getCol()){
 		if (exp->getLine() == 0){
 			throw InternalError("0 pos");
 		}
 		myExp = exp;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
+	ExpNode * getExp() { return myExp; }
 
 private:
 	ExpNode * myExp;
@@ -716,13 +891,13 @@ private:
 class PostDecStmtNode : public StmtNode{
 public:
 	PostDecStmtNode(ExpNode * exp)
-	: StmtNode(exp->getLine(), exp->getCol()){
+	: StmtNode(NodeKind::POST_DEC_STMT, exp->getLine(), exp->getCol()){
 		myExp = exp;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
+	ExpNode * getExp() { return myExp; }
 
 private:
 	ExpNode * myExp;
@@ -731,13 +906,13 @@ private:
 class ReadStmtNode : public StmtNode{
 public:
 	ReadStmtNode(ExpNode * exp)
-	: StmtNode(exp->getLine(), exp->getCol()){
+	: StmtNode(NodeKind::READ_STMT, exp->getLine(), exp->getCol()){
 		myExp = exp;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
+	ExpNode * getExp() { return myExp; }
 private:
 	ExpNode * myExp;
 };
@@ -745,34 +920,40 @@ private:
 class WriteStmtNode : public StmtNode{
 public:
 	WriteStmtNode(ExpNode * exp)
-	: StmtNode(exp->getLine(), exp->getCol()){
+	: StmtNode(NodeKind::WRITE_STMT, exp->getLine(), exp->getCol()){
 		myExp = exp;
-		typeToWrite = "";
+		typeToWrite = nullptr;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	bool codeGen(LilC_Backend* backend) override;
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
+	ExpNode * getExp() { return myExp; }
+	void setExp(ExpNode * exp) { myExp = exp; }
+	// set by type analysis: int, bool or string
+	const LilC_Type * getTypeToWrite() { return typeToWrite; }
 private:
 	ExpNode * myExp;
-	std::string typeToWrite;
+	const LilC_Type * typeToWrite;
 };
 
 class IfStmtNode : public StmtNode{
 public:
 	IfStmtNode(size_t lineIn, size_t colIn, ExpNode * exp,
 	  DeclListNode * decls, StmtListNode * stmts)
-	: StmtNode(lineIn, colIn){
+	: StmtNode(NodeKind::IF_STMT, lineIn, colIn){
 		myExp = exp;
 		myDecls = decls;
 		myStmts = stmts;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab) {throw runtime_error("Not implemented: IfStmtNode");};
 	bool nameAnalysisWithOffset(SymbolTable * symTab, int offset) override;
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
-	bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel) override;
+	bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) override;
+	ExpNode * getExp() { return myExp; }
+	void setExp(ExpNode * exp) { myExp = exp; }
+	DeclListNode * getDeclList() { return myDecls; }
+	StmtListNode * getStmtList() { return myStmts; }
 
 private:
 	ExpNode * myExp;
@@ -785,19 +966,25 @@ public:
 	IfElseStmtNode(ExpNode * exp,
 	  DeclListNode * declsT, StmtListNode * stmtsT,
 	  DeclListNode * declsF, StmtListNode * stmtsF)
-	: StmtNode(exp->getLine(), exp->getCol()){
+	: StmtNode(NodeKind::IF_ELSE_STMT,
+		exp->getLine(), exp->getCol()){
 		myExp = exp;
 		myDeclsT = declsT;
 		myStmtsT = stmtsT;
 		myDeclsF = declsF;
 		myStmtsF = stmtsF;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab) {throw runtime_error("Not implemented: IfElseStmtNode");};
 	bool nameAnalysisWithOffset(SymbolTable * symTab, int offset) override;
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
-	bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel) override;
+	bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) override;
+	ExpNode * getExp() { return myExp; }
+	void setExp(ExpNode * exp) { myExp = exp; }
+	DeclListNode * getThenDeclList() { return myDeclsT; }
+	StmtListNode * getThenStmtList() { return myStmtsT; }
+	DeclListNode * getElseDeclList() { return myDeclsF; }
+	StmtListNode * getElseStmtList() { return myStmtsF; }
 
 private:
 	ExpNode * myExp;
@@ -811,17 +998,20 @@ class WhileStmtNode : public StmtNode{
 public:
 	WhileStmtNode(size_t lineIn, size_t colIn,
 	ExpNode * exp, DeclListNode * decls, StmtListNode * stmts)
-	: StmtNode(lineIn, colIn){
+	: StmtNode(NodeKind::WHILE_STMT, lineIn, colIn){
 		myExp = exp;
 		myDecls = decls;
 		myStmts = stmts;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab) {throw runtime_error("Not implemented: WhileStmtNode");};
 	bool nameAnalysisWithOffset(SymbolTable * symTab, int offset) override;
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
-	bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel) override;
+	bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) override;
+	ExpNode * getExp() { return myExp; }
+	void setExp(ExpNode * exp) { myExp = exp; }
+	DeclListNode * getDeclList() { return myDecls; }
+	StmtListNode * getStmtList() { return myStmts; }
 
 private:
 	ExpNode * myExp;
@@ -832,13 +1022,14 @@ private:
 class CallStmtNode : public StmtNode{
 public:
 	CallStmtNode(CallExpNode * callExp)
-	: StmtNode(callExp->getLine(), callExp->getCol()){
+	: StmtNode(NodeKind::CALL_STMT,
+		callExp->getLine(), callExp->getCol()){
 		myCallExp = callExp;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override;
+	CallExpNode * getCallExp() { return myCallExp; }
 
 private:
 	CallExpNode * myCallExp;
@@ -847,16 +1038,18 @@ private:
 class ReturnStmtNode : public StmtNode{
 public:
 	ReturnStmtNode(size_t lineIn, size_t colIn, ExpNode * exp)
-	: StmtNode(lineIn, colIn){
+	: StmtNode(NodeKind::RETURN_STMT, lineIn, colIn){
 		myExp = exp;
 	}
-	void unparse(std::ostream& out, int indent);
 	bool nameAnalysis(SymbolTable * symTab);
 	bool stmtTypeAnalysis(FuncSymbol * fnSym) override;
 	bool codeGen(LilC_Backend* backend) override {
 		throw runtime_error("Not implemented: ReturnStmtNode");
 	}
-	bool codeGenWithExit(LilC_Backend* backend, std::string exitLabel);
+	bool codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel);
+	// null for a bare return
+	ExpNode * getExp() { return myExp; }
+	void setExp(ExpNode * exp) { myExp = exp; }
 
 private:
 	ExpNode * myExp;
@@ -865,17 +1058,18 @@ private:
 class VarDeclNode : public DeclNode{
 public:
 	VarDeclNode(TypeNode * type, IdNode * id, int size)
-	: DeclNode(id->getLine(), id->getCol(), id){
+	: DeclNode(NodeKind::VAR_DECL, id->getLine(), id->getCol(), id){
 		myType = type;
 		mySize = size;
 	}
 	bool nameAnalysis(SymbolTable * symTab) override;
-	void unparse(std::ostream& out, int indent) override;
   bool globalCodeGen(LilC_Backend* backend) override;
 	virtual std::string getTypeString() override;
 	virtual DeclKind getKind() override { return DeclKind::VAR; }
 	static const int NOT_STRUCT = -1; //Use this value for mySize
 					  // if this is not a struct type
+	TypeNode * getTypeNode() { return myType; }
+	int getSize() { return mySize; }
 private:
 	TypeNode * myType;
 	int mySize;
@@ -0,0 +1,426 @@
+#ifndef LILC_AST_VISITOR_HPP
+#define LILC_AST_VISITOR_HPP
+
+#include "ast.hpp"
+
+namespace LILC{
+
+/* Compile-time visitor over the AST. A pass derives from
+  ASTVisitor<Pass, R> (the curiously recurring template pattern)
+  and defines visitX for the node kinds it handles. visit()
+  switches on the node's kind and calls the pass's method
+  directly, so there is no virtual call per node and the handlers
+  can be inlined into the dispatch.
+
+  A kind the pass leaves alone falls back to its category
+  (visitBinary and visitUnary, then visitExp, visitStmt, visitDecl
+  or visitType) and finally to visitNode, which does nothing.
+  ASTWalker instead makes visitNode walk the children, which is
+  the usual starting point for a pass that only looks at a few
+  kinds of node.
+*/
+template <typename Pass, typename R = void>
+class ASTVisitor{
+public:
+	R visit(ASTNode * node){
+		switch (node->getNodeKind()){
+		case NodeKind::PROGRAM:
+			return pass().visitProgram(static_cast<ProgramNode *>(node));
+		case NodeKind::DECL_LIST:
+			return pass().visitDeclList(static_cast<DeclListNode *>(node));
+		case NodeKind::FORMALS_LIST:
+			return pass().visitFormalsList(
+				static_cast<FormalsListNode *>(node));
+		case NodeKind::EXP_LIST:
+			return pass().visitExpList(static_cast<ExpListNode *>(node));
+		case NodeKind::STMT_LIST:
+			return pass().visitStmtList(static_cast<StmtListNode *>(node));
+		case NodeKind::FN_BODY:
+			return pass().visitFnBody(static_cast<FnBodyNode *>(node));
+		case NodeKind::VAR_DECL:
+			return pass().visitVarDecl(static_cast<VarDeclNode *>(node));
+		case NodeKind::FN_DECL:
+			return pass().visitFnDecl(static_cast<FnDeclNode *>(node));
+		case NodeKind::FORMAL_DECL:
+			return pass().visitFormalDecl(
+				static_cast<FormalDeclNode *>(node));
+		case NodeKind::STRUCT_DECL:
+			return pass().visitStructDecl(
+				static_cast<StructDeclNode *>(node));
+		case NodeKind::INT_TYPE:
+			return pass().visitIntType(static_cast<IntNode *>(node));
+		case NodeKind::BOOL_TYPE:
+			return pass().visitBoolType(static_cast<BoolNode *>(node));
+		case NodeKind::VOID_TYPE:
+			return pass().visitVoidType(static_cast<VoidNode *>(node));
+		case NodeKind::STRUCT_TYPE:
+			return pass().visitStructType(static_cast<StructNode *>(node));
+		case NodeKind::ID:
+			return pass().visitId(static_cast<IdNode *>(node));
+		case NodeKind::INT_LIT:
+			return pass().visitIntLit(static_cast<IntLitNode *>(node));
+		case NodeKind::STR_LIT:
+			return pass().visitStrLit(static_cast<StrLitNode *>(node));
+		case NodeKind::TRUE_LIT:
+			return pass().visitTrue(static_cast<TrueNode *>(node));
+		case NodeKind::FALSE_LIT:
+			return pass().visitFalse(static_cast<FalseNode *>(node));
+		case NodeKind::DOT_ACCESS:
+			return pass().visitDotAccess(static_cast<DotAccessNode *>(node));
+		case NodeKind::ASSIGN:
+			return pass().visitAssign(static_cast<AssignNode *>(node));
+		case NodeKind::CALL_EXP:
+			return pass().visitCallExp(static_cast<CallExpNode *>(node));
+		case NodeKind::UNARY_MINUS:
+			return pass().visitUnaryMinus(
+				static_cast<UnaryMinusNode *>(node));
+		case NodeKind::NOT:
+			return pass().visitNot(static_cast<NotNode *>(node));
+		case NodeKind::SHIFT_LEFT:
+			return pass().visitShiftLeft(static_cast<ShiftLeftNode *>(node));
+		case NodeKind::SHIFT_RIGHT:
+			return pass().visitShiftRight(
+				static_cast<ShiftRightNode *>(node));
+		case NodeKind::PLUS:
+			return pass().visitPlus(static_cast<PlusNode *>(node));
+		case NodeKind::MINUS:
+			return pass().visitMinus(static_cast<MinusNode *>(node));
+		case NodeKind::TIMES:
+			return pass().visitTimes(static_cast<TimesNode *>(node));
+		case NodeKind::DIVIDE:
+			return pass().visitDivide(static_cast<DivideNode *>(node));
+		case NodeKind::AND:
+			return pass().visitAnd(static_cast<AndNode *>(node));
+		case NodeKind::OR:
+			return pass().visitOr(static_cast<OrNode *>(node));
+		case NodeKind::EQUALS:
+			return pass().visitEquals(static_cast<EqualsNode *>(node));
+		case NodeKind::NOT_EQUALS:
+			return pass().visitNotEquals(static_cast<NotEqualsNode *>(node));
+		case NodeKind::LESS:
+			return pass().visitLess(static_cast<LessNode *>(node));
+		case NodeKind::GREATER:
+			return pass().visitGreater(static_cast<GreaterNode *>(node));
+		case NodeKind::LESS_EQ:
+			return pass().visitLessEq(static_cast<LessEqNode *>(node));
+		case NodeKind::GREATER_EQ:
+			return pass().visitGreaterEq(static_cast<GreaterEqNode *>(node));
+		case NodeKind::ASSIGN_STMT:
+			return pass().visitAssignStmt(
+				static_cast<AssignStmtNode *>(node));
+		case NodeKind::POST_INC_STMT:
+			return pass().visitPostIncStmt(
+				static_cast<PostIncStmtNode *>(node));
+		case NodeKind::POST_DEC_STMT:
+			return pass().visitPostDecStmt(
+				static_cast<PostDecStmtNode *>(node));
+		case NodeKind::READ_STMT:
+			return pass().visitReadStmt(static_cast<ReadStmtNode *>(node));
+		case NodeKind::WRITE_STMT:
+			return pass().visitWriteStmt(static_cast<WriteStmtNode *>(node));
+		case NodeKind::IF_STMT:
+			return pass().visitIfStmt(static_cast<IfStmtNode *>(node));
+		case NodeKind::IF_ELSE_STMT:
+			return pass().visitIfElseStmt(
+				static_cast<IfElseStmtNode *>(node));
+		case NodeKind::WHILE_STMT:
+			return pass().visitWhileStmt(static_cast<WhileStmtNode *>(node));
+		case NodeKind::CALL_STMT:
+			return pass().visitCallStmt(static_cast<CallStmtNode *>(node));
+		case NodeKind::RETURN_STMT:
+			return pass().visitReturnStmt(
+				static_cast<ReturnStmtNode *>(node));
+		default:
+			throw InternalError("visit: bad node kind");
+		}
+	}
+
+	// Visit each child of node, in source order. Results are
+	// dropped; a pass that combines them walks the children itself.
+	void visitChildren(ASTNode * node){
+		switch (node->getNodeKind()){
+		case NodeKind::PROGRAM:
+			visitIn(static_cast<ProgramNode *>(node)->getDeclList());
+			return;
+		case NodeKind::DECL_LIST:
+			for (DeclNode * decl :
+				static_cast<DeclListNode *>(node)->getDecls()){
+				visitIn(decl);
+			}
+			return;
+		case NodeKind::FORMALS_LIST:
+			for (FormalDeclNode * formal :
+				static_cast<FormalsListNode *>(node)->getFormals()){
+				visitIn(formal);
+			}
+			return;
+		case NodeKind::EXP_LIST:
+			for (ExpNode * exp :
+				*static_cast<ExpListNode *>(node)->getExps()){
+				visitIn(exp);
+			}
+			return;
+		case NodeKind::STMT_LIST:
+			for (StmtNode * stmt :
+				static_cast<StmtListNode *>(node)->getStmts()){
+				visitIn(stmt);
+			}
+			return;
+		case NodeKind::FN_BODY:
+			{
+			FnBodyNode * body = static_cast<FnBodyNode *>(node);
+			visitIn(body->getDeclList());
+			visitIn(body->getStmtList());
+			return;
+			}
+		case NodeKind::VAR_DECL:
+			{
+			VarDeclNode * decl = static_cast<VarDeclNode *>(node);
+			visitIn(decl->getTypeNode());
+			visitIn(decl->getDeclaredID());
+			return;
+			}
+		case NodeKind::FN_DECL:
+			{
+			FnDeclNode * decl = static_cast<FnDeclNode *>(node);
+			visitIn(decl->getRetType());
+			visitIn(decl->getDeclaredID());
+			visitIn(decl->getFormals());
+			visitIn(decl->getBody());
+			return;
+			}
+		case NodeKind::FORMAL_DECL:
+			{
+			FormalDeclNode * decl = static_cast<FormalDeclNode *>(node);
+			visitIn(decl->getTypeNode());
+			visitIn(decl->getDeclaredID());
+			return;
+			}
+		case NodeKind::STRUCT_DECL:
+			{
+			StructDeclNode * decl = static_cast<StructDeclNode *>(node);
+			visitIn(decl->getDeclaredID());
+			visitIn(decl->getDeclList());
+			return;
+			}
+		case NodeKind::STRUCT_TYPE:
+			visitIn(static_cast<StructNode *>(node)->getId());
+			return;
+		case NodeKind::DOT_ACCESS:
+			{
+			DotAccessNode * dot = static_cast<DotAccessNode *>(node);
+			visitIn(dot->getExp());
+			visitIn(dot->getId());
+			return;
+			}
+		case NodeKind::ASSIGN:
+			{
+			AssignNode * assign = static_cast<AssignNode *>(node);
+			visitIn(assign->getLHS());
+			visitIn(assign->getRHS());
+			return;
+			}
+		case NodeKind::CALL_EXP:
+			{
+			CallExpNode * call = static_cast<CallExpNode *>(node);
+			visitIn(call->getId());
+			visitIn(call->getExpList());
+			return;
+			}
+		case NodeKind::UNARY_MINUS:
+		case NodeKind::NOT:
+		case NodeKind::SHIFT_LEFT:
+		case NodeKind::SHIFT_RIGHT:
+			visitIn(static_cast<UnaryExpNode *>(node)->getExp());
+			return;
+		case NodeKind::PLUS:
+		case NodeKind::MINUS:
+		case NodeKind::TIMES:
+		case NodeKind::DIVIDE:
+		case NodeKind::AND:
+		case NodeKind::OR:
+		case NodeKind::EQUALS:
+		case NodeKind::NOT_EQUALS:
+		case NodeKind::LESS:
+		case NodeKind::GREATER:
+		case NodeKind::LESS_EQ:
+		case NodeKind::GREATER_EQ:
+			{
+			BinaryExpNode * bin = static_cast<BinaryExpNode *>(node);
+			visitIn(bin->getExp1());
+			visitIn(bin->getExp2());
+			return;
+			}
+		case NodeKind::ASSIGN_STMT:
+			visitIn(static_cast<AssignStmtNode *>(node)->getAssign());
+			return;
+		case NodeKind::POST_INC_STMT:
+			visitIn(static_cast<PostIncStmtNode *>(node)->getExp());
+			return;
+		case NodeKind::POST_DEC_STMT:
+			visitIn(static_cast<PostDecStmtNode *>(node)->getExp());
+			return;
+		case NodeKind::READ_STMT:
+			visitIn(static_cast<ReadStmtNode *>(node)->getExp());
+			return;
+		case NodeKind::WRITE_STMT:
+			visitIn(static_cast<WriteStmtNode *>(node)->getExp());
+			return;
+		case NodeKind::IF_STMT:
+			{
+			IfStmtNode * stmt = static_cast<IfStmtNode *>(node);
+			visitIn(stmt->getExp());
+			visitIn(stmt->getDeclList());
+			visitIn(stmt->getStmtList());
+			return;
+			}
+		case NodeKind::IF_ELSE_STMT:
+			{
+			IfElseStmtNode * stmt = static_cast<IfElseStmtNode *>(node);
+			visitIn(stmt->getExp());
+			visitIn(stmt->getThenDeclList());
+			visitIn(stmt->getThenStmtList());
+			visitIn(stmt->getElseDeclList());
+			visitIn(stmt->getElseStmtList());
+			return;
+			}
+		case NodeKind::WHILE_STMT:
+			{
+			WhileStmtNode * stmt = static_cast<WhileStmtNode *>(node);
+			visitIn(stmt->getExp());
+			visitIn(stmt->getDeclList());
+			visitIn(stmt->getStmtList());
+			return;
+			}
+		case NodeKind::CALL_STMT:
+			visitIn(static_cast<CallStmtNode *>(node)->getCallExp());
+			return;
+		case NodeKind::RETURN_STMT:
+			visitIn(static_cast<ReturnStmtNode *>(node)->getExp());
+			return;
+		case NodeKind::INT_TYPE:
+		case NodeKind::BOOL_TYPE:
+		case NodeKind::VOID_TYPE:
+		case NodeKind::ID:
+		case NodeKind::INT_LIT:
+		case NodeKind::STR_LIT:
+		case NodeKind::TRUE_LIT:
+		case NodeKind::FALSE_LIT:
+			return;
+		default:
+			throw InternalError("visitChildren: bad node kind");
+		}
+	}
+
+	// Catch-all and category fallbacks
+	R visitNode(ASTNode *){ return R(); }
+	R visitDecl(DeclNode * node){ return pass().visitNode(node); }
+	R visitType(TypeNode * node){ return pass().visitNode(node); }
+	R visitExp(ExpNode * node){ return pass().visitNode(node); }
+	R visitStmt(StmtNode * node){ return pass().visitNode(node); }
+	R visitUnary(UnaryExpNode * node){ return pass().visitExp(node); }
+	R visitBinary(BinaryExpNode * node){ return pass().visitExp(node); }
+
+	R visitProgram(ProgramNode * node){ return pass().visitNode(node); }
+	R visitDeclList(DeclListNode * node){ return pass().visitNode(node); }
+	R visitFormalsList(FormalsListNode * node){
+		return pass().visitNode(node);
+	}
+	R visitExpList(ExpListNode * node){ return pass().visitNode(node); }
+	R visitStmtList(StmtListNode * node){ return pass().visitNode(node); }
+	R visitFnBody(FnBodyNode * node){ return pass().visitNode(node); }
+
+	R visitVarDecl(VarDeclNode * node){ return pass().visitDecl(node); }
+	R visitFnDecl(FnDeclNode * node){ return pass().visitDecl(node); }
+	R visitFormalDecl(FormalDeclNode * node){
+		return pass().visitDecl(node);
+	}
+	R visitStructDecl(StructDeclNode * node){
+		return pass().visitDecl(node);
+	}
+
+	R visitIntType(IntNode * node){ return pass().visitType(node); }
+	R visitBoolType(BoolNode * node){ return pass().visitType(node); }
+	R visitVoidType(VoidNode * node){ return pass().visitType(node); }
+	R visitStructType(StructNode * node){ return pass().visitType(node); }
+
+	R visitId(IdNode * node){ return pass().visitExp(node); }
+	R visitIntLit(IntLitNode * node){ return pass().visitExp(node); }
+	R visitStrLit(StrLitNode * node){ return pass().visitExp(node); }
+	R visitTrue(TrueNode * node){ return pass().visitExp(node); }
+	R visitFalse(FalseNode * node){ return pass().visitExp(node); }
+	R visitDotAccess(DotAccessNode * node){ return pass().visitExp(node); }
+	R visitAssign(AssignNode * node){ return pass().visitExp(node); }
+	R visitCallExp(CallExpNode * node){ return pass().visitExp(node); }
+
+	R visitUnaryMinus(UnaryMinusNode * node){
+		return pass().visitUnary(node);
+	}
+	R visitNot(NotNode * node){ return pass().visitUnary(node); }
+	R visitShiftLeft(ShiftLeftNode * node){
+		return pass().visitUnary(node);
+	}
+	R visitShiftRight(ShiftRightNode * node){
+		return pass().visitUnary(node);
+	}
+
+	R visitPlus(PlusNode * node){ return pass().visitBinary(node); }
+	R visitMinus(MinusNode * node){ return pass().visitBinary(node); }
+	R visitTimes(TimesNode * node){ return pass().visitBinary(node); }
+	R visitDivide(DivideNode * node){ return pass().visitBinary(node); }
+	R visitAnd(AndNode * node){ return pass().visitBinary(node); }
+	R visitOr(OrNode * node){ return pass().visitBinary(node); }
+	R visitEquals(EqualsNode * node){ return pass().visitBinary(node); }
+	R visitNotEquals(NotEqualsNode * node){
+		return pass().visitBinary(node);
+	}
+	R visitLess(LessNode * node){ return pass().visitBinary(node); }
+	R visitGreater(GreaterNode * node){ return pass().visitBinary(node); }
+	R visitLessEq(LessEqNode * node){ return pass().visitBinary(node); }
+	R visitGreaterEq(GreaterEqNode * node){
+		return pass().visitBinary(node);
+	}
+
+	R visitAssignStmt(AssignStmtNode * node){
+		return pass().visitStmt(node);
+	}
+	R visitPostIncStmt(PostIncStmtNode * node){
+		return pass().visitStmt(node);
+	}
+	R visitPostDecStmt(PostDecStmtNode * node){
+		return pass().visitStmt(node);
+	}
+	R visitReadStmt(ReadStmtNode * node){ return pass().visitStmt(node); }
+	R visitWriteStmt(WriteStmtNode * node){ return pass().visitStmt(node); }
+	R visitIfStmt(IfStmtNode * node){ return pass().visitStmt(node); }
+	R visitIfElseStmt(IfElseStmtNode * node){
+		return pass().visitStmt(node);
+	}
+	R visitWhileStmt(WhileStmtNode * node){ return pass().visitStmt(node); }
+	R visitCallStmt(CallStmtNode * node){ return pass().visitStmt(node); }
+	R visitReturnStmt(ReturnStmtNode * node){
+		return pass().visitStmt(node);
+	}
+
+protected:
+	Pass& pass(){ return static_cast<Pass&>(*this); }
+
+private:
+	void visitIn(ASTNode * child){
+		if (child != nullptr){ pass().visit(child); }
+	}
+};
+
+/* A visitor whose default is to walk into every child, for
+  passes that only act on a few kinds of node. An overriding
+  visitX that still wants the subtree calls visitChildren.
+*/
+template <typename Pass>
+class ASTWalker : public ASTVisitor<Pass, void>{
+public:
+	void visitNode(ASTNode * node){ this->visitChildren(node); }
+};
+
+} //End namespace LILC
+
+#endif
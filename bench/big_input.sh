@@ -0,0 +1,15 @@
+#!/bin/sh
+# Write the large generated program the compile-time and memory
+# numbers in the history were measured on (about 1.8MB with the
+# default 20000 functions) to stdout.
+#   bench/big_input.sh [functions] > big.lilc
+#   lilcc --time-passes --mem-stats -O2 -S /dev/null big.lilc
+FUNCS=${1:-20000}
+
+awk -v n="$FUNCS" 'BEGIN {
+	for (i = 0; i < n; i++) {
+		printf "int f%d(int a, int b){ int c; c = a + b * %d;", i, i
+		printf " cout << \"value of f%d\"; return c; }\n", i
+	}
+	print "void main(){ int x; x = f1(1,2); cout << x; }"
+}'
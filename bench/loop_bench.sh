@@ -0,0 +1,119 @@
+#!/bin/sh
+# Run loops under lilcsim at each optimization level and report
+# what they cost: two counter loops stepped with ++ and --, and a
+# loop whose body uses every kind of statement. A loop that grows
+# the stack each iteration (a statement leaving a value pushed)
+# shows up as a max stack that scales with the iterations; the
+# script fails if any run goes over STACK_LIMIT bytes.
+#   bench/loop_bench.sh [lilcc] [lilcsim] [iterations] [baseline lilcc]
+# With a baseline compiler, its counts are shown alongside.
+LILCC=${1:-./lilcc}
+SIM=${2:-./lilcsim}
+ITERS=${3:-1000000}
+BASE=$4
+STACK_LIMIT=${STACK_LIMIT:-4096}
+DIR=$(mktemp -d /tmp/lilc_loop_bench.XXXXXX)
+trap 'rm -rf "$DIR"' EXIT
+
+cat > "$DIR/counters.lilc" <<EOF
+int hits;
+int down;
+
+void main() {
+	int i;
+	int j;
+	i = 0;
+	while (i < $ITERS) {
+		hits++;
+		i++;
+	}
+	j = $ITERS;
+	while (j > 0) {
+		down--;
+		j--;
+	}
+	cout << hits;
+	cout << " ";
+	cout << down;
+	cout << "\n";
+}
+EOF
+
+cat > "$DIR/stmts.lilc" <<EOF
+int total;
+
+void bump(int by) {
+	total = total + by;
+}
+
+int pick(int a, int b) {
+	if (a < b) {
+		return a;
+	}
+	return b;
+}
+
+void main() {
+	int i;
+	int k;
+	i = 0;
+	while (i < $ITERS) {
+		if (i == -1) {
+			int never;
+			never = i;
+			cout << never;
+		}
+		if (i / 2 * 2 == i && i >= 0) {
+			int even;
+			even = pick(i, 3);
+			total = total + even;
+		} else {
+			int odd;
+			int twice;
+			odd = i;
+			twice = odd + odd;
+			total = total - twice / 2;
+		}
+		k = 0;
+		while (k < 2 || !true) {
+			k++;
+		}
+		bump(k);
+		total--;
+		i++;
+	}
+	cout << total;
+	cout << "\n";
+}
+EOF
+
+# instructions and max stack of one build, as "count stack"
+measure() {
+	"$1" "$2" "$DIR/$3.lilc" "$DIR/$3.s" || exit 1
+	"$SIM" --stats --max-steps 4000000000 "$DIR/$3.s" 2>&1 >/dev/null \
+		| awk '$1 == "instructions:" { n = $2 }
+			$1 == "max" { s = $3 }
+			END { print n, s }'
+}
+
+status=0
+for prog in counters stmts; do
+	echo "$prog: $ITERS iterations"
+	for level in -O0 -O1 -O2; do
+		set -- $(measure "$LILCC" $level $prog)
+		if [ "$2" -gt "$STACK_LIMIT" ]; then
+			echo "$prog $level: stack grew to $2 bytes" >&2
+			status=1
+		fi
+		line=$(printf "  %-4s %12s instructions %8s bytes of stack" \
+			$level "$1" "$2")
+		if [ -n "$BASE" ]; then
+			new=$1
+			set -- $(measure "$BASE" $level $prog)
+			line="$line   (baseline $1 / $2 bytes, $(awk -v a="$1" -v b="$new" \
+				'BEGIN { printf "%.2fx", a / b }'))"
+		fi
+		echo "$line"
+	done
+done
+exit $status
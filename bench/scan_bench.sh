@@ -0,0 +1,40 @@
+#!/bin/sh
+# Compare the flex scanner with the hand-written one (-fdfa-scanner)
+# on a large generated Lil'C file.
+#   bench/scan_bench.sh [lilcc] [functions] [runs]
+LILCC=${1:-./lilcc}
+FUNCS=${2:-50000}
+RUNS=${3:-5}
+INPUT=$(mktemp /tmp/lilc_scan_bench.XXXXXX)
+trap 'rm -f "$INPUT"' EXIT
+
+awk -v n="$FUNCS" 'BEGIN {
+	print "struct Point { int x; int y; };"
+	for (i = 0; i < n; i++) {
+		printf "int fn%d(int a, bool b) {\n", i
+		printf "\tint c; // locals\n"
+		printf "\tc = a * %d + (a - 7) / 3;\n", i
+		printf "\tif (b && c >= 10 || !b) { c++; } else { c--; }\n"
+		printf "\twhile (c != 0) { c = c - 1; }\n"
+		printf "\tcout << \"fn%d says \\\"hi\\\"\\n\";\n", i
+		printf "\treturn c;\n}\n"
+	}
+	print "void main() { int r; r = fn0(1, true); cout << r; }"
+}' > "$INPUT"
+echo "input: $(wc -c < "$INPUT") bytes, $FUNCS functions"
+
+for scanner in flex dfa; do
+	flag=""
+	[ "$scanner" = dfa ] && flag="-fdfa-scanner"
+	best=""
+	i=0
+	while [ $i -lt "$RUNS" ]; do
+		ms=$("$LILCC" $flag --time-passes --tokens=/dev/null "$INPUT" 2>&1 \
+			| awk '$1 == "scan" { print $2 }')
+		if [ -z "$best" ] || awk -v a="$ms" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+			best=$ms
+		fi
+		i=$((i + 1))
+	done
+	printf "%-5s scan: %10s ms (best of %d)\n" "$scanner" "$best" "$RUNS"
+done
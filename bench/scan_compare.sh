@@ -0,0 +1,33 @@
+#!/bin/sh
+# Check that the flex scanner and the hand-written one
+# (-fdfa-scanner) agree: same tokens, same unparsed program,
+# same code and the same diagnostics, whose positions come from
+# the tokens.
+#   bench/scan_compare.sh [lilcc] <file.lilc>...
+LILCC=${1:-./lilcc}
+shift
+DIR=$(mktemp -d /tmp/lilc_scan_compare.XXXXXX)
+trap 'rm -rf "$DIR"' EXIT
+
+status=0
+for file in "$@"; do
+	for scanner in flex dfa; do
+		flag=""
+		[ "$scanner" = dfa ] && flag="-fdfa-scanner"
+		"$LILCC" $flag --tokens="$DIR/$scanner.tokens" \
+			--unparse="$DIR/$scanner.unparse" -S "$DIR/$scanner.s" \
+			"$file" > "$DIR/$scanner.out" 2>&1
+		echo "exit $?" >> "$DIR/$scanner.out"
+	done
+	same=yes
+	for kind in tokens unparse s out; do
+		if ! cmp -s "$DIR/flex.$kind" "$DIR/dfa.$kind"; then
+			echo "$file: $kind differ"
+			diff "$DIR/flex.$kind" "$DIR/dfa.$kind" | head -10
+			same=no
+			status=1
+		fi
+	done
+	[ $same = yes ] && echo "$file: same"
+done
+exit $status
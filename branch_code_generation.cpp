@@ -0,0 +1,147 @@
+#include "err.hpp"
+#include "ast.hpp"
+#include "symbol_table.hpp"
+
+// Jumping code (-fcond-branch): conditions of if and while
+// statements compile straight to conditional branches instead of
+// materializing a 0/1 value and testing it. Works with both the
+// stack and the register-allocating code generators.
+
+namespace LILC{
+
+void ExpNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	int reg = genValue(backend, LilC_Backend::T0);
+	backend->generateBranch(jumpIf ? MipsOp::BNE : MipsOp::BEQ, reg,
+		LilC_Backend::ZERO, label);
+	backend->freeReg(reg);
+}
+
+void TrueNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	if (jumpIf) { backend->generateJump(MipsOp::J, label); }
+}
+
+void FalseNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	if (!jumpIf) { backend->generateJump(MipsOp::J, label); }
+}
+
+void NotNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	myExp->genBranch(backend, label, !jumpIf);
+}
+
+void AndNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	if (!jumpIf) {
+		myExp1->genBranch(backend, label, false);
+		myExp2->genBranch(backend, label, false);
+		return;
+	}
+	MipsOperand skip = backend->nextLabel();
+	myExp1->genBranch(backend, skip, false);
+	myExp2->genBranch(backend, label, true);
+	backend->genLabel(skip);
+}
+
+void OrNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	if (jumpIf) {
+		myExp1->genBranch(backend, label, true);
+		myExp2->genBranch(backend, label, true);
+		return;
+	}
+	MipsOperand skip = backend->nextLabel();
+	myExp1->genBranch(backend, skip, true);
+	myExp2->genBranch(backend, label, false);
+	backend->genLabel(skip);
+}
+
+void BinaryExpNode::genCompareBranch(
+	LilC_Backend* backend,
+	MipsOp op,
+	MipsOperand label
+){
+	if (!backend->allocRegs()) {
+		myExp1->codeGen(backend);
+		myExp2->codeGen(backend);
+		backend->genPop(LilC_Backend::T1);
+		backend->genPop(LilC_Backend::T0);
+		backend->generateBranch(op, LilC_Backend::T0, LilC_Backend::T1, label);
+		return;
+	}
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generateBranch(op, reg1, reg2, label);
+	backend->freeReg(reg1);
+	backend->freeReg(reg2);
+}
+
+void EqualsNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	genCompareBranch(backend, jumpIf ? MipsOp::BEQ : MipsOp::BNE, label);
+}
+
+void NotEqualsNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	genCompareBranch(backend, jumpIf ? MipsOp::BNE : MipsOp::BEQ, label);
+}
+
+void LessNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	genCompareBranch(backend, jumpIf ? MipsOp::BLT : MipsOp::BGE, label);
+}
+
+void GreaterNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	genCompareBranch(backend, jumpIf ? MipsOp::BGT : MipsOp::BLE, label);
+}
+
+void LessEqNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	genCompareBranch(backend, jumpIf ? MipsOp::BLE : MipsOp::BGT, label);
+}
+
+void GreaterEqNode::genBranch(
+	LilC_Backend* backend,
+	MipsOperand label,
+	bool jumpIf
+){
+	genCompareBranch(backend, jumpIf ? MipsOp::BGE : MipsOp::BLT, label);
+}
+
+} // End namespace LILC
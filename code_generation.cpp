@@ -3,21 +3,82 @@
 #include "symbol_table.hpp"
 #include "lilc_compiler.hpp"
 #include <fstream>
+#include <iostream>
 
 namespace LILC{
 
-bool LilC_Compiler::codeGen(
-	const char * const inFile,
-	const char * const outFile
-){
-	if (!this->typeAnalysis(inFile)){ return false; }
+bool LilC_Compiler::codeGen(const char * const outFile){
+	if (!this->typeAnalysis()){ return false; }
+	LilC_PassStats::Sample start = LilC_PassStats::sample();
+	if (options.constFold){
+		this->astRoot->constFold(arena);
+		if (stats.enabled()){ stats.record("constant folding", start); }
+	}
+	if (options.deadCode){
+		start = LilC_PassStats::sample();
+		this->astRoot->removeDeadCode();
+		if (stats.enabled()){ stats.record("dead code", start); }
+	}
 	std::ofstream out(outFile);
-	LilC_Backend* backend = new LilC_Backend(out);
-	bool valid = this->astRoot->codeGen(backend);
+	LilC_Backend backend(out, options);
+	bool valid = true;
+	start = LilC_PassStats::sample();
+	if (options.ir) {
+		IRModule module;
+		this->astRoot->lower(module);
+		if (options.inlineCalls) {
+			IRInliner(options.inlineLimit).run(module);
+		}
+		if (options.tailCalls) {
+			IRTailCalls().run(module);
+		}
+		if (options.deadCode) {
+			for (IRFunction * fn : module.functions) {
+				fn->removeUnreachable();
+			}
+		}
+		if (options.cse) {
+			IRValueNumbering().run(module);
+		}
+		if (options.loopOpt) {
+			IRLoopOpt().run(module);
+		}
+		if (options.dumpIR) {
+			module.print(std::cerr);
+		}
+		IRCodeGen(&backend).genModule(module);
+	} else {
+		valid = this->astRoot->codeGen(&backend);
+	}
+	if (stats.enabled()){ stats.record("code generation", start); }
+	start = LilC_PassStats::sample();
+	backend.flush();
 	out.close();
+	if (stats.enabled()){ stats.record("output", start); }
 	return valid;
 }
 
+int ExpNode::genValue(LilC_Backend* backend, int dest){
+	if (backend->allocRegs()) {
+		return codeGenReg(backend);
+	}
+	codeGen(backend);
+	backend->genPop(dest);
+	return dest;
+}
+
+// Branch to label unless cond evaluates to true
+static void genSkipUnless(LilC_Backend* backend, ExpNode * cond, MipsOperand label){
+	if (backend->options().condBranch) {
+		cond->genBranch(backend, label, false);
+		return;
+	}
+	int reg = cond->genValue(backend, LilC_Backend::T0);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T1, LilC_Backend::TRUE);
+	backend->generateBranch(MipsOp::BNE, reg, LilC_Backend::T1, label);
+	backend->freeReg(reg);
+}
+
 bool ASTNode::codeGen(LilC_Backend* backend){
 	throw LILC::InternalError(
 		__FILE__ ": "
@@ -47,39 +108,10 @@ bool VarDeclNode::globalCodeGen(LilC_Backend* backend){
 }
 
 bool FnDeclNode::globalCodeGen(LilC_Backend* backend){
-	std::string entrance = "_" + getName();
-	std::string exit = "_" + getName() + "_Exit";
-
-	if (getName() == "main") {
-		backend->generate(".text");
-		backend->generate(".globl main");
-		backend->genLabel(getName(), "Method entry");
-		backend->genLabel("_start", "add __start for main only");
-	} else {
-		backend->generate(".text");
-		backend->genLabel(entrance, getName() + " function entry");
-	}
-
-	backend->genPush(LilC_Backend::RA);
-	backend->genPush(LilC_Backend::FP);
-	backend->generate("addu", LilC_Backend::FP, LilC_Backend::SP, std::to_string(myFormals->offsetSize() + 8));
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myBody->getLocalsSize()));
-
+	MipsOperand exit = backend->fnExitLabel(getName());
+	backend->genFnEntry(getName(), myFormals->offsetSize(), myBody->getLocalsSize());
 	myBody->codeGenWithExit(backend, exit);
-
-	backend->generateWithComment("","#FUNCTION EXIT");
-	backend->genLabel(exit);
-	backend->generateIndexed("lw", LilC_Backend::RA, LilC_Backend::FP, myFormals->offsetSize() * -1, "load return address");
-	backend->generateWithComment("move", "save control link", LilC_Backend::T0, LilC_Backend::FP);
-	backend->generateIndexed("lw", LilC_Backend::FP, LilC_Backend::FP, (myFormals->offsetSize() + 4) * -1, "restore FP");
-	backend->generateWithComment("move", "restore SP", LilC_Backend::SP, LilC_Backend::T0);
-
-	if (getName() == "main") {
-		backend->generateWithComment("li", "load exit code for syscall", LilC_Backend::V0, "10");
-		backend->generateWithComment("syscall", "only do this for main", "", "");
-	} else {
-		backend->generateWithComment("jr", "return", LilC_Backend::RA, "");
-	}
+	backend->genFnExit(getName(), myFormals->offsetSize());
 	return true;
 }
 
@@ -95,35 +127,41 @@ bool FnBodyNode::codeGen(LilC_Backend* backend) {
 	throw runtime_error("Not implement: FnBodyNode");
 }
 
-bool FnBodyNode::codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
+bool FnBodyNode::codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
 	return myStmtList->codeGenWithExit(backend, exitLabel);
 }
 
+// Every statement must leave SP where it found it
 bool StmtListNode::codeGen(LilC_Backend* backend) {
 	bool valid = true;
 	for (StmtNode* stmt : *myStmts) {
+		int depth = backend->getStackDepth();
 		valid = stmt->codeGen(backend) && valid;
+		backend->checkStackDepth(depth, "Statement at " + stmt->getPosition());
 	}
 	return valid;
 }
 
-bool StmtListNode::codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
+bool StmtListNode::codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
 	bool valid = true;
 	for (StmtNode* stmt : *myStmts) {
+		int depth = backend->getStackDepth();
 		valid = stmt->codeGenWithExit(backend, exitLabel) && valid;
+		backend->checkStackDepth(depth, "Statement at " + stmt->getPosition());
 	}
 	return valid;
 }
 
 bool StrLitNode::codeGen(LilC_Backend* backend) {
-	backend->genStringLit(myString);
+	backend->genStringLit(getString());
 	return true;
 }
 
 bool WriteStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " WRITE");
-	myExp->codeGen(backend);
-	backend->genWrite(typeToWrite);
+	backend->genComment(" WRITE");
+	int reg = myExp->genValue(backend, LilC_Backend::A0);
+	backend->genWrite(typeToWrite == LilC_Type::stringType(), reg);
+	backend->freeReg(reg);
 	return true;
 }
 
@@ -153,19 +191,17 @@ bool IdNode::codeGen(LilC_Backend* backend) {
 }
 
 bool IdNode::genJumpAndLink(LilC_Backend* backend) {
-	std::string label = myStrVal == "main" ? myStrVal : "_" + myStrVal;
-	backend->generate("jal", label);
+	backend->generateJump(MipsOp::JAL, backend->fnLabel(myStrVal));
 	return true;
 }
 
 bool AssignStmtNode::codeGen(LilC_Backend* backend) {
-	myAssign->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
+	backend->freeReg(myAssign->genValue(backend, LilC_Backend::T0));
 	return true;
 }
 
 bool AssignNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " Assign");
+	backend->genComment(" Assign");
 	myExpRHS->codeGen(backend);
 	myExpLHS->genAddr(backend);
 	backend->genAssign();
@@ -184,30 +220,46 @@ bool NotNode::codeGen(LilC_Backend* backend) {
 	return true;
 }
 
+bool ShiftLeftNode::codeGen(LilC_Backend* backend) {
+	myExp->codeGen(backend);
+	backend->genPop(LilC_Backend::T0);
+	backend->generateImm(MipsOp::SLL, LilC_Backend::T0, LilC_Backend::T0, bits);
+	backend->genPush(LilC_Backend::T0);
+	return true;
+}
+
+bool ShiftRightNode::codeGen(LilC_Backend* backend) {
+	myExp->codeGen(backend);
+	backend->genPop(LilC_Backend::T0);
+	backend->genDivPow2(LilC_Backend::T0, LilC_Backend::T1, bits);
+	backend->genPush(LilC_Backend::T0);
+	return true;
+}
+
 bool PlusNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " PLUS");
+	backend->genComment(" PLUS");
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("add", LilC_Backend::T0, LilC_Backend::T0, LilC_Backend::T1);
+	backend->generate(MipsOp::ADD, LilC_Backend::T0, LilC_Backend::T0, LilC_Backend::T1);
 	backend->genPush(LilC_Backend::T0);
 	return true;
 }
 
 bool MinusNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " MINUS");
+	backend->genComment(" MINUS");
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("sub", LilC_Backend::T0, LilC_Backend::T0, LilC_Backend::T1);
+	backend->generate(MipsOp::SUB, LilC_Backend::T0, LilC_Backend::T0, LilC_Backend::T1);
 	backend->genPush(LilC_Backend::T0);
 	return true;
 }
 
 bool TimesNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " TIMES");
+	backend->genComment(" TIMES");
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
@@ -218,7 +270,7 @@ bool TimesNode::codeGen(LilC_Backend* backend) {
 }
 
 bool DivideNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " DIVIDE");
+	backend->genComment(" DIVIDE");
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
@@ -229,309 +281,336 @@ bool DivideNode::codeGen(LilC_Backend* backend) {
 }
 
 bool AndNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " AND");
-	std::string pushFalse = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" AND");
+	MipsOperand pushFalse = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::TRUE, pushFalse);
+	int depth = backend->getStackDepth();
+	backend->generateBranchImm(MipsOp::BNE, LilC_Backend::T0, LilC_Backend::TRUE, pushFalse);
 	myExp2->codeGen(backend);
-	backend->generateWithComment("b", "Exit and exp", exit, "");
+	backend->generateJump(MipsOp::B, exit, "Exit and exp");
 	backend->genLabel(pushFalse, "return false");
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, "Exit And expression");
 	return true;
 }
 
 bool OrNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " OR");
-	std::string pushTrue= backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" OR");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::FALSE, pushTrue);
+	int depth = backend->getStackDepth();
+	backend->generateBranchImm(MipsOp::BNE, LilC_Backend::T0, LilC_Backend::FALSE, pushTrue);
 	myExp2->codeGen(backend);
-	backend->generateWithComment("b", "Exit or exp", exit, "");
+	backend->generateJump(MipsOp::B, exit, "Exit or exp");
 	backend->genLabel(pushTrue, "return true");
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, "Exit or expression");
 	return true;
 }
 
 bool EqualsNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " EQUALS");
-	std::string pushTrue = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" EQUALS");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("beq", LilC_Backend::T0, LilC_Backend::T1, pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	int depth = backend->getStackDepth();
+	backend->generateBranch(MipsOp::BEQ, LilC_Backend::T0, LilC_Backend::T1, pushTrue);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
-	backend->generate("j", exit);
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, " exit equals exp");
 	return true;
 }
 
 bool NotEqualsNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " NOT EQUALS");
-	std::string pushTrue = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" NOT EQUALS");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	int depth = backend->getStackDepth();
+	backend->generateBranch(MipsOp::BNE, LilC_Backend::T0, LilC_Backend::T1, pushTrue);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
-	backend->generate("j", exit);
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, " exit not equals exp");
 	return true;
 }
 
 bool LessNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " LESS THAN");
-	std::string pushTrue = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" LESS THAN");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("blt", LilC_Backend::T0, LilC_Backend::T1, pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	int depth = backend->getStackDepth();
+	backend->generateBranch(MipsOp::BLT, LilC_Backend::T0, LilC_Backend::T1, pushTrue);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
-	backend->generate("j", exit);
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, " exit less than exp");
 	return true;
 }
 
 bool GreaterNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " GREATER THAN");
-	std::string pushTrue = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" GREATER THAN");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("bgt", LilC_Backend::T0, LilC_Backend::T1, pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	int depth = backend->getStackDepth();
+	backend->generateBranch(MipsOp::BGT, LilC_Backend::T0, LilC_Backend::T1, pushTrue);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
-	backend->generate("j", exit);
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, " exit greater than exp");
 	return true;
 }
 
 bool LessEqNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " LESS THAN OR EQUAL");
-	std::string pushTrue = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" LESS THAN OR EQUAL");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("ble", LilC_Backend::T0, LilC_Backend::T1, pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	int depth = backend->getStackDepth();
+	backend->generateBranch(MipsOp::BLE, LilC_Backend::T0, LilC_Backend::T1, pushTrue);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
-	backend->generate("j", exit);
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, " exit greater than exp");
 	return true;
 }
 
 bool GreaterEqNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " GREATER THAN OR EQUAL");
-	std::string pushTrue = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" GREATER THAN OR EQUAL");
+	MipsOperand pushTrue = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	myExp1->codeGen(backend);
 	myExp2->codeGen(backend);
 	backend->genPop(LilC_Backend::T1);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("bge", LilC_Backend::T0, LilC_Backend::T1, pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::FALSE);
+	int depth = backend->getStackDepth();
+	backend->generateBranch(MipsOp::BGE, LilC_Backend::T0, LilC_Backend::T1, pushTrue);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::FALSE);
 	backend->genPush(LilC_Backend::T0);
-	backend->generate("j", exit);
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(pushTrue);
-	backend->generate("li", LilC_Backend::T0, LilC_Backend::TRUE);
+	backend->setStackDepth(depth);
+	backend->generateImm(MipsOp::LI, LilC_Backend::T0, LilC_Backend::TRUE);
 	backend->genPush(LilC_Backend::T0);
 	backend->genLabel(exit, " exit greater than exp");
 	return true;
 }
 
-bool PostIncStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " POSTINC");
-	myExp->codeGen(backend);
+/*
+* x++ and x-- on a variable load it, add to it and store it back
+* in one register; at -O0 that is T0, which nothing else is
+* holding between statements. Any other lvalue goes the way an
+* assignment to it would.
+*/
+static void genIncrement(LilC_Backend* backend, ExpNode * exp, int delta) {
+	if (exp->getNodeKind() == NodeKind::ID) {
+		IdNode * id = static_cast<IdNode *>(exp);
+		SymbolTableEntry * sym = id->getSymbol();
+		int reg = backend->allocRegs()
+			? backend->allocReg() : LilC_Backend::T0;
+		backend->genLoad(reg, id->getString(), sym->isGlobal(), sym->getOffset());
+		backend->generateImm(MipsOp::ADDIU, reg, reg, delta);
+		backend->genStore(reg, id->getString(), sym->isGlobal(), sym->getOffset());
+		backend->freeReg(reg);
+		return;
+	}
+	if (backend->allocRegs()) {
+		int reg = exp->codeGenReg(backend);
+		backend->generateImm(MipsOp::ADDIU, reg, reg, delta);
+		exp->genStore(backend, reg);
+		backend->freeReg(reg);
+		return;
+	}
+	exp->codeGen(backend);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("addi", LilC_Backend::T0, "1");
+	backend->generateImm(MipsOp::ADDIU, LilC_Backend::T0, LilC_Backend::T0, delta);
 	backend->genPush(LilC_Backend::T0);
-	myExp->genAddr(backend);
+	exp->genAddr(backend);
 	backend->genAssign();
+	backend->genPop(LilC_Backend::T0);
+}
+
+bool PostIncStmtNode::codeGen(LilC_Backend* backend) {
+	backend->genComment(" POSTINC");
+	genIncrement(backend, myExp, 1);
 	return true;
 }
 
 bool PostDecStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " POSTDEC");
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("addi", LilC_Backend::T0, "-1");
-	backend->genPush(LilC_Backend::T0);
-	myExp->genAddr(backend);
-	backend->genAssign();
+	backend->genComment(" POSTDEC");
+	genIncrement(backend, myExp, -1);
 	return true;
 }
 
 bool IfStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " If statement");
-	std::string exit = backend->nextLabel();
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::T1, LilC_Backend::TRUE);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, exit);
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
+	backend->genComment(" If statement");
+	MipsOperand exit = backend->nextLabel();
+	genSkipUnless(backend, myExp, exit);
+	backend->genReserve(myDecls->sizeOfDecls());
 	myStmts->codeGen(backend);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
+	backend->genRelease(myDecls->sizeOfDecls());
 	backend->genLabel(exit, " Skip if statment");
 	return true;
 }
 
-bool IfStmtNode::codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
-	backend->generateWithComment("", " If statement");
-	std::string exit = backend->nextLabel();
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::T1, LilC_Backend::TRUE);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, exit);
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
+bool IfStmtNode::codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
+	backend->genComment(" If statement");
+	MipsOperand exit = backend->nextLabel();
+	genSkipUnless(backend, myExp, exit);
+	backend->genReserve(myDecls->sizeOfDecls());
 	myStmts->codeGenWithExit(backend, exitLabel);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
+	backend->genRelease(myDecls->sizeOfDecls());
 	backend->genLabel(exit, " Skip if statment");
 	return true;
 }
 
 bool IfElseStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " If else statement");
-	std::string elseB = backend->nextLabel();
-	std::string exit = backend->nextLabel();
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::T1, LilC_Backend::TRUE);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, elseB);
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsT->sizeOfDecls()));
+	backend->genComment(" If else statement");
+	MipsOperand elseB = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
+	genSkipUnless(backend, myExp, elseB);
+	backend->genReserve(myDeclsT->sizeOfDecls());
 	myStmtsT->codeGen(backend);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsT->sizeOfDecls()));
-	backend->generate("j", exit);
+	backend->genRelease(myDeclsT->sizeOfDecls());
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(elseB, " else portion statment");
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsF->sizeOfDecls()));
+	backend->genReserve(myDeclsF->sizeOfDecls());
 	myStmtsF->codeGen(backend);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsT->sizeOfDecls()));
+	backend->genRelease(myDeclsF->sizeOfDecls());
 	backend->genLabel(exit);
 	return true;
 }
 
-bool IfElseStmtNode::codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
-	backend->generateWithComment("", " If else statement");
-	std::string elseB = backend->nextLabel();
-	std::string exit = backend->nextLabel();
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::T1, LilC_Backend::TRUE);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, elseB);
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsT->sizeOfDecls()));
+bool IfElseStmtNode::codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
+	backend->genComment(" If else statement");
+	MipsOperand elseB = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
+	genSkipUnless(backend, myExp, elseB);
+	backend->genReserve(myDeclsT->sizeOfDecls());
 	myStmtsT->codeGenWithExit(backend, exitLabel);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsT->sizeOfDecls()));
-	backend->generate("j", exit);
+	backend->genRelease(myDeclsT->sizeOfDecls());
+	backend->generateJump(MipsOp::J, exit);
 	backend->genLabel(elseB, " else portion statment");
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsF->sizeOfDecls()));
+	backend->genReserve(myDeclsF->sizeOfDecls());
 	myStmtsF->codeGenWithExit(backend, exitLabel);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDeclsT->sizeOfDecls()));
+	backend->genRelease(myDeclsF->sizeOfDecls());
 	backend->genLabel(exit);
 	return true;
 }
 
 bool WhileStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " while statement");
-	std::string start = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+	backend->genComment(" while statement");
+	MipsOperand start = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	backend->genLabel(start, " Beginning of while loop");
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::T1, LilC_Backend::TRUE);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, exit);
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
+	genSkipUnless(backend, myExp, exit);
+	backend->genReserve(myDecls->sizeOfDecls());
 	myStmts->codeGen(backend);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
-	backend->generate("j", start);
+	backend->genRelease(myDecls->sizeOfDecls());
+	backend->generateJump(MipsOp::J, start);
 	backend->genLabel(exit, " exit for while loop");
 	return true;
 }
 
-bool WhileStmtNode::codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
-	backend->generateWithComment("", " while statement");
-	std::string start = backend->nextLabel();
-	std::string exit = backend->nextLabel();
+bool WhileStmtNode::codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
+	backend->genComment(" while statement");
+	MipsOperand start = backend->nextLabel();
+	MipsOperand exit = backend->nextLabel();
 	backend->genLabel(start, " Beginning of while loop");
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::T1, LilC_Backend::TRUE);
-	backend->generate("bne", LilC_Backend::T0, LilC_Backend::T1, exit);
-	backend->generate("subu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
+	genSkipUnless(backend, myExp, exit);
+	backend->genReserve(myDecls->sizeOfDecls());
 	myStmts->codeGenWithExit(backend, exitLabel);
-	backend->generate("addu", LilC_Backend::SP, LilC_Backend::SP, std::to_string(myDecls->sizeOfDecls()));
-	backend->generate("j", start);
+	backend->genRelease(myDecls->sizeOfDecls());
+	backend->generateJump(MipsOp::J, start);
 	backend->genLabel(exit, " exit for while loop");
 	return true;
 }
 
 bool ReadStmtNode::codeGen(LilC_Backend* backend) {
-	backend->generateWithComment("", " READ");
+	backend->genComment(" READ");
 	myExp->genAddr(backend);
 	backend->genPop(LilC_Backend::T0);
-	backend->generate("li", LilC_Backend::V0, "5");
-	backend->generate("syscall");
-	backend->generateIndexed("sw", LilC_Backend::V0, LilC_Backend::T0, 0, "Store value read");
+	backend->generateImm(MipsOp::LI, LilC_Backend::V0, 5);
+	backend->generate(MipsOp::SYSCALL);
+	backend->generateIndexed(MipsOp::SW, LilC_Backend::V0, LilC_Backend::T0, 0, "Store value read");
 	return true;
 }
 
 bool CallStmtNode::codeGen(LilC_Backend* backend) {
-	myCallExp->codeGen(backend);
-	backend->genPop(LilC_Backend::T0);
+	backend->freeReg(myCallExp->genValue(backend, LilC_Backend::T0));
 	return true;
 }
 
 bool CallExpNode::codeGen(LilC_Backend* backend) {
 	myExpList->codeGen(backend);
 	myId->genJumpAndLink(backend);
+	backend->calleePopped(4 * static_cast<int>(myExpList->getExps()->size()));
 	backend->genPush(LilC_Backend::V0);
 	return true;
 }
 
 bool ExpListNode::codeGen(LilC_Backend* backend) {
-	for (ExpNode * exp : myExps) {
+	for (ExpNode * exp : *myExps) {
 		exp->codeGen(backend);
 	}
 	return true;
 }
 
-bool ReturnStmtNode::codeGenWithExit(LilC_Backend* backend, std::string exitLabel) {
-	myExp->codeGen(backend);
-	backend->genPop(LilC_Backend::V0);
-	backend->generate("j", exitLabel);
+bool ReturnStmtNode::codeGenWithExit(LilC_Backend* backend, MipsOperand exitLabel) {
+	if (myExp != nullptr) {
+		int reg = myExp->genValue(backend, LilC_Backend::V0);
+		if (reg != LilC_Backend::V0) {
+			backend->generate(MipsOp::MOVE, LilC_Backend::V0, reg);
+		}
+		backend->freeReg(reg);
+	}
+	backend->generateJump(MipsOp::J, exitLabel);
 	return true;
 }
 
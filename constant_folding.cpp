@@ -0,0 +1,315 @@
+#include "err.hpp"
+#include "ast.hpp"
+#include "ast_visitor.hpp"
+#include "symbol_table.hpp"
+
+// Constant folding (-ffold), run after type analysis. Operators
+// whose operands are literals are evaluated (with 32-bit
+// wraparound, like the MIPS instructions they replace), algebraic
+// identities are simplified away, and multiplying or dividing by
+// a power of two becomes a shift. Division by a literal zero is
+// warned about and left to trap at run time, so whether a program
+// compiles never depends on -ffold.
+//
+// FoldExp returns the expression that should replace the one it
+// visits (possibly the same node); FoldStmts walks the statements
+// and stores those replacements back.
+
+namespace LILC{
+
+static ExpNode * makeInt(LilC_Arena& arena, ASTNode * at, int value){
+	return arena.make<IntLitNode>(at->getLine(), at->getCol(), value);
+}
+
+static ExpNode * makeBool(LilC_Arena& arena, ASTNode * at, bool value){
+	if (value) {
+		return arena.make<TrueNode>(at->getLine(), at->getCol());
+	}
+	return arena.make<FalseNode>(at->getLine(), at->getCol());
+}
+
+static int wrap(long long value){
+	return static_cast<int>(static_cast<unsigned int>(value));
+}
+
+// If value is 2^k for k >= 1, return k; otherwise -1
+static int log2Exact(int value){
+	if (value < 2 || (value & (value - 1)) != 0) { return -1; }
+	int bits = 0;
+	while ((1 << bits) != value) { bits++; }
+	return bits;
+}
+
+static bool isConst(ExpNode * exp, int value){
+	int actual;
+	return exp->constValue(actual) && actual == value;
+}
+
+// Apply a binary operator to two literal operands, returning
+// false if the result can't be computed at compile time
+static bool evalConst(NodeKind kind, int v1, int v2, int& result){
+	switch (kind) {
+	case NodeKind::PLUS:
+		result = wrap(static_cast<long long>(v1) + v2);
+		return true;
+	case NodeKind::MINUS:
+		result = wrap(static_cast<long long>(v1) - v2);
+		return true;
+	case NodeKind::TIMES:
+		result = wrap(static_cast<long long>(v1) * v2);
+		return true;
+	case NodeKind::DIVIDE:
+		// Leave x/0 for visitDivide to warn about, and INT_MIN/-1
+		// (which overflows) for run time
+		if (v2 == 0 || (v2 == -1 && v1 == wrap(1LL << 31))) {
+			return false;
+		}
+		result = v1 / v2;
+		return true;
+	case NodeKind::AND:
+		result = v1 != 0 && v2 != 0;
+		return true;
+	case NodeKind::OR:
+		result = v1 != 0 || v2 != 0;
+		return true;
+	case NodeKind::EQUALS:
+		result = v1 == v2;
+		return true;
+	case NodeKind::NOT_EQUALS:
+		result = v1 != v2;
+		return true;
+	case NodeKind::LESS:
+		result = v1 < v2;
+		return true;
+	case NodeKind::GREATER:
+		result = v1 > v2;
+		return true;
+	case NodeKind::LESS_EQ:
+		result = v1 <= v2;
+		return true;
+	case NodeKind::GREATER_EQ:
+		result = v1 >= v2;
+		return true;
+	default:
+		throw InternalError("evalConst: not a binary operator");
+	}
+}
+
+namespace {
+
+class FoldExp : public ASTVisitor<FoldExp, ExpNode *>{
+public:
+	explicit FoldExp(LilC_Arena& arenaIn) : arena(arenaIn){ }
+
+	// Ids, literals and dot accesses have nothing to fold, and
+	// neither do the shifts, which only come out of folding
+	ExpNode * visitExp(ExpNode * node){ return node; }
+
+	ExpNode * visitAssign(AssignNode * node){
+		node->setRHS(visit(node->getRHS()));
+		return node;
+	}
+
+	ExpNode * visitCallExp(CallExpNode * node){
+		for (ExpNode *& exp : *node->getExpList()->getExps()) {
+			exp = visit(exp);
+		}
+		return node;
+	}
+
+	ExpNode * visitUnaryMinus(UnaryMinusNode * node){
+		ExpNode * exp = visit(node->getExp());
+		node->setExp(exp);
+		int value;
+		if (exp->constValue(value)) {
+			return makeInt(arena, node,
+				wrap(-static_cast<long long>(value)));
+		}
+		if (exp->getNodeKind() == NodeKind::UNARY_MINUS) {
+			return static_cast<UnaryMinusNode *>(exp)->getExp();
+		}
+		return node;
+	}
+
+	ExpNode * visitNot(NotNode * node){
+		ExpNode * exp = visit(node->getExp());
+		node->setExp(exp);
+		int value;
+		if (exp->constValue(value)) {
+			return makeBool(arena, node, value == 0);
+		}
+		if (exp->getNodeKind() == NodeKind::NOT) {
+			return static_cast<NotNode *>(exp)->getExp();
+		}
+		return node;
+	}
+
+	// Fold the operands, then evaluate the operator if both are
+	// literals. Operators with identities to simplify override
+	// this and call it first.
+	ExpNode * visitBinary(BinaryExpNode * node){
+		node->setExp1(visit(node->getExp1()));
+		node->setExp2(visit(node->getExp2()));
+		int v1, v2, result;
+		if (node->getExp1()->constValue(v1)
+			&& node->getExp2()->constValue(v2)
+			&& evalConst(node->getNodeKind(), v1, v2, result)) {
+			if (node->binOpKind() == BinOpKind::MATH) {
+				return makeInt(arena, node, result);
+			}
+			return makeBool(arena, node, result != 0);
+		}
+		return node;
+	}
+
+	ExpNode * visitPlus(PlusNode * node){
+		ExpNode * folded = visitBinary(node);
+		if (folded != node) { return folded; }
+		if (isConst(node->getExp2(), 0)) { return node->getExp1(); }
+		if (isConst(node->getExp1(), 0)) { return node->getExp2(); }
+		return node;
+	}
+
+	ExpNode * visitMinus(MinusNode * node){
+		ExpNode * folded = visitBinary(node);
+		if (folded != node) { return folded; }
+		if (isConst(node->getExp2(), 0)) { return node->getExp1(); }
+		return node;
+	}
+
+	ExpNode * visitTimes(TimesNode * node){
+		ExpNode * folded = visitBinary(node);
+		if (folded != node) { return folded; }
+		// Multiplication commutes, so look for the literal on
+		// either side
+		for (int side = 0; side < 2; side++) {
+			ExpNode * lit = side == 0 ? node->getExp2() : node->getExp1();
+			ExpNode * other = side == 0 ? node->getExp1() : node->getExp2();
+			int value;
+			if (!lit->constValue(value)) { continue; }
+			if (value == 1) { return other; }
+			if (value == 0 && !other->hasSideEffects()) {
+				return makeInt(arena, node, 0);
+			}
+			int bits = log2Exact(value);
+			if (bits > 0) {
+				return arena.make<ShiftLeftNode>(node->getLine(),
+					node->getCol(), other, bits);
+			}
+		}
+		return node;
+	}
+
+	ExpNode * visitDivide(DivideNode * node){
+		ExpNode * folded = visitBinary(node);
+		if (folded != node) { return folded; }
+		int value;
+		if (!node->getExp2()->constValue(value)) { return node; }
+		if (value == 0) {
+			Err::divByZero(node->getExp2()->getPosition());
+			return node;
+		}
+		if (value == 1) { return node->getExp1(); }
+		int bits = log2Exact(value);
+		if (bits > 0) {
+			return arena.make<ShiftRightNode>(node->getLine(),
+				node->getCol(), node->getExp1(), bits);
+		}
+		return node;
+	}
+
+	ExpNode * visitAnd(AndNode * node){
+		ExpNode * folded = visitBinary(node);
+		if (folded != node) { return folded; }
+		ExpNode * exp1 = node->getExp1();
+		ExpNode * exp2 = node->getExp2();
+		int value;
+		if (exp1->constValue(value)) {
+			return value != 0 ? exp2 : exp1;
+		}
+		if (exp2->constValue(value)) {
+			if (value != 0) { return exp1; }
+			if (!exp1->hasSideEffects()) { return exp2; }
+		}
+		return node;
+	}
+
+	ExpNode * visitOr(OrNode * node){
+		ExpNode * folded = visitBinary(node);
+		if (folded != node) { return folded; }
+		ExpNode * exp1 = node->getExp1();
+		ExpNode * exp2 = node->getExp2();
+		int value;
+		if (exp1->constValue(value)) {
+			return value != 0 ? exp1 : exp2;
+		}
+		if (exp2->constValue(value)) {
+			if (value == 0) { return exp1; }
+			if (!exp1->hasSideEffects()) { return exp2; }
+		}
+		return node;
+	}
+
+private:
+	LilC_Arena& arena;
+};
+
+// Folds the expressions of every statement in the function
+// bodies. Declarations have nothing to fold.
+class FoldStmts : public ASTWalker<FoldStmts>{
+public:
+	explicit FoldStmts(LilC_Arena& arena) : fold(arena){ }
+
+	void visitDecl(DeclNode *){ }
+	void visitFnDecl(FnDeclNode * node){
+		visit(node->getBody()->getStmtList());
+	}
+
+	// Only reached through statements that have nothing to fold
+	void visitExp(ExpNode *){ }
+
+	void visitAssignStmt(AssignStmtNode * node){
+		fold.visit(node->getAssign());
+	}
+
+	void visitWriteStmt(WriteStmtNode * node){
+		node->setExp(fold.visit(node->getExp()));
+	}
+
+	void visitIfStmt(IfStmtNode * node){
+		node->setExp(fold.visit(node->getExp()));
+		visit(node->getStmtList());
+	}
+
+	void visitIfElseStmt(IfElseStmtNode * node){
+		node->setExp(fold.visit(node->getExp()));
+		visit(node->getThenStmtList());
+		visit(node->getElseStmtList());
+	}
+
+	void visitWhileStmt(WhileStmtNode * node){
+		node->setExp(fold.visit(node->getExp()));
+		visit(node->getStmtList());
+	}
+
+	void visitCallStmt(CallStmtNode * node){
+		fold.visit(node->getCallExp());
+	}
+
+	void visitReturnStmt(ReturnStmtNode * node){
+		if (node->getExp() != nullptr) {
+			node->setExp(fold.visit(node->getExp()));
+		}
+	}
+
+private:
+	FoldExp fold;
+};
+
+} // end anonymous namespace
+
+void ProgramNode::constFold(LilC_Arena& arena){
+	FoldStmts(arena).visit(this);
+}
+
+} // End namespace LILC
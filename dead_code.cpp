@@ -0,0 +1,170 @@
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ast.hpp"
+#include "ast_visitor.hpp"
+
+// Dead code elimination (-fdce), run after constant folding.
+// Statements after one that never completes (a return, an if/else
+// whose branches both return, a while (true)) are dropped, as are
+// if (false) and while (false). An if on a constant whose chosen
+// branch declares nothing is replaced by that branch's statements.
+// Finally, functions that main can never reach are removed from
+// the program.
+
+namespace LILC{
+
+namespace {
+
+bool constCond(ExpNode * exp, bool& value){
+	int constant;
+	if (!exp->constValue(constant)){ return false; }
+	value = constant != 0;
+	return true;
+}
+
+bool completes(StmtListNode * stmts);
+
+// Can control reach the statement after stmt?
+bool completes(StmtNode * stmt){
+	bool cond;
+	switch (stmt->getNodeKind()){
+	case NodeKind::RETURN_STMT:
+		return false;
+	case NodeKind::IF_ELSE_STMT: {
+		IfElseStmtNode * node = static_cast<IfElseStmtNode *>(stmt);
+		return completes(node->getThenStmtList())
+			|| completes(node->getElseStmtList());
+	}
+	case NodeKind::WHILE_STMT:
+		// Lil'C has no break, so only a return leaves while (true)
+		return !constCond(static_cast<WhileStmtNode *>(stmt)->getExp(), cond)
+			|| !cond;
+	default:
+		return true;
+	}
+}
+
+bool completes(StmtListNode * stmts){
+	for (StmtNode * stmt : stmts->getStmts()){
+		if (!completes(stmt)){ return false; }
+	}
+	return true;
+}
+
+class DeadStmts : public ASTWalker<DeadStmts>{
+public:
+	void visitStmtList(StmtListNode * node){
+		NodeList<StmtNode *>& stmts = node->getStmts();
+		std::vector<StmtNode *> kept;
+		for (StmtNode * stmt : stmts){
+			if (!keep(stmt, kept)){ break; }
+		}
+		stmts.clear();
+		for (StmtNode * stmt : kept){
+			stmts.push_back(stmt);
+			visit(stmt);
+		}
+	}
+
+	void visitFnDecl(FnDeclNode * node){
+		current = &calls[node->getName()];
+		visitChildren(node);
+		current = nullptr;
+	}
+
+	void visitCallExp(CallExpNode * node){
+		if (current != nullptr){
+			current->push_back(node->getId()->getString());
+		}
+		visitChildren(node);
+	}
+
+	// The calls left in each function
+	std::unordered_map<std::string, std::vector<std::string>> calls;
+
+private:
+	// Add what is left of stmt to kept; returns false if control
+	// cannot get past it
+	bool keep(StmtNode * stmt, std::vector<StmtNode *>& kept){
+		bool cond;
+		switch (stmt->getNodeKind()){
+		case NodeKind::IF_STMT: {
+			IfStmtNode * node = static_cast<IfStmtNode *>(stmt);
+			if (!constCond(node->getExp(), cond)){ break; }
+			if (!cond){ return true; }
+			return splice(node->getDeclList(), node->getStmtList(),
+				stmt, kept);
+		}
+		case NodeKind::IF_ELSE_STMT: {
+			IfElseStmtNode * node = static_cast<IfElseStmtNode *>(stmt);
+			if (!constCond(node->getExp(), cond)){ break; }
+			if (cond){
+				return splice(node->getThenDeclList(),
+					node->getThenStmtList(), stmt, kept);
+			}
+			return splice(node->getElseDeclList(),
+				node->getElseStmtList(), stmt, kept);
+		}
+		case NodeKind::WHILE_STMT: {
+			WhileStmtNode * node = static_cast<WhileStmtNode *>(stmt);
+			if (constCond(node->getExp(), cond) && !cond){ return true; }
+			break;
+		}
+		default:
+			break;
+		}
+		kept.push_back(stmt);
+		return completes(stmt);
+	}
+
+	// The branch's statements in place of stmt. A branch with
+	// declarations keeps its statement, which reserves their
+	// stack space.
+	bool splice(DeclListNode * decls, StmtListNode * branch,
+		StmtNode * stmt, std::vector<StmtNode *>& kept){
+		if (!decls->getDecls().empty()){
+			kept.push_back(stmt);
+			return completes(stmt);
+		}
+		for (StmtNode * inner : branch->getStmts()){
+			if (!keep(inner, kept)){ return false; }
+		}
+		return true;
+	}
+
+	std::vector<std::string> * current = nullptr;
+};
+
+} // end anonymous namespace
+
+void ProgramNode::removeDeadCode(){
+	DeadStmts dead;
+	dead.visit(this);
+	if (dead.calls.count("main") == 0){ return; }
+
+	std::unordered_set<std::string> reached;
+	std::vector<std::string> work = {"main"};
+	while (!work.empty()){
+		std::string fn = work.back();
+		work.pop_back();
+		if (!reached.insert(fn).second){ continue; }
+		for (const std::string& callee : dead.calls[fn]){
+			work.push_back(callee);
+		}
+	}
+
+	NodeList<DeclNode *>& decls = myDeclList->getDecls();
+	std::vector<DeclNode *> kept;
+	for (DeclNode * decl : decls){
+		if (decl->getNodeKind() == NodeKind::FN_DECL
+			&& reached.count(static_cast<FnDeclNode *>(decl)->getName()) == 0){
+			continue;
+		}
+		kept.push_back(decl);
+	}
+	decls.clear();
+	for (DeclNode * decl : kept){ decls.push_back(decl); }
+}
+
+} // End namespace LILC
@@ -2,6 +2,7 @@
 #define LILC_ERROR_REPORTING_HH
 
 #include <iostream>
+#include "lilc_types.hpp"
 
 namespace LILC{
 
@@ -12,6 +13,11 @@ class Err{
 			<< " ***ERROR*** " << msg << std::endl;
 	}
 
+	static void warn(std::string pos, std::string msg){
+		std::cerr << pos
+			<< " ***WARNING*** " << msg << std::endl;
+	}
+
 	static bool multiDecl(std::string pos){
 		report(pos, "Multiply declared identifiers");
 		return false;
@@ -41,6 +47,9 @@ class Err{
 		report(pos, "Invalid struct field name");
 		return false;
 	}
+	static void divByZero(std::string pos){
+		warn(pos, "Division by zero");
+	}
 	static std::string noMain(std::string pos) {
 		Err::report(pos, "No main function");
 		return "ERROR";
@@ -49,129 +58,129 @@ class Err{
 
 class TypeErr{
 public:
-	static std::string writeFunction(std::string pos){
+	static const LilC_Type * writeFunction(std::string pos){
 		Err::report(pos, "Attempt to write a function");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string writeStructVar(std::string pos){
+	static const LilC_Type * writeStructVar(std::string pos){
 		Err::report(pos, "Attempt to write a struct"
 			" variable");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string writeStructName(std::string pos){
+	static const LilC_Type * writeStructName(std::string pos){
 		Err::report(pos, "Attempt to write a struct"
 			" name");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string readFunction(std::string pos){
+	static const LilC_Type * readFunction(std::string pos){
 		Err::report(pos, "Attempt to read a function");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string readStructVar(std::string pos){
+	static const LilC_Type * readStructVar(std::string pos){
 		Err::report(pos, "Attempt to read a struct"
 			" variable");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string readStructName(std::string pos){
+	static const LilC_Type * readStructName(std::string pos){
 		Err::report(pos, "Attempt to read a struct"
 			" name");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string writeVoid(std::string pos){
+	static const LilC_Type * writeVoid(std::string pos){
 		Err::report(pos, "Attempt to write void");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string badMath(std::string pos){
+	static const LilC_Type * badMath(std::string pos){
 		Err::report(pos, "Arithmetic operator applied"
 			" to non-numeric operand");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string badRelational(std::string pos){
+	static const LilC_Type * badRelational(std::string pos){
 		Err::report(pos, "Relational operator applied"
 			" to non-numeric operand");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string badLogical(std::string pos){
+	static const LilC_Type * badLogical(std::string pos){
 		Err::report(pos, "Logical operator applied"
 			" to non-bool operand");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string callNonFunc(std::string pos){
+	static const LilC_Type * callNonFunc(std::string pos){
 		Err::report(pos, "Attempt to call a"
 			" non-function");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string badNumArgs(std::string pos){
+	static const LilC_Type * badNumArgs(std::string pos){
 		Err::report(pos, "Function call with"
 			" wrong number of args");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string argMismatch(std::string pos){
+	static const LilC_Type * argMismatch(std::string pos){
 		Err::report(pos, "Type of actual does"
 			" not match type of formal");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string missingReturnValue(std::string pos){
+	static const LilC_Type * missingReturnValue(std::string pos){
 		Err::report(pos, "Missing return value");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string badReturnValue(std::string pos){
+	static const LilC_Type * badReturnValue(std::string pos){
 		Err::report(pos, "Bad return value");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string returnFromVoid(std::string pos){
+	static const LilC_Type * returnFromVoid(std::string pos){
 		Err::report(pos, "Return with a value in a"
 			" void function");
-		return "ERROR";
+		return LilC_Type::error();
 	}
-	static std::string typeMismatch(std::string pos){
+	static const LilC_Type * typeMismatch(std::string pos){
 		Err::report(pos, "Type mismatch");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string voidEq(std::string pos){
+	static const LilC_Type * voidEq(std::string pos){
 		Err::report(pos, "Equality operator applied"
 			" to void functions");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string funEq(std::string pos){
+	static const LilC_Type * funEq(std::string pos){
 		Err::report(pos, "Equality operator applied"
 			" to functions");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string structVarEq(std::string pos){
+	static const LilC_Type * structVarEq(std::string pos){
 		Err::report(pos, "Equality operator applied"
 			" to struct variables");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string structNameEq(std::string pos){
+	static const LilC_Type * structNameEq(std::string pos){
 		Err::report(pos, "Equality operator applied"
 			" to struct names");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string badIfCond(std::string pos){
+	static const LilC_Type * badIfCond(std::string pos){
 		Err::report(pos, "Non-bool expression used"
 			" as an if condition");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string assignFunction(std::string pos){
+	static const LilC_Type * assignFunction(std::string pos){
 		Err::report(pos, "Function assignment");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string assignStructName(std::string pos){
+	static const LilC_Type * assignStructName(std::string pos){
 		Err::report(pos, "Struct name assignment");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 
-	static std::string assignStructVar(std::string pos){
+	static const LilC_Type * assignStructVar(std::string pos){
 		Err::report(pos, "Struct variable assignment");
-		return "ERROR";
+		return LilC_Type::error();
 	}
 };
 
@@ -0,0 +1,261 @@
+#include "err.hpp"
+#include "ir.hpp"
+
+namespace LILC{
+
+void IRInstr::uses(std::vector<int>& regs) const {
+	if (src1 != NO_REG){ regs.push_back(src1); }
+	if (src2 != NO_REG){ regs.push_back(src2); }
+	for (int arg : args){ regs.push_back(arg); }
+}
+
+bool IRInstr::isPure() const {
+	switch (op){
+	case IROp::LI:
+	case IROp::LA_STR:
+	case IROp::MOVE:
+	case IROp::LOAD_GLOBAL:
+	case IROp::ADD:
+	case IROp::SUB:
+	case IROp::SLL:
+	case IROp::SRL:
+	case IROp::SRA:
+	case IROp::MUL:
+	case IROp::NEG:
+	case IROp::NOT:
+	case IROp::SEQ:
+	case IROp::SNE:
+	case IROp::SLT:
+	case IROp::SGT:
+	case IROp::SLE:
+	case IROp::SGE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void IRBlock::successors(std::vector<int>& succs) const {
+	if (instrs.empty()){ return; }
+	const IRInstr& last = instrs.back();
+	if (last.op == IROp::JUMP){
+		succs.push_back(last.target);
+	} else if (last.op == IROp::BRANCH){
+		succs.push_back(last.target);
+		if (last.target2 != last.target){
+			succs.push_back(last.target2);
+		}
+	}
+}
+
+IRFunction::~IRFunction(){
+	for (IRBlock * block : blocks){ delete block; }
+}
+
+void IRFunction::removeUnreachable(){
+	std::vector<int> layoutIndex(static_cast<size_t>(numBlocks), -1);
+	for (size_t i = 0; i < blocks.size(); i++){
+		layoutIndex[static_cast<size_t>(blocks[i]->id)] = static_cast<int>(i);
+	}
+	std::vector<bool> reached(blocks.size(), false);
+	std::vector<size_t> work = {0};
+	while (!work.empty()){
+		size_t i = work.back();
+		work.pop_back();
+		if (i >= blocks.size() || reached[i]){ continue; }
+		reached[i] = true;
+		std::vector<int> succs;
+		blocks[i]->successors(succs);
+		for (int succ : succs){
+			work.push_back(static_cast<size_t>(
+				layoutIndex[static_cast<size_t>(succ)]));
+		}
+		// A block without a terminator runs into the next one
+		if (blocks[i]->instrs.empty() || !blocks[i]->instrs.back().isTerminator()){
+			work.push_back(i + 1);
+		}
+	}
+	size_t kept = 0;
+	for (size_t i = 0; i < blocks.size(); i++){
+		if (reached[i]){
+			blocks[kept++] = blocks[i];
+		} else {
+			delete blocks[i];
+		}
+	}
+	blocks.resize(kept);
+}
+
+IRModule::~IRModule(){
+	for (IRFunction * fn : functions){ delete fn; }
+}
+
+static const char * opName(IROp op){
+	switch (op){
+		case IROp::LI: return "li";
+		case IROp::LA_STR: return "la";
+		case IROp::MOVE: return "move";
+		case IROp::PARAM: return "param";
+		case IROp::LOAD_GLOBAL: return "load";
+		case IROp::STORE_GLOBAL: return "store";
+		case IROp::ADD: return "add";
+		case IROp::SUB: return "sub";
+		case IROp::SLL: return "sll";
+		case IROp::SRL: return "srl";
+		case IROp::SRA: return "sra";
+		case IROp::MUL: return "mul";
+		case IROp::DIV: return "div";
+		case IROp::NEG: return "neg";
+		case IROp::NOT: return "not";
+		case IROp::SEQ: return "seq";
+		case IROp::SNE: return "sne";
+		case IROp::SLT: return "slt";
+		case IROp::SGT: return "sgt";
+		case IROp::SLE: return "sle";
+		case IROp::SGE: return "sge";
+		case IROp::CALL: return "call";
+		case IROp::WRITE_INT: return "write.int";
+		case IROp::WRITE_STR: return "write.str";
+		case IROp::READ_INT: return "read.int";
+		case IROp::JUMP: return "jump";
+		case IROp::BRANCH: return "branch";
+		case IROp::RET: return "ret";
+		default: return "?";
+	}
+}
+
+static std::string regName(int reg){
+	return "%" + std::to_string(reg);
+}
+
+void IRFunction::print(std::ostream& out) const {
+	out << "function " << name << "(" << numFormals << ")\n";
+	for (IRBlock * block : blocks){
+		out << "B" << block->id << ":\n";
+		for (const IRInstr& instr : block->instrs){
+			out << "\t";
+			if (instr.dst != IRInstr::NO_REG){
+				out << regName(instr.dst) << " = ";
+			}
+			out << opName(instr.op);
+			if (instr.op == IROp::BRANCH){
+				out << "." << opName(instr.cond);
+			}
+			if (!instr.str.empty()){ out << " " << instr.str; }
+			if (instr.src1 != IRInstr::NO_REG){
+				out << " " << regName(instr.src1);
+			}
+			if (instr.src2 != IRInstr::NO_REG){
+				out << ", " << regName(instr.src2);
+			} else if (instr.op == IROp::LI || instr.op == IROp::PARAM
+				|| instr.op == IROp::BRANCH
+				|| (instr.src1 != IRInstr::NO_REG
+				&& instr.op >= IROp::ADD && instr.op <= IROp::SGE
+				&& instr.op != IROp::NEG && instr.op != IROp::NOT)){
+				out << (instr.src1 == IRInstr::NO_REG ? " " : ", ")
+					<< instr.imm;
+			}
+			for (size_t i = 0; i < instr.args.size(); i++){
+				out << (i == 0 ? " (" : ", ") << regName(instr.args[i]);
+			}
+			if (!instr.args.empty()){ out << ")"; }
+			if (instr.target >= 0){ out << " -> B" << instr.target; }
+			if (instr.target2 >= 0){ out << ", B" << instr.target2; }
+			out << "\n";
+		}
+	}
+}
+
+void IRModule::print(std::ostream& out) const {
+	for (const std::string& global : globals){
+		out << "global " << global << "\n";
+	}
+	for (IRFunction * fn : functions){
+		fn->print(out);
+	}
+}
+
+IRBuilder::IRBuilder(IRFunction * fnIn){
+	fn = fnIn;
+	setBlock(fn->newBlock());
+}
+
+int IRBuilder::varReg(SymbolTableEntry * sym){
+	auto itr = vars.find(sym);
+	if (itr != vars.end()){ return itr->second; }
+	int reg = newVReg();
+	vars[sym] = reg;
+	return reg;
+}
+
+bool IRBuilder::isVarReg(int reg) const {
+	for (auto& entry : vars){
+		if (entry.second == reg){ return true; }
+	}
+	return false;
+}
+
+bool IRBuilder::terminated() const {
+	return !block->instrs.empty() && block->instrs.back().isTerminator();
+}
+
+IRInstr& IRBuilder::emit(IRInstr instr){
+	if (terminated()){
+		setBlock(newBlock());
+	}
+	block->instrs.push_back(instr);
+	return block->instrs.back();
+}
+
+int IRBuilder::emitLI(int value){
+	IRInstr instr(IROp::LI);
+	instr.dst = newVReg();
+	instr.imm = value;
+	return emit(instr).dst;
+}
+
+int IRBuilder::emitMove(int src){
+	IRInstr instr(IROp::MOVE);
+	instr.dst = newVReg();
+	instr.src1 = src;
+	return emit(instr).dst;
+}
+
+void IRBuilder::emitMoveTo(int dst, int src){
+	IRInstr instr(IROp::MOVE);
+	instr.dst = dst;
+	instr.src1 = src;
+	emit(instr);
+}
+
+int IRBuilder::emitBinary(IROp op, int src1, int src2){
+	IRInstr instr(op);
+	instr.dst = newVReg();
+	instr.src1 = src1;
+	instr.src2 = src2;
+	return emit(instr).dst;
+}
+
+void IRBuilder::emitJump(IRBlock * target){
+	IRInstr instr(IROp::JUMP);
+	instr.target = target->id;
+	emit(instr);
+}
+
+void IRBuilder::emitBranch(
+	IRCond cond,
+	int src1,
+	int src2,
+	IRBlock * target,
+	IRBlock * target2
+){
+	IRInstr instr(IROp::BRANCH);
+	instr.cond = cond;
+	instr.src1 = src1;
+	instr.src2 = src2;
+	instr.target = target->id;
+	instr.target2 = target2->id;
+	emit(instr);
+}
+
+} // End namespace LILC
@@ -0,0 +1,290 @@
+#ifndef LILC_IR_HPP
+#define LILC_IR_HPP
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lilc_mips.hpp"
+
+namespace LILC{
+
+class SymbolTableEntry;
+
+// **************************************************************
+// A linear three-address IR. Each function is a list of basic
+// blocks; every block ends in exactly one terminator (JUMP,
+// BRANCH or RET). Values live in an unbounded set of virtual
+// registers that are mapped onto MIPS registers (or spill slots)
+// only when the IR is emitted. Locals and formals are promoted to
+// virtual registers; globals stay in memory.
+// **************************************************************
+
+enum class IROp {
+	LI,          // dst = imm
+	LA_STR,      // dst = address of string literal str
+	MOVE,        // dst = src1
+	PARAM,       // dst = formal number imm
+	LOAD_GLOBAL, // dst = global str
+	STORE_GLOBAL,// global str = src1
+	ADD,         // dst = src1 + src2
+	SUB,         // dst = src1 - src2
+	SLL,         // dst = src1 << src2
+	SRL,         // dst = src1 >> src2 (logical)
+	SRA,         // dst = src1 >> src2 (arithmetic)
+	MUL,         // dst = src1 * src2
+	DIV,         // dst = src1 / src2
+	NEG,         // dst = -src1
+	NOT,         // dst = !src1 (bools are 0/1)
+	SEQ,         // dst = src1 == src2
+	SNE,         // dst = src1 != src2
+	SLT,         // dst = src1 < src2
+	SGT,         // dst = src1 > src2
+	SLE,         // dst = src1 <= src2
+	SGE,         // dst = src1 >= src2
+	CALL,        // dst = str(args...)
+	WRITE_INT,   // print src1 as an int
+	WRITE_STR,   // print the string src1 points to
+	READ_INT,    // dst = int read from input
+	JUMP,        // goto target
+	BRANCH,      // if (src1 cond src2) goto target else goto target2
+	RET          // return src1 (if present)
+};
+
+// The comparison a BRANCH makes; reuses the set opcodes
+typedef IROp IRCond;
+
+struct IRInstr {
+	static const int NO_REG = -1;
+
+	IRInstr(IROp opIn) : op(opIn){ }
+
+	IROp op;
+	int dst = NO_REG;
+	int src1 = NO_REG;
+	// when src2 is NO_REG, binary operations and branches use
+	// imm as their second operand
+	int src2 = NO_REG;
+	int imm = 0;
+	IRCond cond = IROp::SNE;
+	std::string str;
+	std::vector<int> args;
+	int target = -1;
+	int target2 = -1;
+
+	bool isTerminator() const {
+		return op == IROp::JUMP || op == IROp::BRANCH || op == IROp::RET;
+	}
+	// Append the virtual registers this instruction reads
+	void uses(std::vector<int>& regs) const;
+	// Does the instruction do nothing but set dst, so that it can
+	// be deleted or repeated? (DIV can trap, so it is not pure.)
+	bool isPure() const;
+};
+
+struct IRBlock {
+	IRBlock(int idIn) : id(idIn){ }
+	int id;
+	std::vector<IRInstr> instrs;
+	void successors(std::vector<int>& succs) const;
+};
+
+class IRFunction {
+public:
+	IRFunction(std::string nameIn, int formalsIn)
+	: name(nameIn), numFormals(formalsIn){ }
+	~IRFunction();
+
+	std::string name;
+	int numFormals;
+	int numVRegs = 0;
+	int numBlocks = 0;
+	// Blocks in layout order; blocks[0] is the entry. Ids are
+	// assigned on creation, so they need not follow the layout.
+	std::vector<IRBlock *> blocks;
+
+	int newVReg(){ return numVRegs++; }
+	// Create a block; it joins the layout once placeBlock is
+	// called on it
+	IRBlock * newBlock(){ return new IRBlock(numBlocks++); }
+	void placeBlock(IRBlock * block){ blocks.push_back(block); }
+	// Drop the blocks no path from the entry reaches
+	void removeUnreachable();
+	void print(std::ostream& out) const;
+};
+
+class IRModule {
+public:
+	~IRModule();
+	std::vector<std::string> globals;
+	std::vector<IRFunction *> functions;
+	void print(std::ostream& out) const;
+};
+
+// **************************************************************
+// Builder used by the AST lowering methods: tracks the function
+// and block being filled and which virtual register holds each
+// promoted local.
+// **************************************************************
+class IRBuilder {
+public:
+	IRBuilder(IRFunction * fnIn);
+
+	IRFunction * function(){ return fn; }
+	IRBlock * currentBlock(){ return block; }
+	// Start emitting into b, placing it after the blocks
+	// emitted so far
+	void setBlock(IRBlock * b){
+		block = b;
+		fn->placeBlock(b);
+	}
+	IRBlock * newBlock(){ return fn->newBlock(); }
+
+	int newVReg(){ return fn->newVReg(); }
+	// The home register of a promoted local, created on first use
+	int varReg(SymbolTableEntry * sym);
+	bool isVarReg(int reg) const;
+
+	// Append instr to the current block. If the block has
+	// already been terminated (e.g. by a return), the
+	// instruction goes into a fresh, unreachable block.
+	IRInstr& emit(IRInstr instr);
+
+	int emitLI(int value);
+	int emitMove(int src);
+	void emitMoveTo(int dst, int src);
+	int emitBinary(IROp op, int src1, int src2);
+	void emitJump(IRBlock * target);
+	void emitBranch(IRCond cond, int src1, int src2,
+		IRBlock * target, IRBlock * target2);
+	bool terminated() const;
+
+private:
+	IRFunction * fn;
+	IRBlock * block;
+	std::unordered_map<SymbolTableEntry *, int> vars;
+};
+
+// **************************************************************
+// Replaces calls to small functions with a copy of the callee's
+// blocks (ir_inline.cpp). Functions are visited callees first, so
+// a callee is measured after its own calls have been inlined.
+// Recursive functions and main are never inlined.
+// **************************************************************
+class IRInliner {
+public:
+	// Callees with more than limit instructions stay calls
+	IRInliner(int limitIn) : limit(limitIn){ }
+	// Returns the number of call sites inlined
+	int run(IRModule& module);
+
+private:
+	void findRecursion(IRModule& module);
+	bool inlinable(IRFunction * caller, const IRInstr& call);
+	void inlineCall(IRFunction& caller, size_t blockIndex,
+		size_t instrIndex, const IRFunction& callee);
+
+	int limit;
+	std::unordered_map<std::string, IRFunction *> byName;
+	// Callees first: the order functions are inlined into
+	std::vector<IRFunction *> order;
+	std::unordered_map<std::string, bool> recursive;
+};
+
+// **************************************************************
+// Turns self-recursive calls in tail position into jumps back to
+// the top of the function (ir_tailcall.cpp). Calls whose result is
+// only added to or multiplied by a value before being returned are
+// handled too, by carrying the pending sum or product in an
+// accumulator.
+// **************************************************************
+class IRTailCalls {
+public:
+	// Returns the number of calls turned into jumps
+	int run(IRModule& module);
+
+private:
+	int rewrite(IRFunction& fn);
+};
+
+// **************************************************************
+// Value numbering (ir_cse.cpp) over blocks and their chains of
+// single-predecessor successors. A pure computation whose value
+// some register already holds becomes a move, uses are redirected
+// to the first register holding their value, and a global load
+// reuses the last value loaded from or stored to that global
+// until a call. Pure instructions whose result is never read are
+// then deleted.
+// **************************************************************
+class IRValueNumbering {
+public:
+	// Returns the number of instructions removed or replaced
+	int run(IRModule& module);
+
+private:
+	int numberFunction(IRFunction& fn);
+	int removeDeadDefs(IRFunction& fn);
+};
+
+// **************************************************************
+// Loop optimizations (ir_loop.cpp). Loops are found from the back
+// edges of the dominator tree, innermost first. Each gets a
+// preheader that invariant computations and loads are hoisted
+// into, and multiplies of a basic induction variable by a
+// constant are replaced by a register stepped alongside it.
+// **************************************************************
+class IRLoopOpt {
+public:
+	// Returns the number of instructions hoisted or reduced
+	int run(IRModule& module);
+
+private:
+	int optimize(IRFunction& fn);
+};
+
+// **************************************************************
+// Emits MIPS for an IR module through the backend, after mapping
+// each function's virtual registers onto the register pool with
+// a linear-scan allocator.
+// **************************************************************
+class IRCodeGen {
+public:
+	IRCodeGen(LilC_Backend * backendIn) : backend(backendIn){ }
+	void genModule(IRModule& module);
+
+private:
+	void genFunction(IRFunction& fn);
+	void allocate(IRFunction& fn);
+	void genInstr(IRFunction& fn, IRInstr& instr, int pos,
+		IRBlock * next);
+	int useReg(int vreg, int scratch);
+	int defReg(int vreg);
+	void finishDef(int vreg, int reg);
+	MipsOperand blockLabel(IRFunction& fn, int block);
+	int frameOffset(int slot);
+
+	// formals passed in LilC_Backend::ARG_REGS
+	static const int NUM_ARG_REGS = 4;
+
+	LilC_Backend * backend;
+	IRFunction * curFn = nullptr;
+	LilC_Frame frame;
+	MipsOperand exitLabel;
+	std::vector<MipsOperand> blockLabels;
+
+	// Results of allocation for the current function
+	struct Interval {
+		int vreg;
+		int start;
+		int end;
+	};
+	std::vector<Interval> intervals;
+	std::vector<int> location;   // register, or MipsReg::NONE if spilled
+	std::vector<int> spillSlot;
+	int numSpillSlots = 0;
+};
+
+} //End namespace LILC
+
+#endif
@@ -0,0 +1,452 @@
+#include <algorithm>
+#include "err.hpp"
+#include "ir.hpp"
+
+// MIPS generation from the IR. Each function's virtual registers
+// get a single live interval (from liveness over the CFG) and are
+// mapped onto the backend's register pool by linear scan; what
+// doesn't fit is spilled to a slot below the saved FP. T0 and T1
+// are the scratch registers spilled operands are loaded into.
+//
+// The first four arguments travel in $a0-$a3 and the rest on the
+// stack. Functions only set up the parts of the frame they use:
+// a leaf keeps RA where it is, and FP is only needed to reach
+// stack formals and spill slots.
+
+namespace LILC{
+
+void IRCodeGen::genModule(IRModule& module){
+	for (const std::string& global : module.globals) {
+		backend->genGlobalVar(global, 4);
+	}
+	for (IRFunction * fn : module.functions) {
+		genFunction(*fn);
+	}
+}
+
+void IRCodeGen::genFunction(IRFunction& fn){
+	curFn = &fn;
+	allocate(fn);
+
+	blockLabels.assign(static_cast<size_t>(fn.numBlocks), MipsOperand());
+	for (IRBlock * block : fn.blocks) {
+		blockLabels[static_cast<size_t>(block->id)] = backend->nextLabel();
+	}
+	exitLabel = backend->fnExitLabel(fn.name);
+
+	bool leaf = true;
+	for (IRBlock * block : fn.blocks) {
+		for (const IRInstr& instr : block->instrs) {
+			if (instr.op == IROp::CALL) { leaf = false; }
+		}
+	}
+	frame = LilC_Frame();
+	frame.saveRA = !leaf;
+	frame.stackFormalsSize = std::max(0, fn.numFormals - NUM_ARG_REGS) * 4;
+	frame.localsSize = numSpillSlots * 4;
+	frame.useFP = frame.stackFormalsSize > 0 || frame.localsSize > 0;
+
+	backend->genFnEntry(fn.name, frame);
+	int pos = 0;
+	for (size_t i = 0; i < fn.blocks.size(); i++) {
+		IRBlock * block = fn.blocks[i];
+		IRBlock * next = i + 1 < fn.blocks.size() ? fn.blocks[i + 1] : nullptr;
+		backend->genLabel(blockLabel(fn, block->id));
+		for (IRInstr& instr : block->instrs) {
+			genInstr(fn, instr, pos++, next);
+		}
+	}
+	backend->genFnExit(fn.name, frame);
+}
+
+/*
+* Live intervals: number the instructions in layout order, solve
+* liveness over the blocks, and give each virtual register the
+* range from its first to its last live point.
+*/
+void IRCodeGen::allocate(IRFunction& fn){
+	size_t numRegs = static_cast<size_t>(fn.numVRegs);
+	size_t numBlocks = fn.blocks.size();
+	std::vector<int> layoutIndex(static_cast<size_t>(fn.numBlocks), -1);
+	for (size_t i = 0; i < numBlocks; i++) {
+		layoutIndex[static_cast<size_t>(fn.blocks[i]->id)] = static_cast<int>(i);
+	}
+
+	std::vector<std::vector<bool>> use(numBlocks, std::vector<bool>(numRegs));
+	std::vector<std::vector<bool>> def(numBlocks, std::vector<bool>(numRegs));
+	std::vector<std::vector<bool>> liveIn(numBlocks, std::vector<bool>(numRegs));
+	std::vector<std::vector<bool>> liveOut(numBlocks, std::vector<bool>(numRegs));
+	std::vector<int> blockStart(numBlocks);
+	std::vector<int> blockEnd(numBlocks);
+	std::vector<int> first(numRegs, -1);
+	std::vector<int> last(numRegs, -1);
+	auto touch = [&](int vreg, int pos){
+		size_t v = static_cast<size_t>(vreg);
+		if (first[v] < 0 || pos < first[v]) { first[v] = pos; }
+		if (pos > last[v]) { last[v] = pos; }
+	};
+
+	int pos = 0;
+	for (size_t b = 0; b < numBlocks; b++) {
+		blockStart[b] = pos;
+		for (const IRInstr& instr : fn.blocks[b]->instrs) {
+			std::vector<int> srcs;
+			instr.uses(srcs);
+			for (int src : srcs) {
+				size_t v = static_cast<size_t>(src);
+				if (!def[b][v]) { use[b][v] = true; }
+				touch(src, pos);
+			}
+			if (instr.dst != IRInstr::NO_REG) {
+				def[b][static_cast<size_t>(instr.dst)] = true;
+				touch(instr.dst, pos);
+			}
+			pos++;
+		}
+		blockEnd[b] = pos - 1;
+	}
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (size_t b = numBlocks; b-- > 0;) {
+			std::vector<int> succs;
+			fn.blocks[b]->successors(succs);
+			for (int succ : succs) {
+				size_t s = static_cast<size_t>(layoutIndex[static_cast<size_t>(succ)]);
+				for (size_t v = 0; v < numRegs; v++) {
+					if (liveIn[s][v] && !liveOut[b][v]) {
+						liveOut[b][v] = true;
+						changed = true;
+					}
+				}
+			}
+			for (size_t v = 0; v < numRegs; v++) {
+				bool in = use[b][v] || (liveOut[b][v] && !def[b][v]);
+				if (in && !liveIn[b][v]) {
+					liveIn[b][v] = true;
+					changed = true;
+				}
+			}
+		}
+	}
+	for (size_t b = 0; b < numBlocks; b++) {
+		for (size_t v = 0; v < numRegs; v++) {
+			if (liveIn[b][v]) { touch(static_cast<int>(v), blockStart[b]); }
+			if (liveOut[b][v]) { touch(static_cast<int>(v), blockEnd[b]); }
+		}
+	}
+
+	intervals.clear();
+	for (size_t v = 0; v < numRegs; v++) {
+		if (first[v] >= 0) {
+			intervals.push_back({static_cast<int>(v), first[v], last[v]});
+		}
+	}
+	std::sort(intervals.begin(), intervals.end(),
+		[](const Interval& a, const Interval& b){
+			return a.start < b.start;
+		});
+
+	// Linear scan over the pool; when it runs dry, spill
+	// whichever interval ends last
+	const std::vector<int>& pool = LilC_Backend::regPool();
+	std::vector<bool> busy(pool.size(), false);
+	std::vector<Interval> active;
+	location.assign(numRegs, MipsReg::NONE);
+	spillSlot.assign(numRegs, -1);
+	numSpillSlots = 0;
+	auto regIndex = [&](int vreg){
+		int reg = location[static_cast<size_t>(vreg)];
+		return static_cast<size_t>(std::find(pool.begin(), pool.end(), reg) - pool.begin());
+	};
+	auto spill = [&](int vreg){
+		location[static_cast<size_t>(vreg)] = MipsReg::NONE;
+		spillSlot[static_cast<size_t>(vreg)] = numSpillSlots++;
+	};
+
+	for (const Interval& cur : intervals) {
+		for (auto itr = active.begin(); itr != active.end();) {
+			if (itr->end < cur.start) {
+				busy[regIndex(itr->vreg)] = false;
+				itr = active.erase(itr);
+			} else {
+				++itr;
+			}
+		}
+		auto freeReg = std::find(busy.begin(), busy.end(), false);
+		if (freeReg != busy.end()) {
+			*freeReg = true;
+			location[static_cast<size_t>(cur.vreg)] =
+				pool[static_cast<size_t>(freeReg - busy.begin())];
+			active.push_back(cur);
+			continue;
+		}
+		auto victim = std::max_element(active.begin(), active.end(),
+			[](const Interval& a, const Interval& b){
+				return a.end < b.end;
+			});
+		if (victim->end > cur.end) {
+			location[static_cast<size_t>(cur.vreg)] =
+				location[static_cast<size_t>(victim->vreg)];
+			spill(victim->vreg);
+			*victim = cur;
+		} else {
+			spill(cur.vreg);
+		}
+	}
+}
+
+MipsOperand IRCodeGen::blockLabel(IRFunction& fn, int block){
+	return blockLabels[static_cast<size_t>(block)];
+}
+
+int IRCodeGen::frameOffset(int slot){
+	int saved = frame.saveRA ? 8 : 4;
+	return -(frame.stackFormalsSize + saved + slot * 4);
+}
+
+// The register holding vreg, loading it into scratch if spilled
+int IRCodeGen::useReg(int vreg, int scratch){
+	int reg = location[static_cast<size_t>(vreg)];
+	if (reg != MipsReg::NONE) { return reg; }
+	backend->generateIndexed(MipsOp::LW, scratch, LilC_Backend::FP,
+		frameOffset(spillSlot[static_cast<size_t>(vreg)]), "reload");
+	return scratch;
+}
+
+// The register to compute vreg into; finishDef stores it back
+// if vreg lives on the stack
+int IRCodeGen::defReg(int vreg){
+	int reg = location[static_cast<size_t>(vreg)];
+	return reg == MipsReg::NONE ? LilC_Backend::T0 : reg;
+}
+
+void IRCodeGen::finishDef(int vreg, int reg){
+	if (location[static_cast<size_t>(vreg)] != MipsReg::NONE) { return; }
+	backend->generateIndexed(MipsOp::SW, reg, LilC_Backend::FP,
+		frameOffset(spillSlot[static_cast<size_t>(vreg)]), "spill");
+}
+
+static MipsOp branchOp(IRCond cond){
+	switch (cond) {
+		case IROp::SEQ: return MipsOp::BEQ;
+		case IROp::SNE: return MipsOp::BNE;
+		case IROp::SLT: return MipsOp::BLT;
+		case IROp::SGT: return MipsOp::BGT;
+		case IROp::SLE: return MipsOp::BLE;
+		case IROp::SGE: return MipsOp::BGE;
+		default:
+			throw InternalError("Bad branch condition");
+	}
+}
+
+static IRCond invert(IRCond cond){
+	switch (cond) {
+		case IROp::SEQ: return IROp::SNE;
+		case IROp::SNE: return IROp::SEQ;
+		case IROp::SLT: return IROp::SGE;
+		case IROp::SGT: return IROp::SLE;
+		case IROp::SLE: return IROp::SGT;
+		case IROp::SGE: return IROp::SLT;
+		default:
+			throw InternalError("Bad branch condition");
+	}
+}
+
+void IRCodeGen::genInstr(
+	IRFunction& fn,
+	IRInstr& instr,
+	int pos,
+	IRBlock * next
+){
+	int a = MipsReg::NONE;
+	int b = MipsReg::NONE;
+	if (instr.src1 != IRInstr::NO_REG) {
+		a = useReg(instr.src1, LilC_Backend::T0);
+	}
+	if (instr.src2 != IRInstr::NO_REG) {
+		b = useReg(instr.src2, LilC_Backend::T1);
+	}
+	int r = MipsReg::NONE;
+	if (instr.dst != IRInstr::NO_REG && instr.op != IROp::CALL) {
+		r = defReg(instr.dst);
+	}
+	bool binary = instr.op >= IROp::MUL && instr.op <= IROp::SGE
+		&& instr.op != IROp::NEG && instr.op != IROp::NOT;
+	if (binary && b == MipsReg::NONE) {
+		backend->generateImm(MipsOp::LI, LilC_Backend::T1, instr.imm);
+		b = LilC_Backend::T1;
+	}
+
+	switch (instr.op) {
+	case IROp::LI:
+		backend->generateImm(MipsOp::LI, r, instr.imm);
+		break;
+	case IROp::LA_STR:
+		backend->genStringLitAddr(r, instr.str);
+		break;
+	case IROp::MOVE:
+		if (r != a) { backend->generate(MipsOp::MOVE, r, a); }
+		break;
+	case IROp::PARAM: {
+		// formal n is at -4n in the standard frame
+		int formal = instr.imm / -4;
+		if (formal < NUM_ARG_REGS) {
+			backend->generate(MipsOp::MOVE, r,
+				LilC_Backend::ARG_REGS[static_cast<size_t>(formal)]);
+		} else {
+			backend->genLoad(r, "", false, instr.imm + NUM_ARG_REGS * 4);
+		}
+		break;
+	}
+	case IROp::LOAD_GLOBAL:
+		backend->genLoad(r, instr.str, true, 0);
+		break;
+	case IROp::STORE_GLOBAL:
+		backend->genStore(a, instr.str, true, 0);
+		break;
+	case IROp::ADD:
+		if (b == MipsReg::NONE) {
+			backend->generateImm(MipsOp::ADDIU, r, a, instr.imm);
+		} else {
+			backend->generate(MipsOp::ADD, r, a, b);
+		}
+		break;
+	case IROp::SUB:
+		if (b == MipsReg::NONE) {
+			backend->generateImm(MipsOp::ADDIU, r, a, -instr.imm);
+		} else {
+			backend->generate(MipsOp::SUB, r, a, b);
+		}
+		break;
+	case IROp::SLL:
+	case IROp::SRL:
+	case IROp::SRA: {
+		if (b == MipsReg::NONE) {
+			MipsOp op = instr.op == IROp::SLL ? MipsOp::SLL
+				: instr.op == IROp::SRL ? MipsOp::SRL : MipsOp::SRA;
+			backend->generateImm(op, r, a, instr.imm);
+		} else {
+			MipsOp op = instr.op == IROp::SLL ? MipsOp::SLLV
+				: instr.op == IROp::SRL ? MipsOp::SRLV : MipsOp::SRAV;
+			backend->generate(op, r, a, b);
+		}
+		break;
+	}
+	case IROp::MUL:
+		backend->genMult(a, b, r);
+		break;
+	case IROp::DIV:
+		backend->genDiv(a, b, r);
+		break;
+	case IROp::NEG:
+		backend->generate(MipsOp::SUB, r, LilC_Backend::ZERO, a);
+		break;
+	case IROp::NOT:
+		backend->generateImm(MipsOp::XORI, r, a, 1);
+		break;
+	case IROp::SEQ:
+		backend->generate(MipsOp::XOR, r, a, b);
+		backend->generateImm(MipsOp::SLTIU, r, r, 1);
+		break;
+	case IROp::SNE:
+		backend->generate(MipsOp::XOR, r, a, b);
+		backend->generate(MipsOp::SLTU, r, LilC_Backend::ZERO, r);
+		break;
+	case IROp::SLT:
+		backend->generate(MipsOp::SLT, r, a, b);
+		break;
+	case IROp::SGT:
+		backend->generate(MipsOp::SLT, r, b, a);
+		break;
+	case IROp::SLE:
+		backend->generate(MipsOp::SLT, r, b, a);
+		backend->generateImm(MipsOp::XORI, r, r, 1);
+		break;
+	case IROp::SGE:
+		backend->generate(MipsOp::SLT, r, a, b);
+		backend->generateImm(MipsOp::XORI, r, r, 1);
+		break;
+	case IROp::CALL: {
+		// Registers whose values are needed after the call
+		std::vector<int> saved;
+		for (const Interval& iv : intervals) {
+			int reg = location[static_cast<size_t>(iv.vreg)];
+			if (iv.start < pos && iv.end > pos && reg != MipsReg::NONE) {
+				backend->genPush(reg);
+				saved.push_back(reg);
+			}
+		}
+		for (size_t i = 0; i < instr.args.size(); i++) {
+			int arg = useReg(instr.args[i], LilC_Backend::T0);
+			if (i < LilC_Backend::ARG_REGS.size()) {
+				backend->generate(MipsOp::MOVE, LilC_Backend::ARG_REGS[i], arg);
+			} else {
+				backend->genPush(arg);
+			}
+		}
+		backend->generateJump(MipsOp::JAL, backend->fnLabel(instr.str));
+		for (auto itr = saved.rbegin(); itr != saved.rend(); ++itr) {
+			backend->genPop(*itr);
+		}
+		r = defReg(instr.dst);
+		backend->generate(MipsOp::MOVE, r, LilC_Backend::V0);
+		break;
+	}
+	case IROp::WRITE_INT:
+		backend->genWrite(false, a);
+		break;
+	case IROp::WRITE_STR:
+		backend->genWrite(true, a);
+		break;
+	case IROp::READ_INT:
+		backend->generateImm(MipsOp::LI, LilC_Backend::V0, 5);
+		backend->generate(MipsOp::SYSCALL);
+		backend->generate(MipsOp::MOVE, r, LilC_Backend::V0);
+		break;
+	case IROp::JUMP:
+		if (next == nullptr || next->id != instr.target) {
+			backend->generateJump(MipsOp::J, blockLabel(fn, instr.target));
+		}
+		break;
+	case IROp::BRANCH: {
+		if (b == MipsReg::NONE) {
+			if (instr.imm == 0) {
+				b = LilC_Backend::ZERO;
+			} else {
+				backend->generateImm(MipsOp::LI, LilC_Backend::T1, instr.imm);
+				b = LilC_Backend::T1;
+			}
+		}
+		IRCond cond = instr.cond;
+		int taken = instr.target;
+		int fallthrough = instr.target2;
+		if (next != nullptr && next->id == taken) {
+			cond = invert(cond);
+			std::swap(taken, fallthrough);
+		}
+		backend->generateBranch(branchOp(cond), a, b, blockLabel(fn, taken));
+		if (next == nullptr || next->id != fallthrough) {
+			backend->generateJump(MipsOp::J, blockLabel(fn, fallthrough));
+		}
+		break;
+	}
+	case IROp::RET:
+		if (a != MipsReg::NONE && a != LilC_Backend::V0) {
+			backend->generate(MipsOp::MOVE, LilC_Backend::V0, a);
+		}
+		if (next != nullptr) {
+			backend->generateJump(MipsOp::J, exitLabel);
+		}
+		break;
+	default:
+		throw InternalError("Unknown IR opcode");
+	}
+
+	if (instr.dst != IRInstr::NO_REG) {
+		finishDef(instr.dst, r);
+	}
+}
+
+} // End namespace LILC
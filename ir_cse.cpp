@@ -0,0 +1,248 @@
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include "err.hpp"
+#include "ir.hpp"
+
+// Local value numbering. Registers can be assigned more than once
+// (promoted locals, formals), so a value number belongs to what a
+// register holds at a point in the block, and a register is only
+// reused for a value while it still holds it.
+
+namespace LILC{
+
+namespace {
+
+bool commutes(IROp op){
+	return op == IROp::ADD || op == IROp::MUL
+		|| op == IROp::SEQ || op == IROp::SNE;
+}
+
+class BlockNumbering {
+public:
+	// Value number the instructions of block, rewriting them in
+	// place; returns the number of computations replaced
+	int run(IRBlock& block){
+		int replaced = 0;
+		for (IRInstr& instr : block.instrs){
+			redirectUses(instr);
+			replaced += number(instr);
+		}
+		return replaced;
+	}
+
+private:
+	// (op, operand values, imm, name)
+	typedef std::tuple<int, int, int, int, std::string> Key;
+
+	int valueOf(int reg){
+		auto found = regValue.find(reg);
+		if (found != regValue.end()){ return found->second; }
+		int value = nextValue++;
+		define(reg, value);
+		return value;
+	}
+
+	void define(int reg, int value){
+		regValue[reg] = value;
+		if (!holds(value)){ leader[value] = reg; }
+	}
+
+	// Is the value's leader still holding it?
+	bool holds(int value){
+		auto found = leader.find(value);
+		return found != leader.end()
+			&& regValue[found->second] == value;
+	}
+
+	int constValue(int imm){
+		Key key(static_cast<int>(IROp::LI), -1, -1, imm, "");
+		auto found = table.find(key);
+		if (found != table.end()){ return found->second; }
+		int value = nextValue++;
+		table[key] = value;
+		return value;
+	}
+
+	void redirect(int& reg){
+		if (reg == IRInstr::NO_REG){ return; }
+		int value = valueOf(reg);
+		if (holds(value)){ reg = leader[value]; }
+	}
+
+	void redirectUses(IRInstr& instr){
+		redirect(instr.src1);
+		redirect(instr.src2);
+		for (int& arg : instr.args){ redirect(arg); }
+	}
+
+	Key keyOf(const IRInstr& instr){
+		IROp op = instr.op;
+		int a = instr.src1 == IRInstr::NO_REG ? -1 : valueOf(instr.src1);
+		int b = -1;
+		int imm = 0;
+		if (instr.src2 != IRInstr::NO_REG){
+			b = valueOf(instr.src2);
+		} else if (op >= IROp::ADD && op <= IROp::SGE
+			&& op != IROp::NEG && op != IROp::NOT){
+			b = constValue(instr.imm);
+		} else {
+			imm = instr.imm;
+		}
+		if (op == IROp::SGT || op == IROp::SGE){
+			op = op == IROp::SGT ? IROp::SLT : IROp::SLE;
+			std::swap(a, b);
+		} else if (commutes(op) && b < a){
+			std::swap(a, b);
+		}
+		if (op == IROp::LOAD_GLOBAL){ return loadKey(instr.str); }
+		std::string name = op == IROp::LA_STR ? instr.str : "";
+		return Key(static_cast<int>(op), a, b, imm, name);
+	}
+
+	// A load sees the global as of the last store to it or call
+	Key loadKey(const std::string& global){
+		return Key(static_cast<int>(IROp::LOAD_GLOBAL), calls,
+			-1, globalVersion[global], global);
+	}
+
+	int number(IRInstr& instr){
+		if (instr.op == IROp::STORE_GLOBAL){
+			globalVersion[instr.str]++;
+			table[loadKey(instr.str)] = valueOf(instr.src1);
+			return 0;
+		}
+		if (instr.op == IROp::CALL){
+			calls++;
+		}
+		if (instr.dst == IRInstr::NO_REG){ return 0; }
+		if (instr.op == IROp::MOVE){
+			define(instr.dst, valueOf(instr.src1));
+			return 0;
+		}
+		if (!instr.isPure()){
+			define(instr.dst, nextValue++);
+			return 0;
+		}
+
+		Key key = keyOf(instr);
+		auto found = table.find(key);
+		if (found == table.end()){
+			int value = nextValue++;
+			table[key] = value;
+			regValue[instr.dst] = value;
+			leader[value] = instr.dst;
+			return 0;
+		}
+		int value = found->second;
+		bool reuse = holds(value) && leader[value] != instr.dst
+			&& instr.op != IROp::LI;
+		if (reuse){
+			IRInstr move(IROp::MOVE);
+			move.dst = instr.dst;
+			move.src1 = leader[value];
+			instr = move;
+		}
+		define(instr.dst, value);
+		return reuse ? 1 : 0;
+	}
+
+	std::map<Key, int> table;
+	std::unordered_map<int, int> regValue;
+	// The first register to hold each value
+	std::unordered_map<int, int> leader;
+	std::unordered_map<std::string, int> globalVersion;
+	int calls = 0;
+	int nextValue = 0;
+};
+
+} // end anonymous namespace
+
+int IRValueNumbering::run(IRModule& module){
+	int changed = 0;
+	for (IRFunction * fn : module.functions){
+		changed += numberFunction(*fn);
+		changed += removeDeadDefs(*fn);
+	}
+	return changed;
+}
+
+/*
+* A block with a single predecessor starts from the values its
+* predecessor ended with, so runs of blocks such as the two sides
+* of an && share their work.
+*/
+int IRValueNumbering::numberFunction(IRFunction& fn){
+	std::vector<int> preds(static_cast<size_t>(fn.numBlocks), 0);
+	std::vector<int> onlyPred(static_cast<size_t>(fn.numBlocks), -1);
+	for (size_t i = 0; i < fn.blocks.size(); i++){
+		IRBlock * block = fn.blocks[i];
+		std::vector<int> succs;
+		block->successors(succs);
+		if (i + 1 < fn.blocks.size() && (block->instrs.empty()
+			|| !block->instrs.back().isTerminator())){
+			succs.push_back(fn.blocks[i + 1]->id);
+		}
+		for (int succ : succs){
+			preds[static_cast<size_t>(succ)]++;
+			onlyPred[static_cast<size_t>(succ)] = block->id;
+		}
+	}
+
+	int changed = 0;
+	std::unordered_map<int, BlockNumbering> ends;
+	for (IRBlock * block : fn.blocks){
+		size_t id = static_cast<size_t>(block->id);
+		BlockNumbering numbering;
+		auto pred = ends.find(onlyPred[id]);
+		if (preds[id] == 1 && pred != ends.end()){
+			numbering = pred->second;
+		}
+		changed += numbering.run(*block);
+		std::vector<int> succs;
+		block->successors(succs);
+		for (int succ : succs){
+			if (preds[static_cast<size_t>(succ)] == 1){
+				ends[block->id] = numbering;
+			}
+		}
+	}
+	return changed;
+}
+
+int IRValueNumbering::removeDeadDefs(IRFunction& fn){
+	int removed = 0;
+	bool changed = true;
+	while (changed){
+		changed = false;
+		std::vector<int> uses(static_cast<size_t>(fn.numVRegs), 0);
+		for (IRBlock * block : fn.blocks){
+			for (const IRInstr& instr : block->instrs){
+				std::vector<int> srcs;
+				instr.uses(srcs);
+				for (int src : srcs){ uses[static_cast<size_t>(src)]++; }
+			}
+		}
+		for (IRBlock * block : fn.blocks){
+			std::vector<IRInstr>& instrs = block->instrs;
+			size_t kept = 0;
+			for (size_t i = 0; i < instrs.size(); i++){
+				const IRInstr& instr = instrs[i];
+				bool dead = instr.isPure()
+					&& uses[static_cast<size_t>(instr.dst)] == 0;
+				if (dead){
+					changed = true;
+					removed++;
+					continue;
+				}
+				if (kept != i){ instrs[kept] = instrs[i]; }
+				kept++;
+			}
+			instrs.erase(instrs.begin() + static_cast<long>(kept),
+				instrs.end());
+		}
+	}
+	return removed;
+}
+
+} // End namespace LILC
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include "err.hpp"
+#include "ir.hpp"
+
+// Inlining on the IR. A call is replaced by a renamed copy of the
+// callee's blocks: the callee's virtual registers and blocks get
+// fresh numbers in the caller, PARAMs read the argument registers,
+// and each RET becomes a move into the call's destination and a
+// jump to the rest of the calling block.
+
+namespace LILC{
+
+namespace {
+
+/*
+* Tarjan's strongly connected components over the call graph.
+* Components come out callees first, which is the order to inline
+* in; a function is recursive if its component has more than one
+* member or it calls itself.
+*/
+class CallGraph {
+public:
+	CallGraph(std::unordered_map<std::string, IRFunction *>& byNameIn)
+	: byName(byNameIn){ }
+
+	void visit(IRFunction * fn){
+		if (index.count(fn->name) == 0){ strongConnect(fn); }
+	}
+
+	std::vector<IRFunction *> order;
+	std::unordered_map<std::string, bool> recursive;
+
+private:
+	void strongConnect(IRFunction * fn){
+		int myIndex = nextIndex++;
+		index[fn->name] = myIndex;
+		lowLink[fn->name] = myIndex;
+		stack.push_back(fn);
+		onStack[fn->name] = true;
+		bool callsSelf = false;
+
+		for (IRBlock * block : fn->blocks){
+			for (const IRInstr& instr : block->instrs){
+				if (instr.op != IROp::CALL){ continue; }
+				auto callee = byName.find(instr.str);
+				if (callee == byName.end()){ continue; }
+				IRFunction * to = callee->second;
+				if (to == fn){ callsSelf = true; }
+				if (index.count(to->name) == 0){
+					strongConnect(to);
+					lowLink[fn->name] = std::min(lowLink[fn->name],
+						lowLink[to->name]);
+				} else if (onStack[to->name]){
+					lowLink[fn->name] = std::min(lowLink[fn->name],
+						index[to->name]);
+				}
+			}
+		}
+
+		if (lowLink[fn->name] != myIndex){ return; }
+		std::vector<IRFunction *> component;
+		IRFunction * member;
+		do {
+			member = stack.back();
+			stack.pop_back();
+			onStack[member->name] = false;
+			component.push_back(member);
+		} while (member != fn);
+		for (IRFunction * f : component){
+			recursive[f->name] = component.size() > 1 || callsSelf;
+			order.push_back(f);
+		}
+	}
+
+	std::unordered_map<std::string, IRFunction *>& byName;
+	std::unordered_map<std::string, int> index;
+	std::unordered_map<std::string, int> lowLink;
+	std::unordered_map<std::string, bool> onStack;
+	std::vector<IRFunction *> stack;
+	int nextIndex = 0;
+};
+
+size_t sizeOf(const IRFunction& fn){
+	size_t size = 0;
+	for (IRBlock * block : fn.blocks){ size += block->instrs.size(); }
+	return size;
+}
+
+} // end anonymous namespace
+
+void IRInliner::findRecursion(IRModule& module){
+	byName.clear();
+	for (IRFunction * fn : module.functions){ byName[fn->name] = fn; }
+	CallGraph graph(byName);
+	for (IRFunction * fn : module.functions){ graph.visit(fn); }
+	order = graph.order;
+	recursive = graph.recursive;
+}
+
+bool IRInliner::inlinable(IRFunction * caller, const IRInstr& call){
+	auto callee = byName.find(call.str);
+	if (callee == byName.end()){ return false; }
+	IRFunction * fn = callee->second;
+	return fn != caller && fn->name != "main" && !recursive[fn->name]
+		&& sizeOf(*fn) <= static_cast<size_t>(limit);
+}
+
+int IRInliner::run(IRModule& module){
+	findRecursion(module);
+	int inlined = 0;
+	for (IRFunction * fn : order){
+		// Blocks are inserted behind the one being scanned; the
+		// callee copies need no second look, since the callee's
+		// own inlinable calls were inlined before it was copied
+		for (size_t b = 0; b < fn->blocks.size(); b++){
+			std::vector<IRInstr>& instrs = fn->blocks[b]->instrs;
+			for (size_t i = 0; i < instrs.size(); i++){
+				if (instrs[i].op != IROp::CALL){ continue; }
+				if (!inlinable(fn, instrs[i])){ continue; }
+				const IRFunction& callee = *byName[instrs[i].str];
+				inlineCall(*fn, b, i, callee);
+				inlined++;
+				// The rest of this block moved to the
+				// continuation, placed after the callee's blocks
+				b += callee.blocks.size();
+				break;
+			}
+		}
+	}
+	return inlined;
+}
+
+void IRInliner::inlineCall(
+	IRFunction& caller,
+	size_t blockIndex,
+	size_t instrIndex,
+	const IRFunction& callee
+){
+	IRBlock * block = caller.blocks[blockIndex];
+	IRInstr call = block->instrs[instrIndex];
+
+	// A formal the callee never assigns can read the argument's
+	// register directly; the others get a copy of it
+	std::vector<int> defs(static_cast<size_t>(callee.numVRegs), 0);
+	for (IRBlock * calleeBlock : callee.blocks){
+		for (const IRInstr& instr : calleeBlock->instrs){
+			if (instr.dst != IRInstr::NO_REG){
+				defs[static_cast<size_t>(instr.dst)]++;
+			}
+		}
+	}
+	std::vector<int> regMap(static_cast<size_t>(callee.numVRegs));
+	for (size_t v = 0; v < regMap.size(); v++){
+		regMap[v] = caller.newVReg();
+	}
+	for (IRBlock * calleeBlock : callee.blocks){
+		for (const IRInstr& instr : calleeBlock->instrs){
+			if (instr.op != IROp::PARAM){ continue; }
+			size_t formal = static_cast<size_t>(-instr.imm) / 4;
+			if (defs[static_cast<size_t>(instr.dst)] == 1){
+				regMap[static_cast<size_t>(instr.dst)] = call.args[formal];
+			}
+		}
+	}
+	auto rename = [&](int reg){
+		return reg == IRInstr::NO_REG
+			? reg : regMap[static_cast<size_t>(reg)];
+	};
+
+	std::vector<int> blockMap(static_cast<size_t>(callee.numBlocks), -1);
+	std::vector<IRBlock *> copies;
+	for (IRBlock * calleeBlock : callee.blocks){
+		IRBlock * copy = caller.newBlock();
+		blockMap[static_cast<size_t>(calleeBlock->id)] = copy->id;
+		copies.push_back(copy);
+	}
+	IRBlock * cont = caller.newBlock();
+	cont->instrs.assign(block->instrs.begin()
+		+ static_cast<long>(instrIndex) + 1, block->instrs.end());
+	block->instrs.erase(block->instrs.begin()
+		+ static_cast<long>(instrIndex), block->instrs.end());
+	IRInstr enter(IROp::JUMP);
+	enter.target = copies.front()->id;
+	block->instrs.push_back(enter);
+
+	for (size_t b = 0; b < callee.blocks.size(); b++){
+		std::vector<IRInstr>& out = copies[b]->instrs;
+		for (const IRInstr& instr : callee.blocks[b]->instrs){
+			if (instr.op == IROp::PARAM){
+				int dst = rename(instr.dst);
+				int arg = call.args[static_cast<size_t>(-instr.imm) / 4];
+				if (dst != arg){
+					IRInstr move(IROp::MOVE);
+					move.dst = dst;
+					move.src1 = arg;
+					out.push_back(move);
+				}
+				continue;
+			}
+			if (instr.op == IROp::RET){
+				// A bare return leaves the result undefined, as
+				// the call would (only void calls are read-free)
+				if (instr.src1 != IRInstr::NO_REG){
+					IRInstr move(IROp::MOVE);
+					move.dst = call.dst;
+					move.src1 = rename(instr.src1);
+					out.push_back(move);
+				}
+				IRInstr exit(IROp::JUMP);
+				exit.target = cont->id;
+				out.push_back(exit);
+				continue;
+			}
+			IRInstr copy = instr;
+			copy.dst = rename(instr.dst);
+			copy.src1 = rename(instr.src1);
+			copy.src2 = rename(instr.src2);
+			for (int& arg : copy.args){ arg = rename(arg); }
+			if (copy.target >= 0){
+				copy.target = blockMap[static_cast<size_t>(copy.target)];
+			}
+			if (copy.target2 >= 0){
+				copy.target2 = blockMap[static_cast<size_t>(copy.target2)];
+			}
+			out.push_back(copy);
+		}
+	}
+
+	copies.push_back(cont);
+	caller.blocks.insert(caller.blocks.begin()
+		+ static_cast<long>(blockIndex) + 1, copies.begin(), copies.end());
+}
+
+} // End namespace LILC
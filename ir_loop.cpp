@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include "err.hpp"
+#include "ir.hpp"
+
+// Loop-invariant code motion and induction variable strength
+// reduction. A pure instruction inside a loop is invariant when
+// each operand is either never assigned in the loop or set by
+// another invariant instruction; if it is also the only assignment
+// of its register in the function, it moves to the preheader.
+// Loads of a global the loop neither stores to nor can change
+// through a call are invariant too. None of these can trap, so
+// running one on a path that would not have run it is harmless.
+//
+// A basic induction variable is a register whose only assignment
+// in the loop adds a constant to itself. Each multiply of one by a
+// constant then reads a register that starts at the product in the
+// preheader and takes its own constant step after every update.
+
+namespace LILC{
+
+namespace {
+
+class LoopOptimizer {
+public:
+	LoopOptimizer(IRFunction& fnIn) : fn(fnIn){ }
+
+	int run(){
+		int changed = 0;
+		std::set<int> done;
+		for (;;){
+			analyze();
+			// The innermost loop not yet visited. Headers are
+			// remembered by block id, since preheaders shift the
+			// layout.
+			int header = -1;
+			for (auto& loop : loops){
+				if (done.count(fn.blocks[static_cast<size_t>(loop.first)]->id)
+					!= 0){
+					continue;
+				}
+				if (header < 0 || loop.second.size()
+					< loops[header].size()){
+					header = loop.first;
+				}
+			}
+			if (header < 0){ return changed; }
+			done.insert(fn.blocks[static_cast<size_t>(header)]->id);
+			changed += optimize(header, loops[header]);
+		}
+	}
+
+private:
+	// CFG edges by layout index, including fallthrough
+	void analyze(){
+		size_t n = fn.blocks.size();
+		std::vector<int> layoutIndex(static_cast<size_t>(fn.numBlocks), -1);
+		for (size_t i = 0; i < n; i++){
+			layoutIndex[static_cast<size_t>(fn.blocks[i]->id)]
+				= static_cast<int>(i);
+		}
+		succs.assign(n, std::vector<size_t>());
+		preds.assign(n, std::vector<size_t>());
+		for (size_t i = 0; i < n; i++){
+			IRBlock * block = fn.blocks[i];
+			std::vector<int> ids;
+			block->successors(ids);
+			for (int id : ids){
+				succs[i].push_back(static_cast<size_t>(
+					layoutIndex[static_cast<size_t>(id)]));
+			}
+			if (i + 1 < n && (block->instrs.empty()
+				|| !block->instrs.back().isTerminator())){
+				succs[i].push_back(i + 1);
+			}
+			for (size_t s : succs[i]){ preds[s].push_back(i); }
+		}
+		findDominators();
+
+		loops.clear();
+		// The entry holds the PARAMs, which must not be repeated,
+		// and the lowering never branches back to it
+		for (size_t t = 0; t < n; t++){
+			for (size_t h : succs[t]){
+				if (h != 0 && dominates(h, t)){ addLoop(h, t); }
+			}
+		}
+	}
+
+	// Immediate dominators, by the Cooper-Harvey-Kennedy method
+	void findDominators(){
+		size_t n = fn.blocks.size();
+		std::vector<size_t> order;
+		std::vector<bool> seen(n, false);
+		std::vector<std::pair<size_t, size_t>> stack = {{0, 0}};
+		seen[0] = true;
+		while (!stack.empty()){
+			size_t b = stack.back().first;
+			size_t next = stack.back().second++;
+			if (next < succs[b].size()){
+				size_t s = succs[b][next];
+				if (!seen[s]){
+					seen[s] = true;
+					stack.push_back({s, 0});
+				}
+				continue;
+			}
+			order.push_back(b);
+			stack.pop_back();
+		}
+		std::reverse(order.begin(), order.end());
+		rpoIndex.assign(n, static_cast<size_t>(NONE));
+		for (size_t i = 0; i < order.size(); i++){ rpoIndex[order[i]] = i; }
+
+		idom.assign(n, static_cast<size_t>(NONE));
+		idom[0] = 0;
+		bool changed = true;
+		while (changed){
+			changed = false;
+			for (size_t i = 1; i < order.size(); i++){
+				size_t b = order[i];
+				size_t newIdom = NONE;
+				for (size_t p : preds[b]){
+					if (idom[p] == NONE){ continue; }
+					newIdom = newIdom == NONE ? p : intersect(p, newIdom);
+				}
+				if (newIdom != idom[b]){
+					idom[b] = newIdom;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	size_t intersect(size_t a, size_t b){
+		while (a != b){
+			while (rpoIndex[a] > rpoIndex[b]){ a = idom[a]; }
+			while (rpoIndex[b] > rpoIndex[a]){ b = idom[b]; }
+		}
+		return a;
+	}
+
+	bool dominates(size_t a, size_t b){
+		if (idom[b] == NONE){ return false; }
+		while (b != a && b != 0){ b = idom[b]; }
+		return b == a;
+	}
+
+	// The natural loop of the back edge tail -> header
+	void addLoop(size_t header, size_t tail){
+		std::vector<size_t>& body = loops[static_cast<int>(header)];
+		std::vector<bool> in(fn.blocks.size(), false);
+		for (size_t b : body){ in[b] = true; }
+		if (!in[header]){
+			in[header] = true;
+			body.push_back(header);
+		}
+		std::vector<size_t> work = {tail};
+		while (!work.empty()){
+			size_t b = work.back();
+			work.pop_back();
+			if (in[b]){ continue; }
+			in[b] = true;
+			body.push_back(b);
+			for (size_t p : preds[b]){ work.push_back(p); }
+		}
+	}
+
+	// Where hoisted code goes: the single outside predecessor, if it
+	// leads only to the header, or else a new block before it
+	IRBlock * preheader(size_t header, const std::vector<bool>& in){
+		IRBlock * head = fn.blocks[header];
+		std::vector<size_t> outside;
+		for (size_t p : preds[header]){
+			if (!in[p]){ outside.push_back(p); }
+		}
+		if (outside.size() == 1 && succs[outside[0]].size() == 1){
+			return fn.blocks[outside[0]];
+		}
+		IRBlock * pre = fn.newBlock();
+		for (size_t p : outside){
+			IRBlock * block = fn.blocks[p];
+			if (block->instrs.empty()){ continue; }
+			IRInstr& last = block->instrs.back();
+			if (last.op != IROp::JUMP && last.op != IROp::BRANCH){
+				continue;
+			}
+			if (last.target == head->id){ last.target = pre->id; }
+			if (last.op == IROp::BRANCH && last.target2 == head->id){
+				last.target2 = pre->id;
+			}
+		}
+		// A loop block that ran into the header must now jump
+		if (header > 0 && in[header - 1]){
+			std::vector<IRInstr>& instrs = fn.blocks[header - 1]->instrs;
+			if (instrs.empty() || !instrs.back().isTerminator()){
+				IRInstr jump(IROp::JUMP);
+				jump.target = head->id;
+				instrs.push_back(jump);
+			}
+		}
+		IRInstr jump(IROp::JUMP);
+		jump.target = head->id;
+		pre->instrs.push_back(jump);
+		fn.blocks.insert(fn.blocks.begin() + static_cast<long>(header), pre);
+		return pre;
+	}
+
+	// Insert instr at the end of the preheader, before its
+	// terminator
+	void append(IRBlock * pre, const IRInstr& instr){
+		std::vector<IRInstr>& instrs = pre->instrs;
+		auto at = instrs.end();
+		if (!instrs.empty() && instrs.back().isTerminator()){ --at; }
+		instrs.insert(at, instr);
+	}
+
+	int optimize(int headerIn, std::vector<size_t> body){
+		size_t header = static_cast<size_t>(headerIn);
+		std::vector<bool> in(fn.blocks.size(), false);
+		for (size_t b : body){ in[b] = true; }
+		std::sort(body.begin(), body.end());
+
+		std::vector<int> defs(static_cast<size_t>(fn.numVRegs), 0);
+		std::vector<int> loopDefs(static_cast<size_t>(fn.numVRegs), 0);
+		for (size_t b = 0; b < fn.blocks.size(); b++){
+			for (const IRInstr& instr : fn.blocks[b]->instrs){
+				if (instr.dst == IRInstr::NO_REG){ continue; }
+				defs[static_cast<size_t>(instr.dst)]++;
+				if (in[b]){ loopDefs[static_cast<size_t>(instr.dst)]++; }
+			}
+		}
+		bool calls = false;
+		std::set<std::string> stored;
+		for (size_t b : body){
+			for (const IRInstr& instr : fn.blocks[b]->instrs){
+				if (instr.op == IROp::CALL){ calls = true; }
+				if (instr.op == IROp::STORE_GLOBAL){ stored.insert(instr.str); }
+			}
+		}
+
+		// Pick the invariant instructions, operands first
+		std::vector<bool> hoisted(static_cast<size_t>(fn.numVRegs), false);
+		auto invariant = [&](int reg){
+			return reg == IRInstr::NO_REG
+				|| loopDefs[static_cast<size_t>(reg)] == 0
+				|| hoisted[static_cast<size_t>(reg)];
+		};
+		std::vector<IRInstr> moved;
+		bool changed = true;
+		while (changed){
+			changed = false;
+			for (size_t b : body){
+				for (const IRInstr& instr : fn.blocks[b]->instrs){
+					if (!instr.isPure()
+						|| hoisted[static_cast<size_t>(instr.dst)]
+						|| defs[static_cast<size_t>(instr.dst)] != 1
+						|| !invariant(instr.src1) || !invariant(instr.src2)){
+						continue;
+					}
+					if (instr.op == IROp::LOAD_GLOBAL
+						&& (calls || stored.count(instr.str) != 0)){
+						continue;
+					}
+					hoisted[static_cast<size_t>(instr.dst)] = true;
+					moved.push_back(instr);
+					changed = true;
+				}
+			}
+		}
+		for (size_t b : body){
+			std::vector<IRInstr>& instrs = fn.blocks[b]->instrs;
+			instrs.erase(std::remove_if(instrs.begin(), instrs.end(),
+				[&](const IRInstr& instr){
+					return instr.dst != IRInstr::NO_REG && instr.isPure()
+						&& hoisted[static_cast<size_t>(instr.dst)];
+				}), instrs.end());
+		}
+
+		std::vector<IRInstr> reduced = reduce(body, loopDefs, defs, moved);
+		if (moved.empty() && reduced.empty()){ return 0; }
+		IRBlock * pre = preheader(header, in);
+		for (const IRInstr& instr : moved){ append(pre, instr); }
+		for (const IRInstr& instr : reduced){ append(pre, instr); }
+		return static_cast<int>(moved.size() + reduced.size());
+	}
+
+	// The constant a register always holds, if it has one
+	bool constant(int reg, int imm, const std::vector<int>& defs,
+		const std::vector<IRInstr>& moved, int& value){
+		if (reg == IRInstr::NO_REG){
+			value = imm;
+			return true;
+		}
+		if (defs[static_cast<size_t>(reg)] != 1){ return false; }
+		auto found = constants.find(reg);
+		if (found != constants.end()){
+			value = found->second;
+			return true;
+		}
+		for (const IRInstr& instr : moved){
+			if (instr.dst == reg && instr.op == IROp::LI){
+				value = instr.imm;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Strength-reduce multiplies of induction variables; returns
+	// the instructions that set up the new registers
+	std::vector<IRInstr> reduce(const std::vector<size_t>& body,
+		const std::vector<int>& loopDefs, const std::vector<int>& defs,
+		const std::vector<IRInstr>& moved){
+		constants.clear();
+		for (IRBlock * block : fn.blocks){
+			for (const IRInstr& instr : block->instrs){
+				if (instr.op == IROp::LI){ constants[instr.dst] = instr.imm; }
+			}
+		}
+
+		// Basic induction variables: reg -> (block, instr, step)
+		struct Update { size_t block; size_t instr; int step; };
+		std::unordered_map<int, Update> ivs;
+		std::unordered_map<int, const IRInstr *> single;
+		for (size_t b : body){
+			const std::vector<IRInstr>& instrs = fn.blocks[b]->instrs;
+			for (size_t i = 0; i < instrs.size(); i++){
+				if (instrs[i].dst != IRInstr::NO_REG){
+					single[instrs[i].dst] = &instrs[i];
+				}
+			}
+		}
+		auto stepOf = [&](const IRInstr& instr, int iv, int& step){
+			if (instr.op != IROp::ADD && instr.op != IROp::SUB){ return false; }
+			if (instr.src1 != iv){ return false; }
+			if (!constant(instr.src2, instr.imm, defs, moved, step)){
+				return false;
+			}
+			if (instr.op == IROp::SUB){
+				step = static_cast<int>(0u - static_cast<unsigned int>(step));
+			}
+			return true;
+		};
+		for (size_t b : body){
+			const std::vector<IRInstr>& instrs = fn.blocks[b]->instrs;
+			for (size_t i = 0; i < instrs.size(); i++){
+				const IRInstr& instr = instrs[i];
+				int iv = instr.dst;
+				if (iv == IRInstr::NO_REG
+					|| loopDefs[static_cast<size_t>(iv)] != 1){
+					continue;
+				}
+				int step;
+				const IRInstr * update = &instr;
+				// iv = move t, t = add iv, c; t may have been hoisted
+				if (instr.op == IROp::MOVE && instr.src1 != iv
+					&& defs[static_cast<size_t>(instr.src1)] == 1
+					&& single.count(instr.src1) != 0){
+					update = single[instr.src1];
+				}
+				if (stepOf(*update, iv, step)){
+					ivs[iv] = Update{b, i, step};
+				}
+			}
+		}
+
+		std::vector<IRInstr> setup;
+		// (block, position) -> steps to add after it
+		std::map<std::pair<size_t, size_t>, std::vector<IRInstr>> steps;
+		for (size_t b : body){
+			for (IRInstr& instr : fn.blocks[b]->instrs){
+				if (instr.op != IROp::MUL
+					|| defs[static_cast<size_t>(instr.dst)] != 1){
+					continue;
+				}
+				int iv = instr.src1;
+				int other = instr.src2;
+				int k;
+				if (ivs.count(iv) == 0 || !constant(other, instr.imm, defs, moved, k)){
+					std::swap(iv, other);
+					if (other == IRInstr::NO_REG || ivs.count(iv) == 0
+						|| !constant(other, instr.imm, defs, moved, k)){
+						continue;
+					}
+				}
+				const Update& update = ivs[iv];
+				int reg = fn.newVReg();
+				IRInstr init(IROp::MUL);
+				init.dst = reg;
+				init.src1 = iv;
+				init.imm = k;
+				setup.push_back(init);
+
+				IRInstr step(IROp::ADD);
+				step.dst = reg;
+				step.src1 = reg;
+				step.imm = static_cast<int>(static_cast<unsigned int>(update.step)
+					* static_cast<unsigned int>(k));
+				steps[{update.block, update.instr}].push_back(step);
+
+				IRInstr move(IROp::MOVE);
+				move.dst = instr.dst;
+				move.src1 = reg;
+				instr = move;
+			}
+		}
+		// Insert back to front so the recorded positions stay valid
+		for (auto itr = steps.rbegin(); itr != steps.rend(); ++itr){
+			std::vector<IRInstr>& instrs = fn.blocks[itr->first.first]->instrs;
+			instrs.insert(instrs.begin() + static_cast<long>(itr->first.second) + 1,
+				itr->second.begin(), itr->second.end());
+		}
+		return setup;
+	}
+
+	static const size_t NONE = static_cast<size_t>(-1);
+
+	IRFunction& fn;
+	std::vector<std::vector<size_t>> succs;
+	std::vector<std::vector<size_t>> preds;
+	std::vector<size_t> idom;
+	std::vector<size_t> rpoIndex;
+	// header -> blocks of its loop, by layout index
+	std::map<int, std::vector<size_t>> loops;
+	std::unordered_map<int, int> constants;
+};
+
+} // end anonymous namespace
+
+int IRLoopOpt::run(IRModule& module){
+	int changed = 0;
+	for (IRFunction * fn : module.functions){
+		changed += optimize(*fn);
+	}
+	return changed;
+}
+
+int IRLoopOpt::optimize(IRFunction& fn){
+	return LoopOptimizer(fn).run();
+}
+
+} // End namespace LILC
@@ -0,0 +1,452 @@
+#include "err.hpp"
+#include "ast.hpp"
+#include "ast_visitor.hpp"
+#include "symbol_table.hpp"
+#include "ir.hpp"
+
+// Lowering from the AST to the three-address IR (-fir). Locals
+// and formals live in virtual registers for their whole lifetime;
+// globals are loaded and stored around each use.
+//
+// Each way of lowering an expression is its own visitor:
+// LowerValue computes it into a virtual register, LowerStore
+// stores a register to it and LowerCond branches on it.
+// LowerStmts lowers a function body's statements.
+
+namespace LILC{
+
+namespace {
+
+// Emit code computing an expression and return the virtual
+// register holding the result
+class LowerValue : public ASTVisitor<LowerValue, int>{
+public:
+	explicit LowerValue(IRBuilder& builderIn) : builder(builderIn){ }
+
+	int visitNode(ASTNode *){
+		throw InternalError("LowerValue: not an expression");
+	}
+
+	int visitIntLit(IntLitNode * node){
+		return builder.emitLI(node->getValue());
+	}
+
+	int visitStrLit(StrLitNode * node){
+		IRInstr instr(IROp::LA_STR);
+		instr.dst = builder.newVReg();
+		instr.str = node->getString();
+		return builder.emit(instr).dst;
+	}
+
+	int visitTrue(TrueNode *){ return builder.emitLI(1); }
+	int visitFalse(FalseNode *){ return builder.emitLI(0); }
+
+	int visitId(IdNode * node){
+		if (!node->getSymbol()->isGlobal()) {
+			return builder.varReg(node->getSymbol());
+		}
+		IRInstr instr(IROp::LOAD_GLOBAL);
+		instr.dst = builder.newVReg();
+		instr.str = node->getString();
+		return builder.emit(instr).dst;
+	}
+
+	int visitAssign(AssignNode * node);
+	int visitCallExp(CallExpNode * node);
+
+	int visitUnaryMinus(UnaryMinusNode * node){
+		return unary(IROp::NEG, node);
+	}
+
+	int visitNot(NotNode * node){ return unary(IROp::NOT, node); }
+
+	int visitShiftLeft(ShiftLeftNode * node){
+		IRInstr instr(IROp::SLL);
+		instr.src1 = visit(node->getExp());
+		instr.imm = node->getBits();
+		instr.dst = builder.newVReg();
+		return builder.emit(instr).dst;
+	}
+
+	int visitShiftRight(ShiftRightNode * node);
+
+	int visitPlus(PlusNode * node){ return binary(IROp::ADD, node); }
+	int visitMinus(MinusNode * node){ return binary(IROp::SUB, node); }
+	int visitTimes(TimesNode * node){ return binary(IROp::MUL, node); }
+	int visitDivide(DivideNode * node){ return binary(IROp::DIV, node); }
+	int visitEquals(EqualsNode * node){ return binary(IROp::SEQ, node); }
+	int visitNotEquals(NotEqualsNode * node){
+		return binary(IROp::SNE, node);
+	}
+	int visitLess(LessNode * node){ return binary(IROp::SLT, node); }
+	int visitGreater(GreaterNode * node){
+		return binary(IROp::SGT, node);
+	}
+	int visitLessEq(LessEqNode * node){ return binary(IROp::SLE, node); }
+	int visitGreaterEq(GreaterEqNode * node){
+		return binary(IROp::SGE, node);
+	}
+
+	int visitAnd(AndNode * node){ return logical(node, false); }
+	int visitOr(OrNode * node){ return logical(node, true); }
+
+private:
+	int unary(IROp op, UnaryExpNode * node){
+		IRInstr instr(op);
+		instr.src1 = visit(node->getExp());
+		instr.dst = builder.newVReg();
+		return builder.emit(instr).dst;
+	}
+
+	int binary(IROp op, BinaryExpNode * node);
+	int logical(BinaryExpNode * node, bool isOr);
+
+	IRBuilder& builder;
+};
+
+// Emit code storing virtual register reg to an lvalue
+class LowerStore : public ASTVisitor<LowerStore>{
+public:
+	LowerStore(IRBuilder& builderIn, int regIn)
+	: builder(builderIn), reg(regIn){ }
+
+	void visitNode(ASTNode *){
+		throw InternalError("LowerStore: not an lvalue");
+	}
+
+	void visitId(IdNode * node){
+		if (!node->getSymbol()->isGlobal()) {
+			builder.emitMoveTo(builder.varReg(node->getSymbol()), reg);
+			return;
+		}
+		IRInstr instr(IROp::STORE_GLOBAL);
+		instr.src1 = reg;
+		instr.str = node->getString();
+		builder.emit(instr);
+	}
+
+private:
+	IRBuilder& builder;
+	int reg;
+};
+
+// Emit a branch to ifTrue or ifFalse on a bool expression
+class LowerCond : public ASTVisitor<LowerCond>{
+public:
+	LowerCond(IRBuilder& builderIn, IRBlock * ifTrueIn, IRBlock * ifFalseIn)
+	: builder(builderIn), ifTrue(ifTrueIn), ifFalse(ifFalseIn){ }
+
+	void visitExp(ExpNode * node){
+		int reg = LowerValue(builder).visit(node);
+		builder.emitBranch(IROp::SNE, reg, IRInstr::NO_REG, ifTrue, ifFalse);
+	}
+
+	void visitTrue(TrueNode *){ builder.emitJump(ifTrue); }
+	void visitFalse(FalseNode *){ builder.emitJump(ifFalse); }
+
+	void visitNot(NotNode * node){
+		LowerCond(builder, ifFalse, ifTrue).visit(node->getExp());
+	}
+
+	void visitAnd(AndNode * node){
+		IRBlock * rhs = builder.newBlock();
+		LowerCond(builder, rhs, ifFalse).visit(node->getExp1());
+		builder.setBlock(rhs);
+		visit(node->getExp2());
+	}
+
+	void visitOr(OrNode * node){
+		IRBlock * rhs = builder.newBlock();
+		LowerCond(builder, ifTrue, rhs).visit(node->getExp1());
+		builder.setBlock(rhs);
+		visit(node->getExp2());
+	}
+
+	void visitEquals(EqualsNode * node){ compare(IROp::SEQ, node); }
+	void visitNotEquals(NotEqualsNode * node){
+		compare(IROp::SNE, node);
+	}
+	void visitLess(LessNode * node){ compare(IROp::SLT, node); }
+	void visitGreater(GreaterNode * node){ compare(IROp::SGT, node); }
+	void visitLessEq(LessEqNode * node){ compare(IROp::SLE, node); }
+	void visitGreaterEq(GreaterEqNode * node){
+		compare(IROp::SGE, node);
+	}
+
+private:
+	void compare(IRCond cond, BinaryExpNode * node);
+
+	IRBuilder& builder;
+	IRBlock * ifTrue;
+	IRBlock * ifFalse;
+};
+
+// Lower the statements of a function body
+class LowerStmts : public ASTVisitor<LowerStmts>{
+public:
+	explicit LowerStmts(IRBuilder& builderIn) : builder(builderIn){ }
+
+	void visitNode(ASTNode *){
+		throw InternalError("LowerStmts: not a statement");
+	}
+
+	void visitFnBody(FnBodyNode * node){ visit(node->getStmtList()); }
+
+	void visitStmtList(StmtListNode * node){
+		for (StmtNode * stmt : node->getStmts()) {
+			visit(stmt);
+		}
+	}
+
+	void visitAssignStmt(AssignStmtNode * node){
+		value(node->getAssign());
+	}
+
+	void visitPostIncStmt(PostIncStmtNode * node){
+		increment(node->getExp(), 1);
+	}
+
+	void visitPostDecStmt(PostDecStmtNode * node){
+		increment(node->getExp(), -1);
+	}
+
+	void visitReadStmt(ReadStmtNode * node){
+		IRInstr instr(IROp::READ_INT);
+		instr.dst = builder.newVReg();
+		store(node->getExp(), builder.emit(instr).dst);
+	}
+
+	void visitWriteStmt(WriteStmtNode * node){
+		IROp op = node->getTypeToWrite() == LilC_Type::stringType() ?
+			IROp::WRITE_STR : IROp::WRITE_INT;
+		IRInstr instr(op);
+		instr.src1 = value(node->getExp());
+		builder.emit(instr);
+	}
+
+	void visitIfStmt(IfStmtNode * node);
+	void visitIfElseStmt(IfElseStmtNode * node);
+	void visitWhileStmt(WhileStmtNode * node);
+
+	void visitCallStmt(CallStmtNode * node){
+		value(node->getCallExp());
+	}
+
+	void visitReturnStmt(ReturnStmtNode * node){
+		IRInstr instr(IROp::RET);
+		if (node->getExp() != nullptr) {
+			instr.src1 = value(node->getExp());
+		}
+		builder.emit(instr);
+	}
+
+private:
+	int value(ExpNode * exp){ return LowerValue(builder).visit(exp); }
+	void store(ExpNode * exp, int reg){
+		LowerStore(builder, reg).visit(exp);
+	}
+	void cond(ExpNode * exp, IRBlock * ifTrue, IRBlock * ifFalse){
+		LowerCond(builder, ifTrue, ifFalse).visit(exp);
+	}
+	void increment(ExpNode * exp, int delta);
+
+	IRBuilder& builder;
+};
+
+int LowerValue::visitAssign(AssignNode * node){
+	int reg = visit(node->getRHS());
+	LowerStore(builder, reg).visit(node->getLHS());
+	return reg;
+}
+
+/*
+* A local's value is read straight out of its home register, so
+* if something evaluated later may assign to it, take a copy
+* first to keep left-to-right semantics.
+*/
+int LowerValue::visitCallExp(CallExpNode * node){
+	NodeList<ExpNode *> * exps = node->getExpList()->getExps();
+	IRInstr call(IROp::CALL);
+	for (auto itr = exps->begin(); itr != exps->end(); ++itr) {
+		int reg = visit(*itr);
+		bool laterEffects = false;
+		for (auto next = std::next(itr); next != exps->end(); ++next) {
+			laterEffects = laterEffects || (*next)->hasSideEffects();
+		}
+		if (laterEffects && builder.isVarReg(reg)) {
+			reg = builder.emitMove(reg);
+		}
+		call.args.push_back(reg);
+	}
+	call.dst = builder.newVReg();
+	call.str = node->getId()->getString();
+	return builder.emit(call).dst;
+}
+
+// Same sequence as LilC_Backend::genDivPow2
+int LowerValue::visitShiftRight(ShiftRightNode * node){
+	int bits = node->getBits();
+	int value = visit(node->getExp());
+	IRInstr sign(IROp::SRA);
+	sign.src1 = value;
+	sign.imm = 31;
+	sign.dst = builder.newVReg();
+	IRInstr bias(IROp::SRL);
+	bias.src1 = builder.emit(sign).dst;
+	bias.imm = 32 - bits;
+	bias.dst = builder.newVReg();
+	int biased = builder.emitBinary(IROp::ADD, value,
+		builder.emit(bias).dst);
+	IRInstr shift(IROp::SRA);
+	shift.src1 = biased;
+	shift.imm = bits;
+	shift.dst = builder.newVReg();
+	return builder.emit(shift).dst;
+}
+
+int LowerValue::binary(IROp op, BinaryExpNode * node){
+	int reg1 = visit(node->getExp1());
+	if (node->getExp2()->hasSideEffects() && builder.isVarReg(reg1)) {
+		reg1 = builder.emitMove(reg1);
+	}
+	int reg2 = visit(node->getExp2());
+	return builder.emitBinary(op, reg1, reg2);
+}
+
+// && and || as values: the right operand only runs if the left
+// one doesn't already decide the result
+int LowerValue::logical(BinaryExpNode * node, bool isOr){
+	int result = builder.newVReg();
+	builder.emitMoveTo(result, visit(node->getExp1()));
+	IRBlock * rhs = builder.newBlock();
+	IRBlock * done = builder.newBlock();
+	builder.emitBranch(IROp::SNE, result, IRInstr::NO_REG,
+		isOr ? done : rhs, isOr ? rhs : done);
+	builder.setBlock(rhs);
+	builder.emitMoveTo(result, visit(node->getExp2()));
+	builder.emitJump(done);
+	builder.setBlock(done);
+	return result;
+}
+
+// Compare the operands directly in the branch; a literal right
+// operand becomes the branch's immediate
+void LowerCond::compare(IRCond cond, BinaryExpNode * node){
+	int value;
+	int reg1 = LowerValue(builder).visit(node->getExp1());
+	if (node->getExp2()->constValue(value)) {
+		IRInstr branch(IROp::BRANCH);
+		branch.cond = cond;
+		branch.src1 = reg1;
+		branch.imm = value;
+		branch.target = ifTrue->id;
+		branch.target2 = ifFalse->id;
+		builder.emit(branch);
+		return;
+	}
+	if (node->getExp2()->hasSideEffects() && builder.isVarReg(reg1)) {
+		reg1 = builder.emitMove(reg1);
+	}
+	int reg2 = LowerValue(builder).visit(node->getExp2());
+	builder.emitBranch(cond, reg1, reg2, ifTrue, ifFalse);
+}
+
+// x++ and x--. A local is updated in its home register, with no
+// copy; anything else is loaded, added to and stored back.
+void LowerStmts::increment(ExpNode * exp, int delta){
+	IRInstr instr(IROp::ADD);
+	instr.imm = delta;
+	if (exp->getNodeKind() == NodeKind::ID) {
+		SymbolTableEntry * sym = static_cast<IdNode *>(exp)->getSymbol();
+		if (!sym->isGlobal()) {
+			instr.dst = builder.varReg(sym);
+			instr.src1 = instr.dst;
+			builder.emit(instr);
+			return;
+		}
+	}
+	instr.src1 = value(exp);
+	instr.dst = builder.newVReg();
+	store(exp, builder.emit(instr).dst);
+}
+
+void LowerStmts::visitIfStmt(IfStmtNode * node){
+	IRBlock * thenB = builder.newBlock();
+	IRBlock * exit = builder.newBlock();
+	cond(node->getExp(), thenB, exit);
+	builder.setBlock(thenB);
+	visit(node->getStmtList());
+	builder.emitJump(exit);
+	builder.setBlock(exit);
+}
+
+void LowerStmts::visitIfElseStmt(IfElseStmtNode * node){
+	IRBlock * thenB = builder.newBlock();
+	IRBlock * elseB = builder.newBlock();
+	IRBlock * exit = builder.newBlock();
+	cond(node->getExp(), thenB, elseB);
+	builder.setBlock(thenB);
+	visit(node->getThenStmtList());
+	builder.emitJump(exit);
+	builder.setBlock(elseB);
+	visit(node->getElseStmtList());
+	builder.emitJump(exit);
+	builder.setBlock(exit);
+}
+
+void LowerStmts::visitWhileStmt(WhileStmtNode * node){
+	IRBlock * header = builder.newBlock();
+	IRBlock * body = builder.newBlock();
+	IRBlock * exit = builder.newBlock();
+	builder.emitJump(header);
+	builder.setBlock(header);
+	cond(node->getExp(), body, exit);
+	builder.setBlock(body);
+	visit(node->getStmtList());
+	builder.emitJump(header);
+	builder.setBlock(exit);
+}
+
+void lowerFunction(IRModule& module, FnDeclNode * decl){
+	FormalsListNode * formalsNode = decl->getFormals();
+	IRFunction * fn = new IRFunction(decl->getName(),
+		formalsNode->offsetSize() / 4);
+	module.functions.push_back(fn);
+	IRBuilder builder(fn);
+
+	std::list<VarSymbol *> * formals = formalsNode->getSymbols();
+	for (VarSymbol * formal : *formals) {
+		IRInstr param(IROp::PARAM);
+		param.dst = builder.varReg(formal);
+		param.imm = formal->getOffset();
+		builder.emit(param);
+	}
+	delete formals;
+
+	LowerStmts(builder).visit(decl->getBody());
+	if (!builder.terminated()) {
+		builder.emit(IRInstr(IROp::RET));
+	}
+}
+
+} // end anonymous namespace
+
+void ProgramNode::lower(IRModule& module){
+	for (DeclNode * decl : myDeclList->getDecls()) {
+		switch (decl->getNodeKind()) {
+		case NodeKind::VAR_DECL:
+			if (static_cast<VarDeclNode *>(decl)->getSize()
+				== VarDeclNode::NOT_STRUCT) {
+				module.globals.push_back(decl->getName());
+			}
+			break;
+		case NodeKind::FN_DECL:
+			lowerFunction(module, static_cast<FnDeclNode *>(decl));
+			break;
+		default:
+			throw runtime_error("Not implemented: StructDeclNode");
+		}
+	}
+}
+
+} // End namespace LILC
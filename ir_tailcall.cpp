@@ -0,0 +1,208 @@
+#include "err.hpp"
+#include "ir.hpp"
+
+// Self tail calls. A block that ends in a call to its own function
+// followed by a return of the call's result becomes a copy of the
+// arguments into the formals and a jump to a loop head placed just
+// after the PARAMs, so the recursion runs in a single frame.
+//
+// "return x + f(...)" and "return x * f(...)" are also tail calls
+// once the pending operation is carried along: an accumulator
+// starts at the operation's identity, each such call folds x into
+// it, and every other return yields accumulator op value. Adds
+// and multiplies wrap, so regrouping them gives the same result.
+
+namespace LILC{
+
+namespace {
+
+// A block ending in a self call whose result is returned,
+// possibly after one add or multiply
+struct TailSite {
+	IRBlock * block;
+	size_t call;
+	// the call's result is added or multiplied by the instruction
+	// before the return; constants it uses may sit in between
+	bool folds = false;
+};
+
+bool isSelfCall(const IRFunction& fn, const IRInstr& instr){
+	return instr.op == IROp::CALL && instr.str == fn.name;
+}
+
+bool findSite(const IRFunction& fn, IRBlock * block, TailSite& site){
+	const std::vector<IRInstr>& instrs = block->instrs;
+	size_t n = instrs.size();
+	if (n < 2 || instrs[n - 1].op != IROp::RET){ return false; }
+	const IRInstr& ret = instrs[n - 1];
+	site.block = block;
+
+	const IRInstr& before = instrs[n - 2];
+	if (isSelfCall(fn, before)){
+		site.call = n - 2;
+		return ret.src1 == IRInstr::NO_REG || ret.src1 == before.dst;
+	}
+
+	if (before.op != IROp::ADD && before.op != IROp::MUL){ return false; }
+	if (ret.src1 != before.dst || n < 3){ return false; }
+	size_t call = n - 3;
+	while (call > 0 && instrs[call].op == IROp::LI){ call--; }
+	if (!isSelfCall(fn, instrs[call])){ return false; }
+	int result = instrs[call].dst;
+	bool first = before.src1 == result;
+	bool second = before.src2 == result;
+	// The other operand must not be the call's result too
+	if (first == second){ return false; }
+	site.call = call;
+	site.folds = true;
+	return true;
+}
+
+} // end anonymous namespace
+
+int IRTailCalls::run(IRModule& module){
+	int rewritten = 0;
+	for (IRFunction * fn : module.functions){
+		rewritten += rewrite(*fn);
+	}
+	return rewritten;
+}
+
+int IRTailCalls::rewrite(IRFunction& fn){
+	std::vector<TailSite> sites;
+	bool mixedOps = false;
+	bool folds = false;
+	IROp accKind = IROp::ADD;
+	for (IRBlock * block : fn.blocks){
+		TailSite site;
+		if (!findSite(fn, block, site)){ continue; }
+		if (site.folds){
+			IROp kind = block->instrs[block->instrs.size() - 2].op;
+			mixedOps = mixedOps || (folds && kind != accKind);
+			folds = true;
+			accKind = kind;
+		}
+		sites.push_back(site);
+	}
+	if (mixedOps){
+		// Only one kind of accumulator; keep the plain tail calls
+		std::vector<TailSite> plain;
+		for (const TailSite& site : sites){
+			if (!site.folds){ plain.push_back(site); }
+		}
+		sites = plain;
+		folds = false;
+	}
+	if (sites.empty()){ return 0; }
+
+	// The formals' registers, and the PARAMs that set them
+	IRBlock * entry = fn.blocks.front();
+	std::vector<int> formals(static_cast<size_t>(fn.numFormals),
+		static_cast<int>(IRInstr::NO_REG));
+	size_t numParams = 0;
+	while (numParams < entry->instrs.size()
+		&& entry->instrs[numParams].op == IROp::PARAM){
+		const IRInstr& param = entry->instrs[numParams];
+		formals[static_cast<size_t>(param.imm / -4)] = param.dst;
+		numParams++;
+	}
+	for (int formal : formals){
+		if (formal == IRInstr::NO_REG){
+			throw InternalError("tail calls: missing PARAM in "
+				+ fn.name);
+		}
+	}
+
+	// Entry: PARAMs, the accumulator, then on to the loop head
+	IRBlock * head = fn.newBlock();
+	head->instrs.assign(entry->instrs.begin()
+		+ static_cast<long>(numParams), entry->instrs.end());
+	entry->instrs.erase(entry->instrs.begin()
+		+ static_cast<long>(numParams), entry->instrs.end());
+	int acc = IRInstr::NO_REG;
+	if (folds){
+		acc = fn.newVReg();
+		IRInstr init(IROp::LI);
+		init.dst = acc;
+		init.imm = accKind == IROp::MUL ? 1 : 0;
+		entry->instrs.push_back(init);
+	}
+	IRInstr enter(IROp::JUMP);
+	enter.target = head->id;
+	entry->instrs.push_back(enter);
+	fn.blocks.insert(fn.blocks.begin() + 1, head);
+
+	for (const TailSite& site : sites){
+		// A block split off the entry keeps its instructions
+		IRBlock * block = site.block == entry ? head : site.block;
+		size_t call = site.block == entry
+			? site.call - numParams : site.call;
+		std::vector<IRInstr>& instrs = block->instrs;
+		std::vector<int> args = instrs[call].args;
+		std::vector<IRInstr> tail;
+
+		if (site.folds){
+			size_t op = instrs.size() - 2;
+			tail.assign(instrs.begin() + static_cast<long>(call) + 1,
+				instrs.begin() + static_cast<long>(op));
+			IRInstr fold = instrs[op];
+			int result = instrs[call].dst;
+			fold.dst = acc;
+			if (fold.src1 == result){
+				fold.src1 = acc;
+			} else {
+				fold.src2 = acc;
+			}
+			tail.push_back(fold);
+		}
+		// Arguments that read a formal reassigned before them
+		// go through a temporary first
+		for (size_t i = 0; i < args.size(); i++){
+			bool readsFormal = false;
+			for (size_t j = 0; j < formals.size(); j++){
+				readsFormal = readsFormal
+					|| (j != i && formals[j] == args[i]);
+			}
+			if (readsFormal){
+				IRInstr copy(IROp::MOVE);
+				copy.dst = fn.newVReg();
+				copy.src1 = args[i];
+				tail.push_back(copy);
+				args[i] = copy.dst;
+			}
+		}
+		for (size_t i = 0; i < args.size(); i++){
+			if (args[i] == formals[i]){ continue; }
+			IRInstr move(IROp::MOVE);
+			move.dst = formals[i];
+			move.src1 = args[i];
+			tail.push_back(move);
+		}
+		IRInstr loop(IROp::JUMP);
+		loop.target = head->id;
+		tail.push_back(loop);
+
+		instrs.erase(instrs.begin() + static_cast<long>(call), instrs.end());
+		instrs.insert(instrs.end(), tail.begin(), tail.end());
+	}
+
+	// Every other return folds in what the accumulator holds
+	if (acc != IRInstr::NO_REG){
+		for (IRBlock * block : fn.blocks){
+			if (block->instrs.empty()){ continue; }
+			IRInstr& ret = block->instrs.back();
+			if (ret.op != IROp::RET || ret.src1 == IRInstr::NO_REG){
+				continue;
+			}
+			IRInstr fold(accKind);
+			fold.dst = fn.newVReg();
+			fold.src1 = acc;
+			fold.src2 = ret.src1;
+			ret.src1 = fold.dst;
+			block->instrs.insert(block->instrs.end() - 1, fold);
+		}
+	}
+	return static_cast<int>(sites.size());
+}
+
+} // End namespace LILC
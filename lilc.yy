@@ -13,7 +13,6 @@
    #include "ast.hpp"
    namespace LILC {
       class LilC_Compiler;
-      class LilC_Scanner;
    }
 
 // The following definitions is missing when %locations isn't used
@@ -27,7 +26,6 @@
 
 }
 
-%parse-param { LilC_Scanner  &scanner  }
 %parse-param { LilC_Compiler &compiler }
 
 %code{
@@ -39,83 +37,78 @@
    #include "lilc_compiler.hpp"
 
 #undef yylex
-#define yylex scanner.yylex
+#define yylex compiler.lex
 }
 
 /*%define api.value.type variant*/
 %union {
 
-LILC::IntLitToken * intTokenValue;
-LILC::StringLitToken * strTokenValue;
-LILC::IDToken * idTokenValue;
-LILC::Token * tokenValue;
+LILC::TokenRef token;
 LILC::ASTNode * astNode;
 LILC::ProgramNode * programNode;
-std::list<DeclNode *> * declList;
-std::list<FormalDeclNode * > * formalsList;
+NodeList<DeclNode *> * declList;
+NodeList<FormalDeclNode *> * formalsList;
 LILC::DeclNode * declNode;
 LILC::FnDeclNode * fnDecl;
 LILC::FormalDeclNode * formalDecl;
 LILC::StructDeclNode * structDeclNode;
 LILC::FormalsListNode * formals;
 LILC::FnBodyNode * fnBody;
-std::list<StmtNode *> * stmtList;
-std::list<ExpNode *> * expList;
+NodeList<StmtNode *> * stmtList;
+NodeList<ExpNode *> * expList;
 LILC::TypeNode * typeNode;
 LILC::StmtNode * stmtNode;
 LILC::ExpNode * exp;
 LILC::IdNode * idNode;
 LILC::AssignNode * assignNode;
 LILC::CallExpNode * callNode;
-
-	/*LILC::Token * token;*/
 }
 
 %define parse.assert
 
 %token                  END    0     "end of file"
 %token                  NEWLINE "newline"
-%token <tokenValue>     CHAR
-%token <tokenValue>     BOOL
-%token <tokenValue>     INT
-%token <tokenValue>     VOID
-%token <tokenValue>     TRUE
-%token <tokenValue>     FALSE
-%token <tokenValue>     STRUCT
-%token <tokenValue>     INPUT
-%token <tokenValue>     OUTPUT
-%token <tokenValue>     IF
-%token <tokenValue>     ELSE
-%token <tokenValue>     WHILE
-%token <tokenValue>     RETURN
-%token <idTokenValue>   ID
-%token <intTokenValue>  INTLITERAL
-%token <strTokenValue>  STRINGLITERAL
-%token <tokenValue>     LCURLY
-%token <tokenValue>     RCURLY
-%token <tokenValue>     LPAREN
-%token <tokenValue>     RPAREN
-%token <tokenValue>     SEMICOLON
-%token <tokenValue>     COMMA
-%token <tokenValue>     DOT
-%token <tokenValue>     WRITE
-%token <tokenValue>     READ
-%token <tokenValue>     PLUSPLUS
-%token <tokenValue>     MINUSMINUS
-%token <tokenValue>     PLUS
-%token <tokenValue>     MINUS
-%token <tokenValue>     TIMES
-%token <tokenValue>     DIVIDE
-%token <tokenValue>     NOT
-%token <tokenValue>     AND
-%token <tokenValue>     OR
-%token <tokenValue>     EQUALS
-%token <tokenValue>     NOTEQUALS
-%token <tokenValue>     LESS
-%token <tokenValue>     GREATER
-%token <tokenValue>     LESSEQ
-%token <tokenValue>     GREATEREQ
-%token <tokenValue>     ASSIGN
+%token <token>          CHAR
+%token <token>          BOOL
+%token <token>          INT
+%token <token>          VOID
+%token <token>          TRUE
+%token <token>          FALSE
+%token <token>          STRUCT
+%token <token>          INPUT
+%token <token>          OUTPUT
+%token <token>          IF
+%token <token>          ELSE
+%token <token>          WHILE
+%token <token>          RETURN
+%token <token>          ID
+%token <token>          INTLITERAL
+%token <token>          STRINGLITERAL
+%token <token>          LCURLY
+%token <token>          RCURLY
+%token <token>          LPAREN
+%token <token>          RPAREN
+%token <token>          SEMICOLON
+%token <token>          COMMA
+%token <token>          DOT
+%token <token>          WRITE
+%token <token>          READ
+%token <token>          PLUSPLUS
+%token <token>          MINUSMINUS
+%token <token>          PLUS
+%token <token>          MINUS
+%token <token>          TIMES
+%token <token>          DIVIDE
+%token <token>          NOT
+%token <token>          AND
+%token <token>          OR
+%token <token>          EQUALS
+%token <token>          NOTEQUALS
+%token <token>          LESS
+%token <token>          GREATER
+%token <token>          LESSEQ
+%token <token>          GREATEREQ
+%token <token>          ASSIGN
 
 /* Nonterminals
 *  NOTE: You will need to add more nonterminals
@@ -160,7 +153,7 @@ LILC::CallExpNode * callNode;
 
 program : declList 
           {
-          $$ = new ProgramNode(new DeclListNode($1));
+          $$ = compiler.make<ProgramNode>(compiler.make<DeclListNode>($1));
           compiler.setASTRoot($$);
           }
 
@@ -171,7 +164,7 @@ declList : declList decl
            }
          | /* epsilon */ 
            {
-           $$ = new std::list<DeclNode *>();
+           $$ = compiler.makeList<DeclNode *>();
            }
 
 decl : varDecl { $$ = $1; }
@@ -181,17 +174,17 @@ decl : varDecl { $$ = $1; }
 
 varDecl : type id SEMICOLON 
           {
-          $$ = new VarDeclNode($1, $2, VarDeclNode::NOT_STRUCT);
+          $$ = compiler.make<VarDeclNode>($1, $2, VarDeclNode::NOT_STRUCT);
           }
         | STRUCT id id SEMICOLON 
           {
-          $$ = new VarDeclNode(
-		new StructNode($2, $1->line, $1->column), $3, 0);
+          $$ = compiler.make<VarDeclNode>(
+		compiler.make<StructNode>($2, $1.line(), $1.column()), $3, 0);
           }
 
 varDeclList : /* epsilon */ 
               {
-              $$ = new std::list<DeclNode *>();
+              $$ = compiler.makeList<DeclNode *>();
               }
             | varDeclList varDecl 
               {
@@ -201,13 +194,13 @@ varDeclList : /* epsilon */
 
 fnDecl : type id formals fnBody 
          {
-         $$ = new FnDeclNode($1, $2, $3, $4);
+         $$ = compiler.make<FnDeclNode>($1, $2, $3, $4);
          }
 
 structDecl : STRUCT id LCURLY structBody RCURLY SEMICOLON 
              {
-             $$ = new StructDeclNode($1->line, $1->column,
-                         $2, new DeclListNode($4)) ;
+             $$ = compiler.make<StructDeclNode>($1.line(), $1.column(),
+                         $2, compiler.make<DeclListNode>($4)) ;
              }
 
 structBody : structBody varDecl 
@@ -218,142 +211,144 @@ structBody : structBody varDecl
 
 structBody : varDecl 
              {
-             std::list<DeclNode *> * list = new std::list<DeclNode *>;
+             NodeList<DeclNode *> * list = compiler.makeList<DeclNode *>();
              list->push_back($1);
              $$ = list;
              }
 
 formals : LPAREN RPAREN 
           {
-          $$ = new FormalsListNode(new std::list<FormalDeclNode *>()); 
+          $$ = compiler.make<FormalsListNode>(
+                  compiler.makeList<FormalDeclNode *>());
           }
 
 formals : LPAREN formalsList RPAREN 
           {
-          $$ = new FormalsListNode($2); 
+          $$ = compiler.make<FormalsListNode>($2); 
           }
 
 formalsList : formalDecl 
               {
-              std::list<FormalDeclNode *> * list = new std::list<FormalDeclNode *>();
+              NodeList<FormalDeclNode *> * list = compiler.makeList<FormalDeclNode *>();
               list->push_back($1);
               $$ = list;
               }
-            | formalDecl COMMA formalsList 
+            | formalsList COMMA formalDecl 
               {
-              $3->push_front($1);
-              $$ = $3;
+              $1->push_back($3);
+              $$ = $1;
               }
 
 fnBody : LCURLY varDeclList stmtList RCURLY {
-         $$ = new FnBodyNode($1->line, $1->column, 
-                  new DeclListNode($2), new StmtListNode($3));
+         $$ = compiler.make<FnBodyNode>($1.line(), $1.column(), 
+                  compiler.make<DeclListNode>($2), compiler.make<StmtListNode>($3));
        }
 
 formalDecl : type id 
              {
-             $$ = new FormalDeclNode($1, $2);
+             $$ = compiler.make<FormalDeclNode>($1, $2);
              }
 
 stmtList : /* epsilon */ 
            { 
-           $$ = new std::list<StmtNode *>();}
+           $$ = compiler.makeList<StmtNode *>();}
          | stmtList stmt 
            { 
            $1->push_back($2);
            $$ = $1;
            }
 
-stmt : assignExp SEMICOLON { $$ = new AssignStmtNode($1); }
-     | loc PLUSPLUS SEMICOLON { $$ = new PostIncStmtNode($1); }
-     | loc MINUSMINUS SEMICOLON { $$ = new PostDecStmtNode($1); }
+stmt : assignExp SEMICOLON { $$ = compiler.make<AssignStmtNode>($1); }
+     | loc PLUSPLUS SEMICOLON { $$ = compiler.make<PostIncStmtNode>($1); }
+     | loc MINUSMINUS SEMICOLON { $$ = compiler.make<PostDecStmtNode>($1); }
      | INPUT READ loc SEMICOLON 
        { 
-       $$ = new ReadStmtNode($3); 
+       $$ = compiler.make<ReadStmtNode>($3); 
        }
      | OUTPUT WRITE exp SEMICOLON 
        { 
-       $$ = new WriteStmtNode($3); 
+       $$ = compiler.make<WriteStmtNode>($3); 
        }
      | IF LPAREN exp RPAREN LCURLY varDeclList stmtList RCURLY 
         { 
-        $$ = new IfStmtNode($1->line, $1->column, $3, 
-                     new DeclListNode($6), new StmtListNode($7));
+        $$ = compiler.make<IfStmtNode>($1.line(), $1.column(), $3, 
+                     compiler.make<DeclListNode>($6), compiler.make<StmtListNode>($7));
         }
      | IF LPAREN exp RPAREN LCURLY varDeclList stmtList RCURLY ELSE LCURLY varDeclList stmtList RCURLY
         { 
-        $$ = new IfElseStmtNode(
+        $$ = compiler.make<IfElseStmtNode>(
                 $3, 
-                new DeclListNode($6), 
-                new StmtListNode($7), 
-                new DeclListNode($11), 
-                new StmtListNode($12)); 
+                compiler.make<DeclListNode>($6), 
+                compiler.make<StmtListNode>($7), 
+                compiler.make<DeclListNode>($11), 
+                compiler.make<StmtListNode>($12)); 
         }
      | WHILE LPAREN exp RPAREN LCURLY varDeclList stmtList RCURLY
        { 
-        $$ = new WhileStmtNode($1->line, $1->column, 
-                 $3, new DeclListNode($6), new StmtListNode($7)); 
+        $$ = compiler.make<WhileStmtNode>($1.line(), $1.column(), 
+                 $3, compiler.make<DeclListNode>($6), compiler.make<StmtListNode>($7)); 
        }
      | RETURN exp SEMICOLON 
-	{ $$ = new ReturnStmtNode($1->line, $1->column, $2); }
+	{ $$ = compiler.make<ReturnStmtNode>($1.line(), $1.column(), $2); }
      | RETURN SEMICOLON 
-       { $$ = new ReturnStmtNode($1->line, $1->column, nullptr); }
-     | fncall SEMICOLON { $$ = new CallStmtNode($1); }
+       { $$ = compiler.make<ReturnStmtNode>($1.line(), $1.column(), nullptr); }
+     | fncall SEMICOLON { $$ = compiler.make<CallStmtNode>($1); }
 
 
 assignExp : loc ASSIGN exp 
-    { $$ = new AssignNode($2->line, $2->column, $1, $3); }
+    { $$ = compiler.make<AssignNode>($2.line(), $2.column(), $1, $3); }
 
 exp : assignExp { $$ = $1;}
     | exp PLUS exp 
-      { $$ = new PlusNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<PlusNode>($2.line(), $2.column(), $1, $3); }
     | exp MINUS exp 
-      { $$ = new MinusNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<MinusNode>($2.line(), $2.column(), $1, $3); }
     | exp TIMES exp 
-      { $$ = new TimesNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<TimesNode>($2.line(), $2.column(), $1, $3); }
     | exp DIVIDE exp 
-      { $$ = new DivideNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<DivideNode>($2.line(), $2.column(), $1, $3); }
     | NOT exp 
-      { $$ = new NotNode($1->line, $1->column, $2); }
+      { $$ = compiler.make<NotNode>($1.line(), $1.column(), $2); }
     | exp AND exp 
-      { $$ = new AndNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<AndNode>($2.line(), $2.column(), $1, $3); }
     | exp OR exp 
-      { $$ = new OrNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<OrNode>($2.line(), $2.column(), $1, $3); }
     | exp EQUALS exp 
-      { $$ = new EqualsNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<EqualsNode>($2.line(), $2.column(), $1, $3); }
     | exp NOTEQUALS exp 
-      { $$ = new NotEqualsNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<NotEqualsNode>($2.line(), $2.column(), $1, $3); }
     | exp LESS exp 
-      { $$ = new LessNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<LessNode>($2.line(), $2.column(), $1, $3); }
     | exp GREATER exp 
-      { $$ = new GreaterNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<GreaterNode>($2.line(), $2.column(), $1, $3); }
     | exp LESSEQ exp 
-      { $$ = new LessEqNode($2->line, $2->column, $1, $3); }
+      { $$ = compiler.make<LessEqNode>($2.line(), $2.column(), $1, $3); }
     | exp GREATEREQ exp 
-      { $$ = new GreaterEqNode($2->line, $2->column, $1, $3); }
-    | MINUS term { $$ = new UnaryMinusNode($2); }
+      { $$ = compiler.make<GreaterEqNode>($2.line(), $2.column(), $1, $3); }
+    | MINUS term { $$ = compiler.make<UnaryMinusNode>($2); }
     | term { $$ = $1; }
 
 term : loc { $$ = $1; }
-     | INTLITERAL { $$ = new IntLitNode($1); }
-     | STRINGLITERAL { $$ = new StrLitNode($1); }
-     | TRUE { $$ = new TrueNode($1->line, $1->column); }
-     | FALSE { $$ = new FalseNode($1->line, $1->column); }
+     | INTLITERAL { $$ = compiler.make<IntLitNode>($1); }
+     | STRINGLITERAL { $$ = compiler.make<StrLitNode>($1); }
+     | TRUE { $$ = compiler.make<TrueNode>($1.line(), $1.column()); }
+     | FALSE { $$ = compiler.make<FalseNode>($1.line(), $1.column()); }
      | LPAREN exp RPAREN { $$ = $2; }
      | fncall { $$ = $1; }
 
 fncall : id LPAREN RPAREN 
         { 
-        $$ = new CallExpNode($1, new ExpListNode(new std::list<ExpNode *>()));
+        $$ = compiler.make<CallExpNode>($1,
+                compiler.make<ExpListNode>(compiler.makeList<ExpNode *>()));
         }
         | id LPAREN actualList RPAREN 
         { 
-        $$ = new CallExpNode($1, new ExpListNode($3)); 
+        $$ = compiler.make<CallExpNode>($1, compiler.make<ExpListNode>($3)); 
         }
 
 actualList : exp 
         { 
-        std::list<ExpNode *> * list = new std::list<ExpNode *>();
+        NodeList<ExpNode *> * list = compiler.makeList<ExpNode *>();
         list->push_back($1);
         $$ = list;
         }
@@ -363,16 +358,16 @@ actualList : exp
         $$ = $1;
         }
 
-type : INT { $$ = new IntNode($1->line, $1->column); }
-     | BOOL { $$ = new BoolNode($1->line, $1->column); }
-     | VOID { $$ = new VoidNode($1->line, $1->column); }
+type : INT { $$ = compiler.make<IntNode>($1.line(), $1.column()); }
+     | BOOL { $$ = compiler.make<BoolNode>($1.line(), $1.column()); }
+     | VOID { $$ = compiler.make<VoidNode>($1.line(), $1.column()); }
 
 
 loc : id { $$ = $1; }
     | loc DOT id 
-      { $$ = new DotAccessNode($1, $3); }
+      { $$ = compiler.make<DotAccessNode>($1, $3); }
 
-id : ID { $$ = new IdNode($1); }
+id : ID { $$ = compiler.make<IdNode>($1); }
 
 %%
 void
@@ -0,0 +1,42 @@
+#include <cstdint>
+#include <cstdlib>
+#include "lilc_arena.hpp"
+
+namespace LILC{
+
+void * LilC_Arena::allocate(size_t size, size_t align){
+	uintptr_t addr = reinterpret_cast<uintptr_t>(next);
+	size_t pad = (align - addr % align) % align;
+	if (next == nullptr || pad + size > static_cast<size_t>(limit - next)){
+		// Oversized requests get a block of their own
+		size_t blockSize = size + align > BLOCK_SIZE
+			? size + align : BLOCK_SIZE;
+		char * block = static_cast<char *>(std::malloc(blockSize));
+		if (block == nullptr){ throw std::bad_alloc(); }
+		blocks.push_back(block);
+		reserved += blockSize;
+		next = block;
+		limit = block + blockSize;
+		addr = reinterpret_cast<uintptr_t>(next);
+		pad = (align - addr % align) % align;
+	}
+	void * result = next + pad;
+	next += pad + size;
+	used += size;
+	return result;
+}
+
+void LilC_Arena::release(){
+	for (auto itr = dtors.rbegin(); itr != dtors.rend(); ++itr){
+		itr->fn(itr->obj);
+	}
+	dtors.clear();
+	for (char * block : blocks){
+		std::free(block);
+	}
+	blocks.clear();
+	next = limit = nullptr;
+	used = reserved = 0;
+}
+
+} // End namespace LILC
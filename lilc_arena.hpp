@@ -0,0 +1,123 @@
+#ifndef __LILC_ARENA_HPP__
+#define __LILC_ARENA_HPP__ 1
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LILC{
+
+/* Bump-pointer allocator for what the front end builds: AST
+  nodes and the lists that hold them. Objects are carved out
+  of large blocks and never freed one at a time; release() (or
+  the destructor) runs the destructors of the objects that have
+  one and frees every block at once.
+*/
+class LilC_Arena{
+public:
+	LilC_Arena() = default;
+	LilC_Arena(const LilC_Arena&) = delete;
+	LilC_Arena& operator=(const LilC_Arena&) = delete;
+	~LilC_Arena(){ release(); }
+
+	// Construct a T in the arena
+	template <typename T, typename... Args>
+	T * make(Args&&... args){
+		void * mem = allocate(sizeof(T), alignof(T));
+		T * obj = new (mem) T(std::forward<Args>(args)...);
+		if (!std::is_trivially_destructible<T>::value){
+			dtors.push_back(Dtor{obj, &destroy<T>});
+		}
+		return obj;
+	}
+
+	// Raw, suitably aligned memory that lives as long as the arena
+	void * allocate(size_t size, size_t align);
+
+	// Destroy everything allocated so far and free the blocks
+	void release();
+
+	size_t bytesUsed() const { return used; }
+	size_t bytesReserved() const { return reserved; }
+
+private:
+	static const size_t BLOCK_SIZE = 64 * 1024;
+
+	template <typename T>
+	static void destroy(void * obj){ static_cast<T *>(obj)->~T(); }
+
+	struct Dtor {
+		void * obj;
+		void (*fn)(void *);
+	};
+
+	std::vector<char *> blocks;
+	std::vector<Dtor> dtors;
+	char * next = nullptr;
+	char * limit = nullptr;
+	size_t used = 0;
+	size_t reserved = 0;
+};
+
+/* The lists of declarations, formals, statements and arguments
+  the parser builds: a growable array whose elements come from an
+  arena. The children of a node sit side by side, so walking a
+  list reads one run of pointers rather than chasing list nodes.
+  Growing copies into a run twice the size and leaves the old one
+  to the arena; lists are only appended to while parsing, so that
+  waste is bounded by the list itself.
+*/
+template <typename T>
+class NodeList{
+	static_assert(std::is_trivially_copyable<T>::value,
+		"NodeList holds pointers to nodes");
+public:
+	using iterator = T *;
+	using const_iterator = const T *;
+
+	explicit NodeList(LilC_Arena * arenaIn) : arena(arenaIn){ }
+	NodeList(const NodeList&) = delete;
+	NodeList& operator=(const NodeList&) = delete;
+
+	void push_back(const T& item){
+		if (count == capacity){ grow(); }
+		items[count++] = item;
+	}
+
+	// Empty the list, keeping its storage for the next push_back
+	void clear(){ count = 0; }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	T& operator[](size_t i){ return items[i]; }
+	iterator begin(){ return items; }
+	iterator end(){ return items + count; }
+	const_iterator begin() const { return items; }
+	const_iterator end() const { return items + count; }
+
+private:
+	static const uint32_t FIRST_CAPACITY = 4;
+
+	void grow(){
+		uint32_t newCapacity = capacity == 0
+			? FIRST_CAPACITY : capacity * 2;
+		T * newItems = static_cast<T *>(arena->allocate(
+			newCapacity * sizeof(T), alignof(T)));
+		for (uint32_t i = 0; i < count; i++){
+			newItems[i] = items[i];
+		}
+		items = newItems;
+		capacity = newCapacity;
+	}
+
+	LilC_Arena * arena;
+	T * items = nullptr;
+	uint32_t count = 0;
+	uint32_t capacity = 0;
+};
+
+} /* end namespace */
+#endif /* END __LILC_ARENA_HPP__ */
@@ -5,36 +5,99 @@
 #include "lilc_compiler.hpp"
 
 using TokenTag = LILC::LilC_Parser::token;
-using Lexeme = LILC::LilC_Parser::semantic_type;
 
 LILC::LilC_Compiler::~LilC_Compiler()
 {
+#ifndef LILC_NO_FLEX
    delete(scanner);
    scanner = nullptr;
+#endif
+   delete(dfaScanner);
+   dfaScanner = nullptr;
    delete(parser);
    parser = nullptr;
-   delete(astRoot);
    astRoot = nullptr;
 }
 
-void LILC::LilC_Compiler::scan( const char * const filename,
-const char * outfile )
+void LILC::LilC_Compiler::open( const char * const filename )
 {
-   std::ifstream inStream( filename );
-   if( ! inStream.good() ) {
+   assert( filename != nullptr );
+   if( ! source.open( filename ) ) {
 	std::cerr << "Bad input stream " << filename << std::endl;
        exit( EXIT_FAILURE );
    }
+   if (options.dfaScanner){
+	dfaScanner = new LILC::LilC_DFAScanner( source, tokens, names );
+	return;
+   }
+#ifdef LILC_NO_FLEX
+   std::cerr << "lilcc was built without flex; "
+	"only -fdfa-scanner is available" << std::endl;
+   exit( EXIT_FAILURE );
+#else
+   scanner = new LILC::LilC_Scanner( source, tokens, names );
+#endif
+}
 
-   delete(scanner);
-   scanner = new LILC::LilC_Scanner( &inStream );
+/*
+* The scanners append every token but the end of input to the
+* buffer themselves; it is added here so the stream always ends
+* with an END record.
+*/
+void LILC::LilC_Compiler::scanToken(){
+	int tag;
+#ifdef LILC_NO_FLEX
+	tag = dfaScanner->yylex();
+#else
+	if (dfaScanner != nullptr){
+		tag = dfaScanner->yylex();
+	} else {
+		tag = scanner->yylex();
+	}
+#endif
+	if (tag == TokenTag::END){ tokens.add(TokenTag::END, 0, 0); }
+}
+
+bool LILC::LilC_Compiler::scannedAll() const {
+	return tokens.size() > 0
+		&& tokens.tag(static_cast<uint32_t>(tokens.size() - 1))
+		== TokenTag::END;
+}
+
+void LILC::LilC_Compiler::scan(){
+	LilC_PassStats::Sample start = LilC_PassStats::sample();
+	while (!scannedAll()){ scanToken(); }
+	if (stats.enabled()){ stats.record("scan", start); }
+}
+
+/*
+* The parser pulls tokens from here. Tokens are scanned on
+* demand and kept, so the stream is only ever scanned once and
+* a parse error stops scanning exactly where it did before.
+*/
+int LILC::LilC_Compiler::lex(LilC_Parser::semantic_type * const lval){
+	if (nextToken == tokens.size()){
+		if (!stats.enabled()){
+			scanToken();
+		} else {
+			LilC_PassStats::Sample start = LilC_PassStats::sample();
+			scanToken();
+			stats.record("scan", start);
+		}
+	}
+	uint32_t index = nextToken;
+	int tag = tokens.tag(index);
+	if (tag != TokenTag::END){ nextToken++; }
+	lval->token = tokens.ref(index);
+	return tag;
+}
 
+void LILC::LilC_Compiler::writeTokens( const char * outfile )
+{
+   scan();
    std::ofstream out(outfile);
-   Lexeme lexeme;
-   int tokenTag;
-   while(true){
-   	tokenTag = scanner->yylex(&lexeme);
-	switch (tokenTag){
+   for (uint32_t i = 0; i < tokens.size(); i++){
+	switch (tokens.tag(i)){
 		case TokenTag::END:
 			out << "EOF" << std::endl;
 			return;
@@ -75,26 +138,15 @@ const char * outfile )
 			out << "return" << std::endl;
 			break;
 		case TokenTag::ID:
-			{
-			IDToken * tok = static_cast<IDToken *>(
-				lexeme.tokenValue);
-			out << "ID:" << tok->value() << std::endl;
+			out << "ID:" << tokens.name(i) << std::endl;
 			break;
-			}
 		case TokenTag::INTLITERAL:
-			{
-			IntLitToken * tok = static_cast<IntLitToken *>(
-				lexeme.tokenValue);
-			out << "INTLIT:" << tok->value() << std::endl;
+			out << "INTLIT:" << tokens.intValue(i) << std::endl;
 			break;
-			}
 		case TokenTag::STRINGLITERAL:
-			{
-			StringLitToken * tok = static_cast<StringLitToken *>(
-				lexeme.tokenValue);
-			out << "STRINGLIT:" << tok->value() << std::endl;
+			out << "STRINGLIT:" << tokens.stringValue(i)
+				<< std::endl;
 			break;
-			}
 		case TokenTag::LCURLY:
 			out << "{" << std::endl;
 			break;
@@ -178,23 +230,12 @@ const char * outfile )
 }
 
 bool
-LILC::LilC_Compiler::parse( const char * const infile) {
-   assert( infile != nullptr );
-   std::ifstream in_stream( infile );
-   if( ! in_stream.good() )
-   {
-	std::cerr << "bad input stream " << infile << std::endl;
-       exit( EXIT_FAILURE );
-   }
-
-   delete(scanner);
-   scanner = new LILC::LilC_Scanner( &in_stream );
-   delete(parser);
-   delete(astRoot);
+LILC::LilC_Compiler::parse() {
+   if (stage >= Stage::PARSED) { return true; }
+   if (failed) { return false; }
    try
    {
-      parser = new LILC::LilC_Parser( (*scanner) /* scanner */,
-                                  (*this) /* compiler */ );
+      parser = new LILC::LilC_Parser( (*this) /* compiler */ );
    }
    catch( std::bad_alloc &ba )
    {
@@ -203,32 +244,57 @@ LILC::LilC_Compiler::parse( const char * const infile) {
       exit( EXIT_FAILURE );
    }
    const int accept( 0 );
-   if( parser->parse() != accept )
+   LilC_PassStats::Pass scanned = stats.get("scan");
+   LilC_PassStats::Sample start = LilC_PassStats::sample();
+   bool parsed = parser->parse() == accept;
+   if (stats.enabled()){
+	stats.record("parse", start);
+	stats.deduct("parse", "scan", scanned);
+   }
+   if( !parsed )
    {
       std::cerr << "Parse failed!!\n";
+      failed = true;
       return false;
    }
+   stage = Stage::PARSED;
    return true;
 }
 
-bool LILC::LilC_Compiler::nameAnalysis(const char * const inF){
-	if (!this->parse(inF)){ return false; }
-	delete( symbolTable);
-	symbolTable = new SymbolTable();
+bool LILC::LilC_Compiler::nameAnalysis(){
+	if (stage >= Stage::NAMED){ return true; }
+	if (!this->parse() || failed){ return false; }
+	symbolTable.reset(new SymbolTable(names));
 
-	if (!this->astRoot->nameAnalysis(symbolTable)){
+	LilC_PassStats::Sample start = LilC_PassStats::sample();
+	bool valid = this->astRoot->nameAnalysis(symbolTable.get());
+	if (stats.enabled()){ stats.record("name analysis", start); }
+	if (!valid){
 		std::cerr << "Failed nameAnalysis!" << std::endl;
+		failed = true;
 		return false;
 	}
+	stage = Stage::NAMED;
 	return true;
 }
 
-bool LILC::LilC_Compiler::typeAnalysis(const char * const inF){
-	if (!this->nameAnalysis(inF)){ return false; }
-	return this->astRoot->typeAnalysis();
+bool LILC::LilC_Compiler::typeAnalysis(){
+	if (stage >= Stage::TYPED){ return true; }
+	if (!this->nameAnalysis() || failed){ return false; }
+	LilC_PassStats::Sample start = LilC_PassStats::sample();
+	bool valid = this->astRoot->typeAnalysis();
+	if (stats.enabled()){ stats.record("type analysis", start); }
+	if (!valid){
+		failed = true;
+		return false;
+	}
+	stage = Stage::TYPED;
+	return true;
 }
 
-void LILC::LilC_Compiler::unparse(const char * const outF){
+bool LILC::LilC_Compiler::unparse(const char * const outF){
+	if (!this->nameAnalysis()){ return false; }
 	std::ofstream out(outF);
 	this->astRoot->unparse(out, 0);
+	return true;
 }
@@ -4,12 +4,21 @@
 #include <string>
 #include <cstddef>
 #include <istream>
+#include <memory>
 
+#ifndef LILC_NO_FLEX
 #include "lilc_scanner.hpp"
+#endif
+#include "lilc_dfa_scanner.hpp"
 #include "tokens.hpp"
 #include "ast.hpp"
 #include "grammar.hh"
 #include "symbol_table.hpp"
+#include "lilc_options.hpp"
+#include "lilc_arena.hpp"
+#include "name_table.hpp"
+#include "lilc_stats.hpp"
+#include "lilc_source.hpp"
 
 namespace LILC{
 
@@ -21,19 +30,66 @@ public:
 
    void setASTRoot(ProgramNode * root){ this->astRoot = root; }
    ProgramNode * getASTRoot(){ return this->astRoot; }
+   LilC_Options& getOptions(){ return this->options; }
+   LilC_PassStats& getStats(){ return this->stats; }
 
-   void scan( const char * const filename, const char * outfile);
-   bool parse( const char * const filename );
-   void unparse(const char * const outF);
-   bool nameAnalysis( const char * const filename );
-   bool typeAnalysis( const char * const filename );
-   bool codeGen(const char * const inFile, 
-	const char * const outFile);
+   // AST nodes and node lists live in the compiler's arena and
+   // are freed together when it is destroyed
+   LilC_Arena& getArena(){ return this->arena; }
+   NameTable& getNames(){ return this->names; }
+   template <typename T, typename... Args>
+   T * make(Args&&... args){
+	return arena.make<T>(std::forward<Args>(args)...);
+   }
+   template <typename T>
+   NodeList<T> * makeList(){
+	return arena.make<NodeList<T>>(&arena);
+   }
+
+   /* The stages below each run the ones before them, but every
+     stage runs at most once: the token stream, AST and symbol
+     table are kept, so asking for tokens, an unparse and the
+     assembly costs one scan and one parse. Once a stage fails,
+     the ones after it return false without doing anything.
+   */
+   void open( const char * const filename );
+   void scan();
+   bool parse();
+   bool nameAnalysis();
+   bool typeAnalysis();
+   bool codeGen(const char * const outFile);
+
+   void writeTokens( const char * outfile );
+   bool unparse(const char * const outF);
+
+   // The parser's yylex; hands out the cached tokens
+   int lex(LilC_Parser::semantic_type * const lval);
 private:
+   enum class Stage { NONE, PARSED, NAMED, TYPED };
+
+   void scanToken();
+   bool scannedAll() const;
+
+   // mapped input; string literal tokens keep spans of it
+   LilC_Source source;
+   LilC_Arena arena;
+   NameTable names;
+   TokenBuffer tokens{source, names};
+   uint32_t nextToken = 0;
+   Stage stage = Stage::NONE;
+   bool failed = false;
+
    LILC::LilC_Parser  *parser  = nullptr;
+   // one or the other, as options.dfaScanner says. Built without
+   // flex (LILC_NO_FLEX), only the hand-written one exists.
+#ifndef LILC_NO_FLEX
    LILC::LilC_Scanner *scanner = nullptr;
+#endif
+   LILC::LilC_DFAScanner *dfaScanner = nullptr;
    ProgramNode * astRoot = nullptr;
-   SymbolTable * symbolTable = nullptr;
+   std::unique_ptr<SymbolTable> symbolTable;
+   LilC_Options options;
+   LilC_PassStats stats;
 };
 
 } /* end namespace */
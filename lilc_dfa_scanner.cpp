@@ -0,0 +1,356 @@
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "lilc_dfa_scanner.hpp"
+#include "tokens.hpp"
+
+using TokenTag = LILC::LilC_Parser::token;
+
+namespace LILC{
+
+namespace {
+
+enum CharClass : unsigned char {
+	OTHER, LETTER, DIGIT, SPACE, NEWLINE, QUOTE, HASH, SLASH, OP
+};
+
+struct CharTable {
+	unsigned char cls[256];
+	// [^\n"\\]: may appear unescaped in a string literal
+	bool strChar[256];
+	// [nt'"?\\]: may follow a backslash in a string literal
+	bool escaped[256];
+
+	CharTable(){
+		for (int c = 0; c < 256; c++){
+			cls[c] = OTHER;
+			strChar[c] = c != '\n' && c != '"' && c != '\\';
+			escaped[c] = false;
+		}
+		for (int c = 'a'; c <= 'z'; c++){ cls[c] = LETTER; }
+		for (int c = 'A'; c <= 'Z'; c++){ cls[c] = LETTER; }
+		cls[static_cast<unsigned char>('_')] = LETTER;
+		for (int c = '0'; c <= '9'; c++){ cls[c] = DIGIT; }
+		cls[static_cast<unsigned char>(' ')] = SPACE;
+		cls[static_cast<unsigned char>('\t')] = SPACE;
+		cls[static_cast<unsigned char>('\n')] = NEWLINE;
+		cls[static_cast<unsigned char>('"')] = QUOTE;
+		cls[static_cast<unsigned char>('#')] = HASH;
+		cls[static_cast<unsigned char>('/')] = SLASH;
+		for (const char * op = "{}();,.+-*!&|=<>"; *op; op++){
+			cls[static_cast<unsigned char>(*op)] = OP;
+		}
+		for (const char * esc = "nt'\"?\\"; *esc; esc++){
+			escaped[static_cast<unsigned char>(*esc)] = true;
+		}
+	}
+};
+
+const CharTable chars;
+
+inline unsigned char classOf(char c){
+	return chars.cls[static_cast<unsigned char>(c)];
+}
+
+/*
+* The keywords hash perfectly on (first char + last char +
+* length) mod 32, so finding out whether an identifier is a
+* keyword costs one probe and at most one compare.
+*/
+struct Keyword {
+	const char * text;
+	size_t length;
+	int tag;
+};
+
+const size_t KEYWORD_SLOTS = 32;
+
+inline size_t keywordHash(const char * text, size_t length){
+	return (static_cast<unsigned char>(text[0])
+		+ static_cast<unsigned char>(text[length - 1])
+		+ length) % KEYWORD_SLOTS;
+}
+
+struct KeywordTable {
+	Keyword slots[KEYWORD_SLOTS];
+
+	KeywordTable(){
+		const Keyword keywords[] = {
+			{"bool", 4, TokenTag::BOOL},
+			{"void", 4, TokenTag::VOID},
+			{"int", 3, TokenTag::INT},
+			{"true", 4, TokenTag::TRUE},
+			{"false", 5, TokenTag::FALSE},
+			{"struct", 6, TokenTag::STRUCT},
+			{"cin", 3, TokenTag::INPUT},
+			{"cout", 4, TokenTag::OUTPUT},
+			{"if", 2, TokenTag::IF},
+			{"else", 4, TokenTag::ELSE},
+			{"while", 5, TokenTag::WHILE},
+			{"return", 6, TokenTag::RETURN},
+		};
+		for (Keyword& slot : slots){ slot = Keyword{"", 0, -1}; }
+		for (const Keyword& kw : keywords){
+			Keyword& slot = slots[keywordHash(kw.text, kw.length)];
+			if (slot.tag != -1){
+				throw InternalError("keyword hash collision");
+			}
+			slot = kw;
+		}
+	}
+
+	// The keyword's tag, or -1 for an ordinary identifier
+	int find(const char * text, size_t length) const {
+		const Keyword& slot = slots[keywordHash(text, length)];
+		if (slot.length != length){ return -1; }
+		if (std::memcmp(slot.text, text, length) != 0){ return -1; }
+		return slot.tag;
+	}
+};
+
+const KeywordTable keywords;
+
+} // end anonymous namespace
+
+LilC_DFAScanner::LilC_DFAScanner(
+	const LilC_Source& sourceIn,
+	TokenBuffer& tokensIn,
+	NameTable& namesIn
+) : source(sourceIn), tokens(tokensIn), names(namesIn){
+	pos = source.data();
+	end = source.data() + source.size();
+}
+
+void LilC_DFAScanner::warn(size_t lineNumIn, size_t charNumIn,
+	std::string msg){
+	std::cerr << lineNumIn << ":" << charNumIn
+		<< " ***WARNING*** " << msg << std::endl;
+}
+
+void LilC_DFAScanner::error(size_t lineNumIn, size_t charNumIn,
+	std::string msg){
+	std::cerr << lineNumIn << ":" << charNumIn
+		<< " ***ERROR*** " << msg << std::endl;
+}
+
+int LilC_DFAScanner::produceNullaryToken(int tag, size_t length){
+	tokens.add(tag, lineNum, charNum);
+	charNum += length;
+	pos += length;
+	return tag;
+}
+
+int LilC_DFAScanner::scanInt(){
+	const char * start = pos;
+	while (pos < end && classOf(*pos) == DIGIT){ pos++; }
+	std::string text(start, static_cast<size_t>(pos - start));
+	double overflow = std::stod(text);
+	int intVal = atoi(text.c_str());
+	if (overflow > INT_MAX){
+		std::string msg = "Integer literal too large;"
+		" using max value";
+		warn(0, 0, msg);
+		intVal = INT_MAX;
+	}
+	tokens.addInt(TokenTag::INTLITERAL, lineNum, charNum, intVal);
+	charNum += text.size();
+	return TokenTag::INTLITERAL;
+}
+
+/*
+* Skip (A|\E)*, the body of a well-formed string literal, where A
+* is any char but newline, quote and backslash and E is a legal
+* escape
+*/
+const char * LilC_DFAScanner::skipStringBody(const char * p){
+	while (p < end){
+		unsigned char c = static_cast<unsigned char>(*p);
+		if (chars.strChar[c]){
+			p++;
+		} else if (c == '\\' && p + 1 < end
+			&& chars.escaped[static_cast<unsigned char>(p[1])]){
+			p += 2;
+		} else {
+			break;
+		}
+	}
+	return p;
+}
+
+/*
+* A string literal, or one of the three malformed literal rules
+* of lilc.l, whichever flex's longest match would pick. Returns
+* the tag to hand back, or NO_TOKEN to keep scanning.
+*/
+int LilC_DFAScanner::scanString(){
+	const char * start = pos;
+	const char * p = skipStringBody(pos + 1);
+
+	if (p < end && *p == '"'){
+		size_t length = static_cast<size_t>(p + 1 - start);
+		tokens.addString(TokenTag::STRINGLITERAL, lineNum, charNum,
+			static_cast<size_t>(start - source.data()), length);
+		charNum += length;
+		pos = p + 1;
+		return TokenTag::STRINGLITERAL;
+	}
+
+	if (p < end && *p == '\\'){
+		const char * q = p + 1;
+		if (q < end && *q != '\n'){
+			// A bad escape: ignored whole if the literal is
+			// closed on this line
+			const char * r = q + 1;
+			while (r < end && *r != '\n' && *r != '"'){ r++; }
+			if (r < end && *r == '"'){
+				error(lineNum, charNum, "string literal with bad escaped character ignored");
+				charNum += static_cast<size_t>(r + 1 - start);
+				pos = r + 1;
+				return TokenTag::END;
+			}
+			q = skipStringBody(q + 1);
+			if (q < end && *q == '\\'){ q++; }
+		}
+		std::string msg = "unterminated string literal with bad"
+		"escaped character ignored";
+		charNum += static_cast<size_t>(q - start);
+		error(lineNum, charNum, msg);
+		pos = q;
+		return NO_TOKEN;
+	}
+
+	error(lineNum, charNum, "unterminated string literal ignored");
+	charNum += static_cast<size_t>(p - start);
+	pos = p;
+	return TokenTag::END;
+}
+
+int LilC_DFAScanner::yylex(){
+	while (pos < end){
+		const char * start = pos;
+		char c = *pos;
+		char next = pos + 1 < end ? pos[1] : '\0';
+		switch (classOf(c)){
+		case SPACE:
+			while (pos < end && classOf(*pos) == SPACE){ pos++; }
+			charNum += static_cast<size_t>(pos - start);
+			break;
+		case NEWLINE:
+			lineNum++;
+			charNum = 1;
+			pos++;
+			break;
+		case LETTER:
+			{
+			while (pos < end && (classOf(*pos) == LETTER
+				|| classOf(*pos) == DIGIT)){
+				pos++;
+			}
+			size_t length = static_cast<size_t>(pos - start);
+			int tag = keywords.find(start, length);
+			if (tag != -1){
+				pos = start;
+				return produceNullaryToken(tag, length);
+			}
+			int id = names.intern(start, length);
+			tokens.addID(TokenTag::ID, lineNum, charNum, id);
+			charNum += length;
+			return TokenTag::ID;
+			}
+		case DIGIT:
+			return scanInt();
+		case QUOTE:
+			{
+			int tag = scanString();
+			if (tag != NO_TOKEN){ return tag; }
+			break;
+			}
+		case SLASH:
+			if (next != '/'){
+				return produceNullaryToken(TokenTag::DIVIDE, 1);
+			}
+			// a // comment
+			// fall through
+		case HASH:
+			// Comment. No need to update charNum, since the
+			// rest of the line is never part of a report
+			while (pos < end && *pos != '\n'){ pos++; }
+			break;
+		case OP:
+			switch (c){
+			case '{': return produceNullaryToken(TokenTag::LCURLY, 1);
+			case '}': return produceNullaryToken(TokenTag::RCURLY, 1);
+			case '(': return produceNullaryToken(TokenTag::LPAREN, 1);
+			case ')': return produceNullaryToken(TokenTag::RPAREN, 1);
+			case ';': return produceNullaryToken(TokenTag::SEMICOLON, 1);
+			case ',': return produceNullaryToken(TokenTag::COMMA, 1);
+			case '.': return produceNullaryToken(TokenTag::DOT, 1);
+			case '*': return produceNullaryToken(TokenTag::TIMES, 1);
+			case '+':
+				if (next == '+'){
+					return produceNullaryToken(TokenTag::PLUSPLUS, 2);
+				}
+				return produceNullaryToken(TokenTag::PLUS, 1);
+			case '-':
+				if (next == '-'){
+					return produceNullaryToken(TokenTag::MINUSMINUS, 2);
+				}
+				return produceNullaryToken(TokenTag::MINUS, 1);
+			case '!':
+				if (next == '='){
+					return produceNullaryToken(TokenTag::NOTEQUALS, 2);
+				}
+				return produceNullaryToken(TokenTag::NOT, 1);
+			case '=':
+				if (next == '='){
+					return produceNullaryToken(TokenTag::EQUALS, 2);
+				}
+				return produceNullaryToken(TokenTag::ASSIGN, 1);
+			case '<':
+				if (next == '<'){
+					return produceNullaryToken(TokenTag::WRITE, 2);
+				}
+				if (next == '='){
+					return produceNullaryToken(TokenTag::LESSEQ, 2);
+				}
+				return produceNullaryToken(TokenTag::LESS, 1);
+			case '>':
+				if (next == '>'){
+					return produceNullaryToken(TokenTag::READ, 2);
+				}
+				if (next == '='){
+					return produceNullaryToken(TokenTag::GREATEREQ, 2);
+				}
+				return produceNullaryToken(TokenTag::GREATER, 1);
+			case '&':
+				if (next == '&'){
+					return produceNullaryToken(TokenTag::AND, 2);
+				}
+				break;
+			case '|':
+				if (next == '|'){
+					return produceNullaryToken(TokenTag::OR, 2);
+				}
+				break;
+			default:
+				break;
+			}
+			// a lone & or |
+			// fall through
+		default:
+			{
+			std::string msg = "Illegal character ";
+			if (c != '\0'){ msg += c; }
+			error(lineNum, charNum, msg);
+			charNum += 1;
+			pos++;
+			break;
+			}
+		}
+	}
+	return TokenTag::END;
+}
+
+} // End namespace LILC
@@ -0,0 +1,54 @@
+#ifndef __LILC_DFA_SCANNER_HPP__
+#define __LILC_DFA_SCANNER_HPP__ 1
+
+#include <cstddef>
+#include <string>
+
+#include "grammar.hh"
+#include "lilc_source.hpp"
+#include "name_table.hpp"
+#include "tokens.hpp"
+
+namespace LILC{
+
+/* Hand-written scanner, an alternative to the flex-generated
+  LilC_Scanner (picked with -fdfa-scanner). It walks the mapped
+  source directly: a character-class table drives the identifier,
+  number and whitespace loops, and keywords are found with a
+  perfect hash on (first char, last char, length) instead of
+  trying each keyword rule. The token contract is that of lilc.l:
+  the same tags and token records, the same positions and the same
+  diagnostics, including the longest-match choices among the
+  malformed string literal rules.
+*/
+class LilC_DFAScanner{
+public:
+	LilC_DFAScanner(const LilC_Source& sourceIn, TokenBuffer& tokensIn,
+		NameTable& namesIn);
+
+	// Appends the next token to the buffer and returns its tag
+	int yylex();
+
+private:
+	// scanString's result when the input it matched is skipped
+	static const int NO_TOKEN = -1;
+
+	int produceNullaryToken(int tag, size_t length);
+	int scanInt();
+	int scanString();
+	const char * skipStringBody(const char * p);
+
+	void warn(size_t lineNumIn, size_t charNumIn, std::string msg);
+	void error(size_t lineNumIn, size_t charNumIn, std::string msg);
+
+	const LilC_Source& source;
+	TokenBuffer& tokens;
+	NameTable& names;
+	const char * pos;
+	const char * end;
+	size_t lineNum = 1;
+	size_t charNum = 1;
+
+}; // end class LilC_DFAScanner
+} /* end namespace */
+#endif /* END __LILC_DFA_SCANNER_HPP__ */
@@ -1,168 +1,424 @@
+#include <algorithm>
+#include <iostream>
 #include <string>
+#include "err.hpp"
 #include "lilc_mips.hpp"
+#include "lilc_peephole.hpp"
 
 namespace LILC{
 
-const std::string LilC_Backend::TRUE = "1";
-const std::string LilC_Backend::FALSE = "0";
-
-const std::string LilC_Backend::FP = "$fp";
-const std::string LilC_Backend::SP = "$sp";
-const std::string LilC_Backend::RA = "$ra";
-const std::string LilC_Backend::V0 = "$v0";
-const std::string LilC_Backend::V1 = "$v1";
-const std::string LilC_Backend::A0 = "$a0";
-const std::string LilC_Backend::T0 = "$t0";
-const std::string LilC_Backend::T1 = "$t1";
-
-void LilC_Backend::generateWithComment(
-	std::string opcode,
-	std::string comment,
-	std::string arg1,
-	std::string arg2,
-	std::string arg3
+const int LilC_Backend::TRUE;
+const int LilC_Backend::FALSE;
+
+const int LilC_Backend::FP;
+const int LilC_Backend::SP;
+const int LilC_Backend::RA;
+const int LilC_Backend::V0;
+const int LilC_Backend::V1;
+const int LilC_Backend::A0;
+const int LilC_Backend::T0;
+const int LilC_Backend::T1;
+const int LilC_Backend::ZERO;
+const std::vector<int> LilC_Backend::ARG_REGS = {
+	MipsReg::A0, MipsReg::A1, MipsReg::A2, MipsReg::A3
+};
+
+// $t2-$t9, then $s0-$s7
+const std::vector<int> LilC_Backend::REG_POOL = {
+	10, 11, 12, 13, 14, 15, 24, 25,
+	16, 17, 18, 19, 20, 21, 22, 23
+};
+
+namespace {
+
+const std::string OP_NAMES[] = {
+	"",
+	"add", "addi", "addu", "addiu", "sub", "subu", "mul", "mult", "div",
+	"mflo", "mfhi",
+	"and", "andi", "or", "ori", "xor", "xori", "nor", "not", "neg",
+	"sll", "srl", "sra", "sllv", "srlv", "srav", "slt", "sltu", "slti",
+	"sltiu",
+	"li", "la", "lw", "sw", "move",
+	"b", "beq", "bne", "blt", "bgt", "ble", "bge", "j", "jal", "jr",
+	"syscall"
+};
+static_assert(sizeof(OP_NAMES) / sizeof(OP_NAMES[0])
+	== static_cast<size_t>(MipsOp::OTHER), "OP_NAMES out of sync with MipsOp");
+
+const std::string REG_NAMES[] = {
+	"$zero", "$at", "$v0", "$v1", "$a0", "$a1", "$a2", "$a3",
+	"$t0", "$t1", "$t2", "$t3", "$t4", "$t5", "$t6", "$t7",
+	"$s0", "$s1", "$s2", "$s3", "$s4", "$s5", "$s6", "$s7",
+	"$t8", "$t9", "$k0", "$k1", "$gp", "$sp", "$fp", "$ra"
+};
+
+} // end anonymous namespace
+
+int LilC_Backend::intern(const std::string& str) {
+	auto found = stringIds.find(str);
+	if (found != stringIds.end()) { return found->second; }
+	int id = static_cast<int>(strings.size());
+	strings.push_back(str);
+	stringIds[str] = id;
+	return id;
+}
+
+int LilC_Backend::internLiteral(const char * literal) {
+	if (literal == nullptr) { return -1; }
+	auto found = literalIds.find(literal);
+	if (found != literalIds.end()) { return found->second; }
+	int id = intern(literal);
+	literalIds[literal] = id;
+	return id;
+}
+
+MipsOperand LilC_Backend::symbol(const std::string& text) {
+	MipsOperand result;
+	result.kind = MipsOperand::Kind::SYM;
+	result.value = intern(text);
+	return result;
+}
+
+MipsOperand LilC_Backend::global(const std::string& name) {
+	MipsOperand result;
+	result.kind = MipsOperand::Kind::GLOBAL;
+	result.value = intern(name);
+	return result;
+}
+
+void LilC_Backend::emit(
+	MipsInstr::Form form,
+	MipsOp op,
+	MipsOperand arg1,
+	MipsOperand arg2,
+	MipsOperand arg3,
+	const char * comment
 ) {
-        int space = MAXLEN - opcode.length() + 2;
-
-        out << "\t" + opcode;
-        if (arg1 != "") {
-            for (int k = 1; k <= space; k++)
-                out << " ";
-            out << arg1;
-            if (arg2 != "") {
-                out << ", " + arg2;
-                if (arg3 != "")
-                    out << ", " + arg3;
-            }
-        }
-        if (comment != "")
-            out << "\t\t#" + comment;
-	out << std::endl;
+	MipsInstr instr;
+	instr.form = form;
+	instr.op = op;
+	instr.arg1 = arg1;
+	instr.arg2 = arg2;
+	instr.arg3 = arg3;
+	instr.comment = internLiteral(comment);
+	code.push_back(instr);
+}
+
+void LilC_Backend::generate(MipsOp op, const char * comment) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand(), MipsOperand(),
+		MipsOperand(), comment);
+}
+
+void LilC_Backend::generate(MipsOp op, int rd, const char * comment) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rd), MipsOperand(),
+		MipsOperand(), comment);
+}
+
+void LilC_Backend::generate(MipsOp op, int rd, int rs, const char * comment) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rd),
+		MipsOperand::reg(rs), MipsOperand(), comment);
 }
 
 void LilC_Backend::generate(
-	const std::string opcode,
-	const std::string arg1,
-	const std::string arg2,
-	const std::string arg3) {
-        int space = MAXLEN - opcode.length() + 2;
-
-        out << "\t" + opcode;
-        if (arg1 != "") {
-            for (int k = 1; k <= space; k++)
-                out << " ";
-            out << arg1;
-            if (arg2 != "") {
-                out << ", " + arg2;
-                if (arg3 != "")
-                    out << ", " + arg3;
-            }
-        }
-	out << std::endl;
+	MipsOp op,
+	int rd,
+	int rs,
+	int rt,
+	const char * comment
+) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rd),
+		MipsOperand::reg(rs), MipsOperand::reg(rt), comment);
+}
+
+void LilC_Backend::generate(
+	MipsOp op,
+	int rd,
+	MipsOperand target,
+	const char * comment
+) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rd), target,
+		MipsOperand(), comment);
+}
+
+void LilC_Backend::generateImm(MipsOp op, int rt, int imm, const char * comment) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rt),
+		MipsOperand::imm(imm), MipsOperand(), comment);
+}
+
+void LilC_Backend::generateImm(
+	MipsOp op,
+	int rt,
+	int rs,
+	int imm,
+	const char * comment
+) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rt),
+		MipsOperand::reg(rs), MipsOperand::imm(imm), comment);
+}
+
+void LilC_Backend::generateBranch(MipsOp op, int rs, int rt, MipsOperand target) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rs),
+		MipsOperand::reg(rt), target, nullptr);
+}
+
+void LilC_Backend::generateBranchImm(
+	MipsOp op,
+	int rs,
+	int imm,
+	MipsOperand target
+) {
+	emit(MipsInstr::Form::PLAIN, op, MipsOperand::reg(rs),
+		MipsOperand::imm(imm), target, nullptr);
+}
+
+void LilC_Backend::generateJump(MipsOp op, MipsOperand target, const char * comment) {
+	emit(MipsInstr::Form::PLAIN, op, target, MipsOperand(), MipsOperand(),
+		comment);
 }
 
 void LilC_Backend::generateIndexed(
-	std::string opcode,
-	std::string arg1,
-	std::string arg2,
-	int arg3,
-	std::string comment=""
+	MipsOp op,
+	int rt,
+	int base,
+	int offset,
+	const char * comment
 ) {
-        int space = MAXLEN - opcode.length() + 2;
+	emit(MipsInstr::Form::INDEXED, op, MipsOperand::reg(rt),
+		MipsOperand::reg(base), MipsOperand(), comment);
+	code.back().offset = offset;
+}
+
+void LilC_Backend::genComment(const char * comment) {
+	generate(MipsOp::NONE, comment);
+}
 
-	out << "\t" << opcode;
-	for (int k = 1; k <= space; k++) {
-		out << " ";
+void LilC_Backend::genDirective(const char * text) {
+	generate(MipsOp::OTHER);
+	code.back().text = internLiteral(text);
+}
+
+void LilC_Backend::renderOperand(
+	const MipsOperand& operand,
+	std::string& text
+) const {
+	switch (operand.kind) {
+	case MipsOperand::Kind::NONE:
+		break;
+	case MipsOperand::Kind::REG:
+		text += REG_NAMES[operand.value];
+		break;
+	case MipsOperand::Kind::IMM:
+		text += std::to_string(operand.value);
+		break;
+	case MipsOperand::Kind::LABEL:
+		text += ".L";
+		text += std::to_string(operand.value);
+		break;
+	case MipsOperand::Kind::SYM:
+		text += strings[static_cast<size_t>(operand.value)];
+		break;
+	case MipsOperand::Kind::GLOBAL:
+		text += "_";
+		text += strings[static_cast<size_t>(operand.value)];
+		break;
+	default:
+		throw InternalError("Unknown operand kind");
 	}
-	out << arg1 << ", " << arg3 << "(" << arg2 << ")";
-	if (comment != "")
-		out << "\t#" + comment;
-	out << std::endl;
 }
 
-void LilC_Backend::generateLabeled(
-	std::string label,
-	std::string opcode,
-        std::string comment,
-	std::string arg1
-) {
-	int space = MAXLEN - opcode.length() + 2;
+void LilC_Backend::render(const MipsInstr& instr, std::string& text) const {
+	const std::string& opcode = instr.op == MipsOp::OTHER
+		? strings[static_cast<size_t>(instr.text)]
+		: OP_NAMES[static_cast<int>(instr.op)];
+	const std::string noComment;
+	const std::string& comment = instr.comment < 0 ? noComment
+		: strings[static_cast<size_t>(instr.comment)];
+	int space = MAXLEN - static_cast<int>(opcode.length()) + 2;
+	std::string padding(static_cast<size_t>(std::max(space, 0)), ' ');
 
-	out << label << ":";
-	out << "\t" << opcode;
-	if (arg1 != "") {
-		for (int k = 1; k <= space; k++) {
-			out << " ";
+	switch (instr.form) {
+	case MipsInstr::Form::PLAIN:
+		text += "\t";
+		text += opcode;
+		if (!instr.arg1.empty()) {
+			text += padding;
+			renderOperand(instr.arg1, text);
+			if (!instr.arg2.empty()) {
+				text += ", ";
+				renderOperand(instr.arg2, text);
+				if (!instr.arg3.empty()) {
+					text += ", ";
+					renderOperand(instr.arg3, text);
+				}
+			}
+		}
+		if (!comment.empty()) {
+			text += "\t\t#";
+			text += comment;
 		}
-		out << arg1;
-        }
-        if (comment != "") { out << "\t# " << comment; }
-	out << std::endl;
+		break;
+	case MipsInstr::Form::INDEXED:
+		text += "\t";
+		text += opcode;
+		text += padding;
+		renderOperand(instr.arg1, text);
+		text += ", ";
+		text += std::to_string(instr.offset);
+		text += "(";
+		renderOperand(instr.arg2, text);
+		text += ")";
+		if (!comment.empty()) {
+			text += "\t#";
+			text += comment;
+		}
+		break;
+	case MipsInstr::Form::LABELED:
+		renderOperand(instr.label, text);
+		text += ":\t";
+		text += opcode;
+		if (!instr.arg1.empty()) {
+			text += padding;
+			renderOperand(instr.arg1, text);
+		}
+		if (!comment.empty()) {
+			text += "\t# ";
+			text += comment;
+		}
+		break;
+	case MipsInstr::Form::LABEL:
+		renderOperand(instr.label, text);
+		text += ":";
+		if (!comment.empty()) {
+			text += "\t\t# ";
+			text += comment;
+		}
+		break;
+	case MipsInstr::Form::RAW:
+		text += strings[static_cast<size_t>(instr.text)];
+		break;
+	default:
+		throw InternalError("Unknown instruction form");
+	}
+	text += "\n";
 }
 
-void LilC_Backend::genPush(std::string s) {
-	generateIndexed("sw", s, SP, 0, "PUSH");
-	generate("subu", SP, SP, "4");
+void LilC_Backend::flush() {
+	if (opts.peephole) {
+		LilC_Peephole peephole;
+		peephole.run(code);
+		if (opts.peepholeStats) {
+			peephole.printStats(std::cerr);
+		}
+	}
+	std::string text;
+	text.reserve(code.size() * 32);
+	for (const MipsInstr& instr : code) {
+		render(instr, text);
+	}
+	out.write(text.data(), static_cast<std::streamsize>(text.size()));
+	out.flush();
+	code.clear();
 }
 
-void LilC_Backend::genPop(std::string s) {
-	generateIndexed("lw", s, SP, 4, "POP");
-	generate("addu", SP, SP, "4");
+void LilC_Backend::genPush(int reg) {
+	generateIndexed(MipsOp::SW, reg, SP, 0, "PUSH");
+	generateImm(MipsOp::SUBU, SP, SP, 4);
+	stackDepth += 4;
 }
 
-void LilC_Backend::genLabel(std::string label, std::string comment) {
-	out << label << ":";
-	if (comment != "")
-		out << "\t\t" << "# " << comment;
-	out << std::endl;
+void LilC_Backend::genPop(int reg) {
+	generateIndexed(MipsOp::LW, reg, SP, 4, "POP");
+	generateImm(MipsOp::ADDU, SP, SP, 4);
+	stackDepth -= 4;
 }
 
-std::string LilC_Backend::nextLabel() {
-	std::string tmp = ".L" + std::to_string(currLabel);
-	currLabel++;
-	return(tmp);
+void LilC_Backend::genReserve(int bytes) {
+	generateImm(MipsOp::SUBU, SP, SP, bytes);
+	stackDepth += bytes;
 }
 
-void LilC_Backend::genGlobalVar(std::string name, int size) {
-	out << "\t.data\n\t.align 2\n_" << name
-	    << ": .space " <<size << std::endl;
+void LilC_Backend::genRelease(int bytes) {
+	generateImm(MipsOp::ADDU, SP, SP, bytes);
+	stackDepth -= bytes;
 }
 
-void LilC_Backend::genWrite(std::string type) {
-	genPop(A0);
-	if (type == "int" || type == "bool") {
-		generate("li", V0, "1");
-	} else if (type == "string") {
-		generate("li", V0, "4");
+void LilC_Backend::checkStackDepth(int expected, std::string where) const {
+#ifndef NDEBUG
+	if (stackDepth != expected) {
+		throw InternalError(where + " left the stack "
+			+ std::to_string(stackDepth - expected) + " bytes deeper");
 	}
-	generate("syscall");
+#endif
 }
 
-void LilC_Backend::genStringLit(std::string value) {
-	out << "\t.data" << std::endl;
-	std::string label = nextLabel();
-	generateLabeled(label, ".asciiz " + value, "");
-	out << "\t.text" << std::endl;
-	generate("la", T0, label);
+void LilC_Backend::genLabel(MipsOperand label, const char * comment) {
+	emit(MipsInstr::Form::LABEL, MipsOp::NONE, MipsOperand(), MipsOperand(),
+		MipsOperand(), comment);
+	code.back().label = label;
+}
+
+void LilC_Backend::genLabel(MipsOperand label, const std::string& comment) {
+	genLabel(label);
+	code.back().comment = intern(comment);
+}
+
+MipsOperand LilC_Backend::nextLabel() {
+	return MipsOperand::label(currLabel++);
+}
+
+void LilC_Backend::genGlobalVar(const std::string& name, int size) {
+	MipsInstr instr;
+	instr.form = MipsInstr::Form::RAW;
+	instr.text = intern("\t.data\n\t.align 2\n_" + name
+		+ ": .space " + std::to_string(size));
+	code.push_back(instr);
+}
+
+void LilC_Backend::genWrite(bool isString, int reg) {
+	if (reg != A0) {
+		generate(MipsOp::MOVE, A0, reg);
+	}
+	generateImm(MipsOp::LI, V0, isString ? 4 : 1);
+	generate(MipsOp::SYSCALL);
+}
+
+void LilC_Backend::genStringLit(const std::string& value) {
+	genStringLitAddr(T0, value);
 	genPush(T0);
 }
 
+void LilC_Backend::genStringLitAddr(int reg, const std::string& value) {
+	MipsInstr directive;
+	directive.form = MipsInstr::Form::RAW;
+	directive.text = internLiteral("\t.data");
+	code.push_back(directive);
+	MipsOperand label = nextLabel();
+	MipsInstr literal;
+	literal.form = MipsInstr::Form::LABELED;
+	literal.op = MipsOp::OTHER;
+	literal.label = label;
+	literal.text = intern(".asciiz " + value);
+	code.push_back(literal);
+	directive.text = internLiteral("\t.text");
+	code.push_back(directive);
+	generate(MipsOp::LA, reg, label);
+}
+
 void LilC_Backend::genIntLit(int value) {
-	generate("li", T0, std::to_string(value));
+	generateImm(MipsOp::LI, T0, value);
 	genPush(T0);
 }
 
 void LilC_Backend::genBoolLit(bool value) {
-	std::string boolVal = value ? TRUE : FALSE;
-	generate("li", T0, boolVal);
+	generateImm(MipsOp::LI, T0, value ? TRUE : FALSE);
 	genPush(T0);
 }
 
-void LilC_Backend::genAddr(std::string id, bool isGlobal, int offset) {
+void LilC_Backend::genAddr(const std::string& id, bool isGlobal, int offset) {
 	if (isGlobal) {
-		generate("la", T0, "_" + id);
+		generate(MipsOp::LA, T0, global(id));
 	} else {
-		generateIndexed("la", T0, FP, offset);
+		generateIndexed(MipsOp::LA, T0, FP, offset);
 	}
 	genPush(T0);
 }
@@ -170,40 +426,186 @@ void LilC_Backend::genAddr(std::string id, bool isGlobal, int offset) {
 void LilC_Backend::genAssign() {
 	genPop(T1);
 	genPop(T0);
-	generateIndexed("sw", T0, T1, 0);
+	generateIndexed(MipsOp::SW, T0, T1, 0);
 	genPush(T0);
 }
 
-void LilC_Backend::genLoadId(std::string id, bool isGlobal, int offset) {
+void LilC_Backend::genLoadId(const std::string& id, bool isGlobal, int offset) {
+	genLoad(T0, id, isGlobal, offset);
+	genPush(T0);
+}
+
+void LilC_Backend::genLoad(int reg, const std::string& id, bool isGlobal, int offset) {
 	if (isGlobal) {
-		generate("lw", T0, "_" + id);
+		generate(MipsOp::LW, reg, global(id));
 	} else {
-		generateIndexed("lw", T0, FP, offset);
+		generateIndexed(MipsOp::LW, reg, FP, offset);
+	}
+}
+
+void LilC_Backend::genStore(int reg, const std::string& id, bool isGlobal, int offset) {
+	if (isGlobal) {
+		generate(MipsOp::SW, reg, global(id));
+	} else {
+		generateIndexed(MipsOp::SW, reg, FP, offset);
 	}
-	genPush(T0);
 }
 
 void LilC_Backend::genNegativeNum() {
-	generateWithComment("li", "UnaryMinusNode", T0, "-1");
+	generateImm(MipsOp::LI, T0, -1, "UnaryMinusNode");
 	genPop(T1);
 	genMult(T0, T1, T0);
 	genPush(T0);
 }
 
-void LilC_Backend::genMult(std::string arg1, std::string arg2, std::string result) {
-	generate("mult", arg1, arg2);
-	generate("mflo", result, "");
+void LilC_Backend::genMult(int arg1, int arg2, int result) {
+	generate(MipsOp::MULT, arg1, arg2);
+	generate(MipsOp::MFLO, result);
 }
 
 void LilC_Backend::genNot() {
 	genPop(T0);
-	generateWithComment("xori", "Not Operation", T0, T0, "1");
+	generateImm(MipsOp::XORI, T0, T0, 1, "Not Operation");
 	genPush(T0);
 }
 
-void LilC_Backend::genDiv(std::string arg1, std::string arg2, std::string result) {
-	generate("div", arg1, arg2);
-	generate("mflo", result, "");
+void LilC_Backend::genDiv(int arg1, int arg2, int result) {
+	generate(MipsOp::DIV, arg1, arg2);
+	generate(MipsOp::MFLO, result);
+}
+
+void LilC_Backend::genDivPow2(int reg, int scratch, int bits) {
+	// An arithmetic shift rounds down, so bias negative
+	// dividends by 2^bits - 1 first
+	generateImm(MipsOp::SRA, scratch, reg, 31);
+	generateImm(MipsOp::SRL, scratch, scratch, 32 - bits);
+	generate(MipsOp::ADD, reg, reg, scratch);
+	generateImm(MipsOp::SRA, reg, reg, bits);
+}
+
+void LilC_Backend::genFnEntry(const std::string& name, int formalsSize, int localsSize) {
+	LilC_Frame frame;
+	frame.stackFormalsSize = formalsSize;
+	frame.localsSize = localsSize;
+	genFnEntry(name, frame);
+}
+
+void LilC_Backend::genFnExit(const std::string& name, int formalsSize) {
+	LilC_Frame frame;
+	frame.stackFormalsSize = formalsSize;
+	genFnExit(name, frame);
+}
+
+void LilC_Backend::genFnEntry(const std::string& name, const LilC_Frame& frame) {
+	if (name == "main") {
+		genDirective(".text");
+		genDirective(".globl main");
+		genLabel(symbol(name), "Method entry");
+		genLabel(symbol("_start"), "add __start for main only");
+	} else {
+		genDirective(".text");
+		genLabel(fnLabel(name), name + " function entry");
+	}
+
+	if (frame.saveRA) { genPush(RA); }
+	if (!frame.useFP) { return; }
+	int saved = frame.saveRA ? 8 : 4;
+	genPush(FP);
+	generateImm(MipsOp::ADDU, FP, SP, frame.stackFormalsSize + saved);
+	generateImm(MipsOp::SUBU, SP, SP, frame.localsSize);
+}
+
+void LilC_Backend::genFnExit(const std::string& name, const LilC_Frame& frame) {
+	genComment("#FUNCTION EXIT");
+	genLabel(fnExitLabel(name));
+	if (frame.useFP) {
+		int fpSlot = frame.stackFormalsSize;
+		if (frame.saveRA) {
+			generateIndexed(MipsOp::LW, RA, FP, fpSlot * -1, "load return address");
+			fpSlot += 4;
+		}
+		generate(MipsOp::MOVE, T0, FP, "save control link");
+		generateIndexed(MipsOp::LW, FP, FP, fpSlot * -1, "restore FP");
+		generate(MipsOp::MOVE, SP, T0, "restore SP");
+	} else if (frame.saveRA) {
+		genPop(RA);
+	}
+
+	if (name == "main") {
+		generateImm(MipsOp::LI, V0, 10, "load exit code for syscall");
+		generate(MipsOp::SYSCALL, "only do this for main");
+	} else {
+		generate(MipsOp::JR, RA, "return");
+	}
+}
+
+MipsOperand LilC_Backend::fnLabel(const std::string& name) {
+	return name == "main" ? symbol(name) : global(name);
+}
+
+MipsOperand LilC_Backend::fnExitLabel(const std::string& name) {
+	return symbol("_" + name + "_Exit");
+}
+
+int LilC_Backend::poolIndex(int reg) const {
+	for (size_t i = 0; i < REG_POOL.size(); i++) {
+		if (REG_POOL[i] == reg) { return static_cast<int>(i); }
+	}
+	return -1;
+}
+
+int LilC_Backend::allocReg() {
+	for (size_t i = 0; i < REG_POOL.size(); i++) {
+		if (!regBusy[i]) {
+			regBusy[i] = true;
+			return REG_POOL[i];
+		}
+	}
+	throw InternalError("Out of registers: the expression "
+		"should have been spilled");
+}
+
+void LilC_Backend::claimReg(int reg) {
+	int idx = poolIndex(reg);
+	if (idx < 0) { return; }
+	if (regBusy[static_cast<size_t>(idx)]) {
+		throw InternalError("Claimed busy register "
+			+ REG_NAMES[static_cast<size_t>(reg)]);
+	}
+	regBusy[static_cast<size_t>(idx)] = true;
+}
+
+void LilC_Backend::freeReg(int reg) {
+	int idx = poolIndex(reg);
+	if (idx < 0) { return; }
+	regBusy[static_cast<size_t>(idx)] = false;
+}
+
+int LilC_Backend::freeRegCount() const {
+	int count = 0;
+	for (bool busy : regBusy) {
+		if (!busy) { count++; }
+	}
+	return count;
+}
+
+std::vector<int> LilC_Backend::saveLiveRegs() {
+	std::vector<int> saved;
+	for (size_t i = 0; i < REG_POOL.size(); i++) {
+		if (regBusy[i]) {
+			genPush(REG_POOL[i]);
+			regBusy[i] = false;
+			saved.push_back(REG_POOL[i]);
+		}
+	}
+	return saved;
+}
+
+void LilC_Backend::restoreLiveRegs(const std::vector<int>& saved) {
+	for (auto itr = saved.rbegin(); itr != saved.rend(); ++itr) {
+		genPop(*itr);
+		claimReg(*itr);
+	}
 }
 
 } // End namespace LILC
@@ -1,165 +1,414 @@
 #ifndef LILC_MIPS_INCLUDE
+#define LILC_MIPS_INCLUDE
 
 #include <string>
 #include <fstream>
+#include <unordered_map>
+#include <vector>
+#include "lilc_options.hpp"
 
 namespace LILC{
 
+// **************************************************************
+// Opcodes the code generators use. Anything else that is passed
+// to generate (directives like ".text") is kept as OTHER along
+// with its interned text.
+// **************************************************************
+enum class MipsOp : unsigned char {
+	NONE,	// comment-only line
+	ADD, ADDI, ADDU, ADDIU, SUB, SUBU, MUL, MULT, DIV, MFLO, MFHI,
+	AND, ANDI, OR, ORI, XOR, XORI, NOR, NOT, NEG,
+	SLL, SRL, SRA, SLLV, SRLV, SRAV, SLT, SLTU, SLTI, SLTIU,
+	LI, LA, LW, SW, MOVE,
+	B, BEQ, BNE, BLT, BGT, BLE, BGE, J, JAL, JR, SYSCALL,
+	OTHER
+};
+
+// **************************************************************
+// An instruction operand: a register number, an immediate, a
+// compiler label (.L<id>), or an interned symbol. A SYM is
+// written as interned; a GLOBAL is a Lil'C global or function
+// name, written with the leading underscore the backend gives
+// those. Labels and symbols come from the backend (nextLabel,
+// symbol, global, fnLabel), which does the interning.
+// **************************************************************
+struct MipsOperand {
+	enum class Kind : unsigned char { NONE, REG, IMM, LABEL, SYM, GLOBAL };
+	Kind kind = Kind::NONE;
+	int value = 0;
+
+	static MipsOperand reg(int num) { return {Kind::REG, num}; }
+	static MipsOperand imm(int num) { return {Kind::IMM, num}; }
+	static MipsOperand label(int id) { return {Kind::LABEL, id}; }
+
+	bool empty() const { return kind == Kind::NONE; }
+	bool isReg() const { return kind == Kind::REG; }
+	bool operator==(const MipsOperand& other) const {
+		return kind == other.kind && value == other.value;
+	}
+	bool operator!=(const MipsOperand& other) const {
+		return !(*this == other);
+	}
+};
+
+// **************************************************************
+// One line of generated assembly. The backend keeps these in a
+// buffer until flush() so the peephole optimizer can rewrite the
+// code before any text is written. form records which generate
+// method produced the line, since each formats differently.
+// Strings (comments, directive text) are interned by the
+// backend and referred to by id; -1 means none.
+// **************************************************************
+struct MipsInstr {
+	enum class Form : unsigned char {
+		PLAIN,   // op arg1, arg2, arg3    (generate[WithComment])
+		INDEXED, // op arg1, offset(arg2)  (generateIndexed)
+		LABELED, // label: op arg1         (generateLabeled)
+		LABEL,   // label:                 (genLabel)
+		RAW      // verbatim text, e.g. directives
+	};
+	Form form = Form::PLAIN;
+	MipsOp op = MipsOp::NONE;
+	MipsOperand label;
+	MipsOperand arg1;
+	MipsOperand arg2;
+	MipsOperand arg3;
+	int offset = 0;
+	int text = -1;
+	int comment = -1;
+};
+
+// MIPS register numbers the backend and peephole optimizer
+// refer to directly. NONE stands for no register.
+namespace MipsReg {
+	const int NONE = -1;
+	const int ZERO = 0;
+	const int V0 = 2;
+	const int V1 = 3;
+	const int A0 = 4;
+	const int A1 = 5;
+	const int A2 = 6;
+	const int A3 = 7;
+	const int T0 = 8;
+	const int T1 = 9;
+	const int SP = 29;
+	const int FP = 30;
+	const int RA = 31;
+}
+
 // **************************************************************
 // Provides constants and operations useful for code
 // generation.
 //
 // The constants are:
-//     Registers: FP, SP, RA, V0, V1, A0, T0, T1
+//     Registers: FP, SP, RA, V0, V1, A0, T0, T1, ZERO
 //     Values: TRUE, FALSE
 //
 // The operations are include various "generate" methods to
 // print nicely formatted assembly code:
-//     generateWithComment
 //     generate
+//     generateImm
+//     generateBranch
+//     generateJump
 //     generateIndexed
-//     generateLabeled
+//     genComment
 //     genPush
 //     genPop
 //     genLabel
 // and a method nextLabel to create and return a new label.
+// They take the opcode as a MipsOp, registers as MipsReg
+// numbers and immediates as ints, and store them straight
+// into the instruction buffer; nothing is formatted until
+// flush() writes the code to out.
+//
+// When expressions are evaluated in registers rather than on
+// the stack, allocReg/freeReg hand out the temporaries.
 //
 // ***************************************************************
-class LilC_Backend {
-public:
-	// file into which generated code is written
 
+// What a function's prologue and epilogue have to set up. The
+// AST code generators always build the full frame; the IR
+// backend leaves out the parts a function does not use.
+struct LilC_Frame {
+	// the function makes calls, so RA must survive them
+	bool saveRA = true;
+	// FP is needed to reach stack formals or spill slots
+	bool useFP = true;
+	// bytes of formals the caller pushed
+	int stackFormalsSize = 0;
+	// bytes reserved below the saved registers
+	int localsSize = 0;
+};
 
+class LilC_Backend {
+public:
 	// values of true and false
-	static const std::string TRUE;
-	static const std::string FALSE;
+	static const int TRUE = 1;
+	static const int FALSE = 0;
 
 	// registers
-	static const std::string FP;
-	static const std::string SP;
-	static const std::string RA;
-	static const std::string V0;
-	static const std::string V1;
-	static const std::string A0;
-	static const std::string T0;
-	static const std::string T1;
+	static const int FP = MipsReg::FP;
+	static const int SP = MipsReg::SP;
+	static const int RA = MipsReg::RA;
+	static const int V0 = MipsReg::V0;
+	static const int V1 = MipsReg::V1;
+	static const int A0 = MipsReg::A0;
+	static const int T0 = MipsReg::T0;
+	static const int T1 = MipsReg::T1;
+	static const int ZERO = MipsReg::ZERO;
+	// where the IR backend passes the first formals
+	static const std::vector<int> ARG_REGS;
 
+	// file into which generated code is written
 	std::ostream& out;
 
-	LilC_Backend(std::ostream& outIn) : out(outIn){
+	LilC_Backend(std::ostream& outIn, const LilC_Options& optsIn)
+	: out(outIn), opts(optsIn), regBusy(REG_POOL.size(), false){
 		this->currLabel = 0;
 	}
 
+	const LilC_Options& options() const { return opts; }
+
+	// ******************************************************
+	// flush
+	//    run the peephole optimizer over the buffered code
+	//    (if enabled) and write it all to out
+	// ******************************************************
+	void flush();
+
 	// *******************************************************
 	// *******************************************************
 	// GENERATE OPERATIONS
+	//    Each takes an optional comment, which must be a
+	//    string literal (it is interned by address).
 	// *******************************************************
 	// *******************************************************
 
 	// *******************************************************
-	// generateWithComment
-	//    takes an op code, comment, and 0 to 3 string args
-	//    writes formatted, commented code (ending with new
-	//    line)
+	// generate
+	//    op                  (e.g. syscall)
+	//    op rd               (mflo, jr)
+	//    op rd, rs           (move, mult, div, ...)
+	//    op rd, rs, rt       (add, sub, slt, ...)
+	//    op rd, target       (la, lw, sw of a global)
 	// *******************************************************
-	void generateWithComment(
-		std::string opcode,
-		std::string comment,
-		std::string arg1="",
-		std::string arg2="",
-		std::string arg3="");
+	void generate(MipsOp op, const char * comment = nullptr);
+	void generate(MipsOp op, int rd, const char * comment = nullptr);
+	void generate(MipsOp op, int rd, int rs,
+		const char * comment = nullptr);
+	void generate(MipsOp op, int rd, int rs, int rt,
+		const char * comment = nullptr);
+	void generate(MipsOp op, int rd, MipsOperand target,
+		const char * comment = nullptr);
 
-	// ******************************************************
-	// generate
-	//    takes an op code, and 0 to 3 string args
-	//    writes formatted code (ending with new line)
-	// ******************************************************
-	void generate(
-		const std::string opcode,
-		const std::string arg1="",
-		const std::string arg2="",
-		const std::string arg3="");
+	// *******************************************************
+	// generateImm
+	//    op rt, imm          (li)
+	//    op rt, rs, imm      (addiu, sll, xori, ...)
+	// *******************************************************
+	void generateImm(MipsOp op, int rt, int imm,
+		const char * comment = nullptr);
+	void generateImm(MipsOp op, int rt, int rs, int imm,
+		const char * comment = nullptr);
+
+	// *******************************************************
+	// generateBranch
+	//    op rs, rt, target   (beq, bne, blt, ...)
+	// generateBranchImm
+	//    op rs, imm, target
+	// generateJump
+	//    op target           (j, b, jal)
+	// *******************************************************
+	void generateBranch(MipsOp op, int rs, int rt, MipsOperand target);
+	void generateBranchImm(MipsOp op, int rs, int imm, MipsOperand target);
+	void generateJump(MipsOp op, MipsOperand target,
+		const char * comment = nullptr);
 
 	// *******************************************************
 	// generateIndexed
-	//    takes an op code, target register T1 (as string),
-	//    indexed register T2 (as string), - offset xx (int),
-	//    and optional comment
-	//    writes formatted code (ending with new line) of the form
-	//    op T1, xx(T2) #comment
+	//    op rt, offset(base) #comment
 	// *******************************************************
-	void generateIndexed(
-		std::string opcode,
-		std::string arg1,
-		std::string arg2,
-		int arg3,
-		std::string comment);
+	void generateIndexed(MipsOp op, int rt, int base, int offset,
+		const char * comment = nullptr);
 
 	// *******************************************************
-	// generateLabeled (string args -- perhaps empty)
-	//    takes a label, op code, comment, and arg
-	//    writes formatted code (ending with new line)
+	// genComment
+	//    a line holding only the comment
+	// genDirective
+	//    an assembler directive such as .text
 	// *******************************************************
-	void generateLabeled(
-		std::string label,
-		std::string opcode,
-		std::string comment,
-		std::string arg1 = "");
+	void genComment(const char * comment);
+	void genDirective(const char * text);
 
 	// ******************************************************
 	// genPush
-	//    generate code to push the given value onto the stack
+	//    generate code to push the given register onto the
+	//    stack
 	// ******************************************************
-	void genPush(std::string s);
+	void genPush(int reg);
 
 	// ******************************************************
 	// genPop
 	//    generate code to pop into the given register
 	// ******************************************************
-	void genPop(std::string s);
+	void genPop(int reg);
+
+	// ******************************************************
+	// genReserve / genRelease
+	//    move SP down / back up by bytes, e.g. for the
+	//    locals of a nested block
+	// calleePopped
+	//    note that a call's callee took its bytes of
+	//    arguments off the stack on return
+	// ******************************************************
+	void genReserve(int bytes);
+	void genRelease(int bytes);
+	void calleePopped(int bytes) { stackDepth -= bytes; }
+
+	// ******************************************************
+	// STACK DEPTH
+	//    Bytes the code generated so far keeps on the stack,
+	//    counted by the operations above. A statement must
+	//    leave the depth where it found it, or a loop around
+	//    it grows the stack every iteration; checkStackDepth
+	//    throws an InternalError naming the statement if it
+	//    did not. The check is skipped when NDEBUG is set.
+	// ******************************************************
+	int getStackDepth() const { return stackDepth; }
+	// Code at a label reached only by jumps starts from the
+	// depth at those jumps, not where the code before it ended
+	void setStackDepth(int bytes) { stackDepth = bytes; }
+	void checkStackDepth(int expected, std::string where) const;
 
 	// ******************************************************
 	// genLabel
 	//   given:    label L and comment (comment may be empty)
 	//   generate: L:    # comment
 	// ******************************************************
-	void genLabel(
-		std::string label,
-		std::string comment="");
+	void genLabel(MipsOperand label, const char * comment = nullptr);
+	void genLabel(MipsOperand label, const std::string& comment);
 
 	// ******************************************************
 	// Return a different label each time:
-	//        L0 L1 L2, etc.
+	//        .L0 .L1 .L2, etc.
+	// ******************************************************
+	MipsOperand nextLabel();
+
+	// ******************************************************
+	// symbol
+	//    an operand written as text, e.g. an exit label
+	// global
+	//    the operand naming Lil'C global or function name
 	// ******************************************************
-	std::string nextLabel();
+	MipsOperand symbol(const std::string& text);
+	MipsOperand global(const std::string& name);
 
 	// ******************************************************
 	// Generate global variable:
 	//
 	// ******************************************************
-	void genGlobalVar(std::string name, int size);
+	void genGlobalVar(const std::string& name, int size);
+
+	void genWrite(bool isString, int reg);
 
-	void genWrite(std::string type);
+	void genStringLit(const std::string& value);
 
-	void genStringLit(std::string value);
+	void genStringLitAddr(int reg, const std::string& value);
 
 	void genIntLit(int value);
 
 	void genBoolLit(bool value);
 
-	void genAddr(std::string id, bool isGlobal, int offset);
+	void genAddr(const std::string& id, bool isGlobal, int offset);
 
 	void genAssign();
 
-	void genLoadId(std::string id, bool isGlobal, int offset);
+	void genLoadId(const std::string& id, bool isGlobal, int offset);
+
+	void genLoad(int reg, const std::string& id, bool isGlobal, int offset);
+
+	void genStore(int reg, const std::string& id, bool isGlobal, int offset);
 
 	void genNegativeNum();
 
-	void genMult(std::string arg1, std::string arg2, std::string result);
+	void genMult(int arg1, int arg2, int result);
 
 	void genNot();
 
-	void genDiv(std::string arg1, std::string arg2, std::string result);
+	void genDiv(int arg1, int arg2, int result);
+
+	// ******************************************************
+	// genDivPow2
+	//    reg = reg / 2^bits, rounding toward zero; clobbers
+	//    scratch
+	// ******************************************************
+	void genDivPow2(int reg, int scratch, int bits);
+
+	// ******************************************************
+	// genFnEntry
+	//    function label and prologue: save RA and the control
+	//    link, point FP at the first formal and reserve
+	//    localsSize bytes
+	// genFnExit
+	//    exit label and epilogue for the same function
+	// The LilC_Frame overloads save only what frame asks for;
+	// FP then points at the first stack formal.
+	// fnLabel
+	//    the label a call to function name jumps to
+	// fnExitLabel
+	//    the label a return from function name jumps to
+	// ******************************************************
+	void genFnEntry(const std::string& name, int formalsSize, int localsSize);
+	void genFnExit(const std::string& name, int formalsSize);
+	void genFnEntry(const std::string& name, const LilC_Frame& frame);
+	void genFnExit(const std::string& name, const LilC_Frame& frame);
+	MipsOperand fnLabel(const std::string& name);
+	MipsOperand fnExitLabel(const std::string& name);
+
+	// *******************************************************
+	// *******************************************************
+	// REGISTER ALLOCATION
+	//    Only used when options().regAlloc is set. T0 and T1
+	//    are kept out of the pool since the stack machine
+	//    sequences use them as scratch.
+	// *******************************************************
+	// *******************************************************
+
+	bool allocRegs() const { return opts.regAlloc; }
+
+	// ******************************************************
+	// allocReg
+	//    claim and return a free register from the pool
+	// ******************************************************
+	int allocReg();
+
+	// ******************************************************
+	// claimReg
+	//    claim the given (currently free) pool register
+	// ******************************************************
+	void claimReg(int reg);
+
+	// ******************************************************
+	// freeReg
+	//    release a register; registers outside the pool are
+	//    ignored so callers may "free" T0, A0, etc.
+	// ******************************************************
+	void freeReg(int reg);
+
+	int freeRegCount() const;
+
+	// ******************************************************
+	// saveLiveRegs
+	//    push every claimed register and release it, so a
+	//    call may use the whole pool; returns what was saved
+	// restoreLiveRegs
+	//    pop and re-claim the registers saveLiveRegs saved
+	// ******************************************************
+	std::vector<int> saveLiveRegs();
+	void restoreLiveRegs(const std::vector<int>& saved);
+
+	// the allocatable registers, in preference order
+	static const std::vector<int>& regPool() { return REG_POOL; }
 
 private:
 	// for pretty printing generated code
@@ -168,6 +417,31 @@ private:
 	// for generating labels
 	int currLabel;
 
+	// see getStackDepth
+	int stackDepth = 0;
+
+	LilC_Options opts;
+
+	// code generated since the last flush
+	std::vector<MipsInstr> code;
+	void emit(MipsInstr::Form form, MipsOp op, MipsOperand arg1,
+		MipsOperand arg2, MipsOperand arg3, const char * comment);
+	void render(const MipsInstr& instr, std::string& text) const;
+	void renderOperand(const MipsOperand& operand, std::string& text) const;
+
+	// strings referred to by id from the buffered code
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, int> stringIds;
+	// comment literals already interned, by address
+	std::unordered_map<const char *, int> literalIds;
+	int intern(const std::string& str);
+	int internLiteral(const char * literal);
+
+	// registers handed out by allocReg, in preference order
+	static const std::vector<int> REG_POOL;
+	std::vector<bool> regBusy;
+	int poolIndex(int reg) const;
+
 };
 
 } // End namespace LILC
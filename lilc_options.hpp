@@ -0,0 +1,142 @@
+#ifndef __LILC_OPTIONS_HPP__
+#define __LILC_OPTIONS_HPP__ 1
+
+#include <string>
+
+namespace LILC{
+
+/* Settings picked on the lilcc command line that change how code
+  is generated. An optimization level (-O0, -O1, ...) turns on a
+  bundle of the individual switches, and -f<name> / -fno-<name>
+  can then flip any one of them.
+*/
+class LilC_Options{
+public:
+	LilC_Options(){ setOptLevel(0); }
+
+	void setOptLevel(int level){
+		optLevel = level;
+		regAlloc = level >= 1;
+		constFold = level >= 1;
+		deadCode = level >= 1;
+		condBranch = level >= 1;
+		ir = level >= 2;
+		inlineCalls = level >= 2;
+		tailCalls = level >= 2;
+		cse = level >= 2;
+		loopOpt = level >= 2;
+		peephole = level >= 2;
+	}
+
+	/* Set the switch called name, returning false if there
+	  is no switch by that name
+	*/
+	bool setFlag(std::string name, bool value){
+		if (name == "regalloc"){
+			regAlloc = value;
+			return true;
+		}
+		if (name == "fold"){
+			constFold = value;
+			return true;
+		}
+		if (name == "dce"){
+			deadCode = value;
+			return true;
+		}
+		if (name == "cond-branch"){
+			condBranch = value;
+			return true;
+		}
+		if (name == "ir"){
+			ir = value;
+			return true;
+		}
+		if (name == "inline"){
+			inlineCalls = value;
+			return true;
+		}
+		if (name == "tail-calls"){
+			tailCalls = value;
+			return true;
+		}
+		if (name == "cse"){
+			cse = value;
+			return true;
+		}
+		if (name == "loop-opt"){
+			loopOpt = value;
+			return true;
+		}
+		if (name == "peephole"){
+			peephole = value;
+			return true;
+		}
+		if (name == "peephole-stats"){
+			peepholeStats = value;
+			return true;
+		}
+		if (name == "dump-ir"){
+			dumpIR = value;
+			return true;
+		}
+		if (name == "dfa-scanner"){
+			dfaScanner = value;
+			return true;
+		}
+		return false;
+	}
+
+	int optLevel;
+
+	// Evaluate expressions in registers instead of on the stack
+	bool regAlloc;
+
+	// Fold constant expressions and simplify identities
+	bool constFold;
+
+	// Drop unreachable statements and functions main never calls
+	bool deadCode;
+
+	// Compile if/while conditions straight to branches
+	bool condBranch;
+
+	// Lower to the three-address IR and generate code from it
+	bool ir;
+
+	// Replace calls to small functions with their bodies (IR only)
+	bool inlineCalls;
+
+	// The most IR instructions a function may have and be inlined
+	int inlineLimit = 24;
+
+	// Turn self-recursive tail calls into loops (IR only)
+	bool tailCalls;
+
+	// Reuse values already computed in the same block (IR only)
+	bool cse;
+
+	// Hoist loop invariants and strength-reduce induction
+	// variable multiplies (IR only)
+	bool loopOpt;
+
+	// Clean up the generated instructions before writing them out
+	bool peephole;
+
+	// Print the IR to stderr before generating code from it
+	bool dumpIR = false;
+
+	// Scan with the hand-written LilC_DFAScanner instead of flex.
+	// A build without flex has no other scanner.
+#ifdef LILC_NO_FLEX
+	bool dfaScanner = true;
+#else
+	bool dfaScanner = false;
+#endif
+
+	// Print what the peephole optimizer removed to stderr
+	bool peepholeStats = false;
+
+}; // end class LilC_Options
+} /* end namespace */
+#endif /* END __LILC_OPTIONS_HPP__ */
@@ -0,0 +1,377 @@
+#include <algorithm>
+#include "err.hpp"
+#include "lilc_peephole.hpp"
+
+namespace LILC{
+
+namespace {
+
+/* What a buffered instruction does to the registers, as far as
+  the peephole rules need to know. Anything the rules don't
+  understand is a barrier, which no rule looks across.
+*/
+struct Effects {
+	MipsOperand def;
+	std::vector<MipsOperand> uses;
+	// safe to delete if def is never read
+	bool pure = false;
+	// ends the straight-line window the rules look at
+	bool barrier = false;
+	// may write registers other than def (calls, syscalls)
+	bool clobbers = false;
+};
+
+const MipsOperand SP = MipsOperand::reg(MipsReg::SP);
+const MipsOperand FOUR = MipsOperand::imm(4);
+
+bool isBranch(MipsOp op){
+	switch (op) {
+	case MipsOp::BEQ:
+	case MipsOp::BNE:
+	case MipsOp::BLT:
+	case MipsOp::BGT:
+	case MipsOp::BLE:
+	case MipsOp::BGE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+Effects effects(const MipsInstr& instr){
+	Effects fx;
+	auto use = [&](const MipsOperand& arg){
+		if (arg.isReg()) { fx.uses.push_back(arg); }
+	};
+
+	if (instr.form == MipsInstr::Form::INDEXED) {
+		if (instr.op == MipsOp::LW || instr.op == MipsOp::LA) {
+			fx.def = instr.arg1;
+			fx.pure = true;
+		} else if (instr.op == MipsOp::SW) {
+			use(instr.arg1);
+		} else {
+			fx.barrier = true;
+		}
+		use(instr.arg2);
+		return fx;
+	}
+	if (instr.form != MipsInstr::Form::PLAIN) {
+		fx.barrier = true;
+		fx.clobbers = instr.form == MipsInstr::Form::RAW;
+		return fx;
+	}
+
+	switch (instr.op) {
+	case MipsOp::NONE:
+		// comment-only line
+		break;
+	case MipsOp::ADD:
+	case MipsOp::ADDI:
+	case MipsOp::ADDU:
+	case MipsOp::ADDIU:
+	case MipsOp::SUB:
+	case MipsOp::SUBU:
+	case MipsOp::MUL:
+	case MipsOp::AND:
+	case MipsOp::ANDI:
+	case MipsOp::OR:
+	case MipsOp::ORI:
+	case MipsOp::XOR:
+	case MipsOp::XORI:
+	case MipsOp::NOR:
+	case MipsOp::SLL:
+	case MipsOp::SRL:
+	case MipsOp::SRA:
+	case MipsOp::SLLV:
+	case MipsOp::SRLV:
+	case MipsOp::SRAV:
+	case MipsOp::SLT:
+	case MipsOp::SLTU:
+	case MipsOp::SLTI:
+	case MipsOp::SLTIU:
+		fx.def = instr.arg1;
+		// The two-operand form (addi $t0, -1) also reads its target
+		use(instr.arg3.empty() ? instr.arg1 : instr.arg2);
+		use(instr.arg2);
+		use(instr.arg3);
+		fx.pure = true;
+		break;
+	case MipsOp::MOVE:
+	case MipsOp::NEG:
+	case MipsOp::NOT:
+	case MipsOp::LI:
+	case MipsOp::LA:
+	case MipsOp::LW:
+	case MipsOp::MFLO:
+	case MipsOp::MFHI:
+		fx.def = instr.arg1;
+		use(instr.arg2);
+		fx.pure = true;
+		break;
+	case MipsOp::DIV:
+		if (!instr.arg3.empty()) {
+			// the three-operand pseudo-instruction traps on zero
+			fx.barrier = true;
+		}
+		use(instr.arg1);
+		use(instr.arg2);
+		break;
+	case MipsOp::SW:
+	case MipsOp::MULT:
+		use(instr.arg1);
+		use(instr.arg2);
+		break;
+	case MipsOp::B:
+	case MipsOp::J:
+		fx.barrier = true;
+		break;
+	default:
+		// branches, calls, syscalls, directives
+		use(instr.arg1);
+		use(instr.arg2);
+		fx.barrier = true;
+		fx.clobbers = !isBranch(instr.op);
+		break;
+	}
+	return fx;
+}
+
+bool reads(const Effects& fx, const MipsOperand& reg){
+	return std::find(fx.uses.begin(), fx.uses.end(), reg) != fx.uses.end();
+}
+
+bool touches(const Effects& fx, const MipsOperand& reg){
+	return fx.def == reg || reads(fx, reg);
+}
+
+// addu $sp, $sp, 4 at i
+bool isDrop(const std::vector<MipsInstr>& code, size_t i){
+	return i < code.size()
+		&& code[i].form == MipsInstr::Form::PLAIN
+		&& code[i].op == MipsOp::ADDU && code[i].arg1 == SP
+		&& code[i].arg2 == SP && code[i].arg3 == FOUR;
+}
+
+// sw R, 0($sp) / subu $sp, $sp, 4 starting at i
+bool isPush(const std::vector<MipsInstr>& code, size_t i){
+	return i + 1 < code.size()
+		&& code[i].form == MipsInstr::Form::INDEXED
+		&& code[i].op == MipsOp::SW && code[i].arg2 == SP
+		&& code[i].offset == 0
+		&& code[i + 1].form == MipsInstr::Form::PLAIN
+		&& code[i + 1].op == MipsOp::SUBU && code[i + 1].arg1 == SP
+		&& code[i + 1].arg2 == SP && code[i + 1].arg3 == FOUR;
+}
+
+// lw R, 4($sp) / addu $sp, $sp, 4 starting at i
+bool isPop(const std::vector<MipsInstr>& code, size_t i){
+	return i + 1 < code.size()
+		&& code[i].form == MipsInstr::Form::INDEXED
+		&& code[i].op == MipsOp::LW && code[i].arg2 == SP
+		&& code[i].offset == 4
+		&& isDrop(code, i + 1);
+}
+
+// Registers whose values no rule may discard
+bool isProtected(const MipsOperand& reg){
+	return reg.value == MipsReg::SP || reg.value == MipsReg::FP
+		|| reg.value == MipsReg::RA || reg.value == MipsReg::ZERO;
+}
+
+int compact(std::vector<MipsInstr>& code, const std::vector<bool>& dead){
+	size_t kept = 0;
+	for (size_t i = 0; i < code.size(); i++) {
+		if (!dead[i]) { code[kept++] = code[i]; }
+	}
+	int removed = static_cast<int>(code.size() - kept);
+	code.resize(kept);
+	return removed;
+}
+
+} // end anonymous namespace
+
+void LilC_Peephole::run(std::vector<MipsInstr>& code){
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		changed = pushPop(code) || changed;
+		changed = moves(code) || changed;
+		changed = jumpsToNext(code) || changed;
+		changed = redundantLoads(code) || changed;
+		changed = deadWrites(code) || changed;
+	}
+}
+
+/*
+* A push of R matched by a pop into S, with nothing in between
+* that touches $sp, writes R, or touches S, is just "move S, R"
+* (or nothing at all when S is R). A push that is immediately
+* dropped again is removed outright.
+*/
+bool LilC_Peephole::pushPop(std::vector<MipsInstr>& code){
+	std::vector<bool> dead(code.size(), false);
+	for (size_t i = 0; i < code.size(); i++) {
+		if (dead[i] || !isPush(code, i)) { continue; }
+		if (isDrop(code, i + 2)) {
+			dead[i] = dead[i + 1] = dead[i + 2] = true;
+			continue;
+		}
+		MipsOperand pushed = code[i].arg1;
+		std::vector<MipsOperand> touched;
+		for (size_t j = i + 2; j < code.size(); j++) {
+			if (dead[j]) { continue; }
+			if (isPop(code, j)) {
+				MipsOperand popped = code[j].arg1;
+				if (std::find(touched.begin(), touched.end(), popped)
+					!= touched.end()) {
+					break;
+				}
+				dead[i] = dead[i + 1] = dead[j + 1] = true;
+				if (popped == pushed) {
+					dead[j] = true;
+				} else {
+					MipsInstr move;
+					move.op = MipsOp::MOVE;
+					move.arg1 = popped;
+					move.arg2 = pushed;
+					code[j] = move;
+				}
+				break;
+			}
+			Effects fx = effects(code[j]);
+			if (fx.barrier || touches(fx, SP) || fx.def == pushed) {
+				break;
+			}
+			if (!fx.def.empty()) { touched.push_back(fx.def); }
+			touched.insert(touched.end(), fx.uses.begin(), fx.uses.end());
+		}
+	}
+	int removed = compact(code, dead);
+	myStats.pushPop += removed;
+	return removed > 0;
+}
+
+// move R, R and the second half of move A, B / move B, A
+bool LilC_Peephole::moves(std::vector<MipsInstr>& code){
+	std::vector<bool> dead(code.size(), false);
+	for (size_t i = 0; i < code.size(); i++) {
+		const MipsInstr& instr = code[i];
+		if (instr.form != MipsInstr::Form::PLAIN || instr.op != MipsOp::MOVE) {
+			continue;
+		}
+		if (instr.arg1 == instr.arg2) {
+			dead[i] = true;
+			continue;
+		}
+		if (i + 1 < code.size() && !dead[i]) {
+			const MipsInstr& next = code[i + 1];
+			if (next.form == MipsInstr::Form::PLAIN && next.op == MipsOp::MOVE
+				&& next.arg1 == instr.arg2 && next.arg2 == instr.arg1) {
+				dead[i + 1] = true;
+			}
+		}
+	}
+	int removed = compact(code, dead);
+	myStats.moves += removed;
+	return removed > 0;
+}
+
+// Jumps and branches to a label that immediately follows them
+bool LilC_Peephole::jumpsToNext(std::vector<MipsInstr>& code){
+	std::vector<bool> dead(code.size(), false);
+	for (size_t i = 0; i < code.size(); i++) {
+		const MipsInstr& instr = code[i];
+		if (instr.form != MipsInstr::Form::PLAIN) { continue; }
+		MipsOperand target;
+		if (instr.op == MipsOp::J || instr.op == MipsOp::B) {
+			target = instr.arg1;
+		} else if (isBranch(instr.op)) {
+			target = instr.arg3;
+		} else {
+			continue;
+		}
+		for (size_t j = i + 1; j < code.size(); j++) {
+			if (code[j].form != MipsInstr::Form::LABEL) { break; }
+			if (code[j].label == target) {
+				dead[i] = true;
+				break;
+			}
+		}
+	}
+	int removed = compact(code, dead);
+	myStats.jumps += removed;
+	return removed > 0;
+}
+
+// li R, c when R is already known to hold c in this block
+bool LilC_Peephole::redundantLoads(std::vector<MipsInstr>& code){
+	std::vector<bool> dead(code.size(), false);
+	std::vector<std::pair<MipsOperand, MipsOperand>> known;
+	auto forget = [&](const MipsOperand& reg){
+		known.erase(std::remove_if(known.begin(), known.end(),
+			[&](const std::pair<MipsOperand, MipsOperand>& entry){
+				return entry.first == reg;
+			}), known.end());
+	};
+	for (size_t i = 0; i < code.size(); i++) {
+		const MipsInstr& instr = code[i];
+		Effects fx = effects(instr);
+		if (fx.clobbers || instr.form == MipsInstr::Form::LABEL
+			|| instr.form == MipsInstr::Form::LABELED) {
+			known.clear();
+			continue;
+		}
+		if (instr.form == MipsInstr::Form::PLAIN && instr.op == MipsOp::LI) {
+			std::pair<MipsOperand, MipsOperand> value(instr.arg1, instr.arg2);
+			if (std::find(known.begin(), known.end(), value) != known.end()) {
+				dead[i] = true;
+				continue;
+			}
+			forget(instr.arg1);
+			known.push_back(value);
+			continue;
+		}
+		if (!fx.def.empty()) { forget(fx.def); }
+	}
+	int removed = compact(code, dead);
+	myStats.redundantLoads += removed;
+	return removed > 0;
+}
+
+// Side-effect-free writes to a register that is written again
+// before anything reads it
+bool LilC_Peephole::deadWrites(std::vector<MipsInstr>& code){
+	std::vector<bool> dead(code.size(), false);
+	for (size_t i = 0; i < code.size(); i++) {
+		Effects fx = effects(code[i]);
+		if (!fx.pure || fx.def.empty() || isProtected(fx.def)) {
+			continue;
+		}
+		for (size_t j = i + 1; j < code.size(); j++) {
+			if (dead[j]) { continue; }
+			Effects later = effects(code[j]);
+			if (later.barrier || reads(later, fx.def)) { break; }
+			if (later.def == fx.def) {
+				dead[i] = true;
+				break;
+			}
+		}
+	}
+	int removed = compact(code, dead);
+	myStats.deadWrites += removed;
+	return removed > 0;
+}
+
+void LilC_Peephole::printStats(std::ostream& out) const {
+	int total = myStats.pushPop + myStats.moves + myStats.jumps
+		+ myStats.redundantLoads + myStats.deadWrites;
+	out << "peephole: removed " << total << " instructions\n"
+		<< "  push/pop pairs   " << myStats.pushPop << "\n"
+		<< "  redundant moves  " << myStats.moves << "\n"
+		<< "  jumps to next    " << myStats.jumps << "\n"
+		<< "  redundant loads  " << myStats.redundantLoads << "\n"
+		<< "  dead writes      " << myStats.deadWrites << "\n";
+}
+
+} // End namespace LILC
@@ -0,0 +1,44 @@
+#ifndef __LILC_PEEPHOLE_HPP__
+#define __LILC_PEEPHOLE_HPP__ 1
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "lilc_mips.hpp"
+
+namespace LILC{
+
+/* Peephole optimizer over the backend's instruction buffer.
+  Each rule looks at a short window of instructions within a
+  basic block and deletes or rewrites what it can prove
+  redundant; run() repeats the rules until none of them fire.
+  Counts of the instructions each rule removed are kept for
+  printStats.
+*/
+class LilC_Peephole{
+public:
+	void run(std::vector<MipsInstr>& code);
+	void printStats(std::ostream& out) const;
+
+	struct Stats {
+		int pushPop = 0;
+		int moves = 0;
+		int jumps = 0;
+		int redundantLoads = 0;
+		int deadWrites = 0;
+	};
+	const Stats& stats() const { return myStats; }
+
+private:
+	// Each rule returns true if it changed the code
+	bool pushPop(std::vector<MipsInstr>& code);
+	bool moves(std::vector<MipsInstr>& code);
+	bool jumpsToNext(std::vector<MipsInstr>& code);
+	bool redundantLoads(std::vector<MipsInstr>& code);
+	bool deadWrites(std::vector<MipsInstr>& code);
+
+	Stats myStats;
+
+}; // end class LilC_Peephole
+} /* end namespace */
+#endif /* END __LILC_PEEPHOLE_HPP__ */
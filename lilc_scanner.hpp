@@ -6,13 +6,19 @@
 #endif
 
 #include "grammar.hh"
+#include "lilc_source.hpp"
+#include "name_table.hpp"
+#include "tokens.hpp"
 
 namespace LILC{
 
 class LilC_Scanner : public yyFlexLexer{
 public:
    
-   LilC_Scanner(std::istream *in) : yyFlexLexer(in)
+   LilC_Scanner(LilC_Source& sourceIn, TokenBuffer& tokensIn,
+	NameTable& namesIn)
+   : yyFlexLexer(&sourceIn.stream()), source(sourceIn),
+     tokens(tokensIn), names(namesIn)
    {
 	lineNum = 1;
 	charNum = 1;
@@ -20,12 +26,10 @@ public:
    virtual ~LilC_Scanner() {
    };
 
-   //get rid of override virtual function warning
-   using FlexLexer::yylex;
-
-   // YY_DECL defined in the flex file.l
+   // YY_DECL defined in the flex file.l. Appends the next token
+   // to the buffer and returns its tag
    virtual
-   int yylex( LILC::LilC_Parser::semantic_type * const lval);
+   int yylex();
 
    void warn(int lineNumIn, int charNumIn, std::string msg){
 	std::cerr << lineNumIn << ":" << charNumIn 
@@ -38,16 +42,24 @@ public:
    }
 
    int produceNullaryToken(int tag){
-	this->yylval->tokenValue = new NullaryToken(lineNum, charNum, tag);
+	tokens.add(tag, lineNum, charNum);
 	charNum += static_cast<size_t>(yyleng);
 	return tag;
    }
 
 private:
-   /* yyval ptr */
-   LILC::LilC_Parser::semantic_type *yylval = nullptr;
+   // the input; string literal tokens keep spans of it
+   LilC_Source& source;
+   // scanned tokens are appended here, owned by the compiler
+   TokenBuffer& tokens;
+   // identifiers are interned here, also owned by the compiler
+   NameTable& names;
    size_t lineNum;
    size_t charNum;
+   // byte offset of the current match in the source, and of
+   // the input just past it
+   size_t tokenStart = 0;
+   size_t offset = 0;
 };
 
 } /* end namespace */
@@ -0,0 +1,685 @@
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "lilc_sim.hpp"
+
+namespace LILC{
+
+static std::string trim(const std::string& str){
+	size_t start = str.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos){ return ""; }
+	size_t end = str.find_last_not_of(" \t\r\n");
+	return str.substr(start, end - start + 1);
+}
+
+/*
+* Drop a trailing # comment, leaving any # inside a string
+* literal alone
+*/
+static std::string stripComment(const std::string& line){
+	bool inQuote = false;
+	for (size_t i = 0; i < line.size(); i++){
+		char c = line[i];
+		if (inQuote && c == '\\'){ i++; continue; }
+		if (c == '"'){ inQuote = !inQuote; }
+		if (c == '#' && !inQuote){ return line.substr(0, i); }
+	}
+	return line;
+}
+
+/*
+* Split operands on commas that are not inside a string literal
+*/
+static std::vector<std::string> splitArgs(const std::string& args){
+	std::vector<std::string> res;
+	std::string cur;
+	bool inQuote = false;
+	for (size_t i = 0; i < args.size(); i++){
+		char c = args[i];
+		if (inQuote && c == '\\' && i + 1 < args.size()){
+			cur += c;
+			cur += args[++i];
+			continue;
+		}
+		if (c == '"'){ inQuote = !inQuote; }
+		if (c == ',' && !inQuote){
+			res.push_back(trim(cur));
+			cur = "";
+		} else {
+			cur += c;
+		}
+	}
+	cur = trim(cur);
+	if (!cur.empty() || !res.empty()){ res.push_back(cur); }
+	return res;
+}
+
+static int parseReg(const std::string& name){
+	static const char * names[32] = {
+		"zero", "at", "v0", "v1", "a0", "a1", "a2", "a3",
+		"t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+		"s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+		"t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra"
+	};
+	if (name.size() < 2 || name[0] != '$'){ return -1; }
+	std::string reg = name.substr(1);
+	if (isdigit(static_cast<unsigned char>(reg[0]))){
+		int num = atoi(reg.c_str());
+		return (num >= 0 && num < 32) ? num : -1;
+	}
+	for (int i = 0; i < 32; i++){
+		if (reg == names[i]){ return i; }
+	}
+	if (reg == "s8"){ return 30; }
+	return -1;
+}
+
+static bool parseImm(const std::string& str, int32_t& value){
+	if (str.empty()){ return false; }
+	char * end = nullptr;
+	long long val = strtoll(str.c_str(), &end, 0);
+	if (*end != '\0'){ return false; }
+	value = static_cast<int32_t>(val);
+	return true;
+}
+
+static bool isLabelName(const std::string& str){
+	if (str.empty()){ return false; }
+	for (char c : str){
+		if (!isalnum(static_cast<unsigned char>(c))
+			&& c != '_' && c != '.' && c != '$'){
+			return false;
+		}
+	}
+	return !isdigit(static_cast<unsigned char>(str[0]));
+}
+
+/*
+* Parse "off($reg)", "($reg)" or a bare label into a base register
+* and offset (labels are resolved later)
+*/
+static bool parseAddr(const std::string& str, int& base,
+	int32_t& offset, std::string& label)
+{
+	size_t paren = str.find('(');
+	if (paren == std::string::npos){
+		if (!isLabelName(str)){ return false; }
+		base = 0;
+		offset = 0;
+		label = str;
+		return true;
+	}
+	if (str.back() != ')'){ return false; }
+	std::string offStr = trim(str.substr(0, paren));
+	std::string regStr = trim(str.substr(paren + 1,
+		str.size() - paren - 2));
+	base = parseReg(regStr);
+	if (base < 0){ return false; }
+	offset = 0;
+	if (!offStr.empty() && !parseImm(offStr, offset)){ return false; }
+	return true;
+}
+
+static std::string unescape(const std::string& lit, bool& ok){
+	std::string res;
+	ok = lit.size() >= 2 && lit.front() == '"' && lit.back() == '"';
+	if (!ok){ return res; }
+	for (size_t i = 1; i + 1 < lit.size(); i++){
+		char c = lit[i];
+		if (c != '\\'){ res += c; continue; }
+		char esc = lit[++i];
+		switch (esc){
+			case 'n': res += '\n'; break;
+			case 't': res += '\t'; break;
+			case '0': res += '\0'; break;
+			default: res += esc; break;
+		}
+	}
+	return res;
+}
+
+bool LilC_Simulator::load(std::istream& source){
+	std::string line;
+	int lineNum = 0;
+	bool ok = true;
+	while (std::getline(source, line)){
+		lineNum++;
+		if (!assembleLine(line, lineNum)){ ok = false; }
+	}
+	if (labels.find("main") == labels.end()){
+		std::cerr << "lilcsim: no main label" << std::endl;
+		return false;
+	}
+	return ok && resolveLabels();
+}
+
+bool LilC_Simulator::assembleLine(std::string line, int lineNum){
+	line = trim(stripComment(line));
+
+	// Peel off any leading labels
+	while (true){
+		size_t colon = line.find(':');
+		if (colon == std::string::npos){ break; }
+		std::string name = trim(line.substr(0, colon));
+		if (!isLabelName(name)){ break; }
+		labels[name] = inText
+			? TEXT_BASE + static_cast<uint32_t>(text.size() * 4)
+			: dataEnd;
+		line = trim(line.substr(colon + 1));
+	}
+	if (line.empty()){ return true; }
+
+	size_t split = line.find_first_of(" \t");
+	std::string opcode = line.substr(0, split);
+	std::string rest = split == std::string::npos ? ""
+		: trim(line.substr(split));
+	std::vector<std::string> args = splitArgs(rest);
+
+	if (opcode[0] == '.'){
+		if (opcode == ".text"){ inText = true; return true; }
+		if (opcode == ".data"){ inText = false; return true; }
+		if (opcode == ".globl" || opcode == ".global"){
+			return true;
+		}
+		int32_t value = 0;
+		if (opcode == ".align" && args.size() == 1
+			&& parseImm(args[0], value)){
+			uint32_t align = 1u << value;
+			dataEnd = (dataEnd + align - 1) & ~(align - 1);
+			return true;
+		}
+		if (opcode == ".space" && args.size() == 1
+			&& parseImm(args[0], value)){
+			dataEnd += static_cast<uint32_t>(value);
+			return true;
+		}
+		if (opcode == ".word"){
+			for (std::string& arg : args){
+				if (!parseImm(arg, value)){ break; }
+				storeWord(dataEnd, static_cast<uint32_t>(value));
+				dataEnd += 4;
+			}
+			return true;
+		}
+		if (opcode == ".asciiz" || opcode == ".ascii"){
+			bool ok = false;
+			std::string str = unescape(rest, ok);
+			if (ok){
+				for (char c : str){
+					storeByte(dataEnd++, static_cast<uint8_t>(c));
+				}
+				if (opcode == ".asciiz"){ storeByte(dataEnd++, 0); }
+				return true;
+			}
+		}
+		std::cerr << lineNum << ": bad directive " << line << std::endl;
+		return false;
+	}
+
+	Instr instr;
+	instr.line = lineNum;
+	if (!inText || !parseInstr(opcode, args, instr)){
+		std::cerr << lineNum << ": cannot assemble " << line << std::endl;
+		return false;
+	}
+	text.push_back(instr);
+	return true;
+}
+
+bool LilC_Simulator::parseInstr(
+	std::string opcode,
+	std::vector<std::string>& args,
+	Instr& instr
+){
+	static const std::unordered_map<std::string, Op> threeReg = {
+		{"add", Op::ADD}, {"addu", Op::ADDU}, {"sub", Op::SUB},
+		{"subu", Op::SUBU}, {"and", Op::AND}, {"or", Op::OR},
+		{"xor", Op::XOR}, {"nor", Op::NOR}, {"slt", Op::SLT},
+		{"sltu", Op::SLTU}, {"sllv", Op::SLLV}, {"srlv", Op::SRLV},
+		{"srav", Op::SRAV}, {"mul", Op::MUL}, {"seq", Op::SEQ},
+		{"sne", Op::SNE}, {"sgt", Op::SGT}, {"sge", Op::SGE},
+		{"sle", Op::SLE}, {"rem", Op::REM},
+		{"addi", Op::ADD}, {"addiu", Op::ADDU}, {"andi", Op::AND},
+		{"ori", Op::OR}, {"xori", Op::XOR}, {"slti", Op::SLT},
+		{"sltiu", Op::SLTU}, {"sll", Op::SLL}, {"srl", Op::SRL},
+		{"sra", Op::SRA}
+	};
+	static const std::unordered_map<std::string, Op> branches = {
+		{"beq", Op::BEQ}, {"bne", Op::BNE}, {"blt", Op::BLT},
+		{"bgt", Op::BGT}, {"ble", Op::BLE}, {"bge", Op::BGE}
+	};
+	static const std::unordered_map<std::string, Op> zeroBranches = {
+		{"beqz", Op::BEQZ}, {"bnez", Op::BNEZ}, {"bltz", Op::BLTZ},
+		{"bgtz", Op::BGTZ}, {"blez", Op::BLEZ}, {"bgez", Op::BGEZ}
+	};
+	static const std::unordered_map<std::string, Op> memory = {
+		{"lw", Op::LW}, {"sw", Op::SW}, {"lb", Op::LB},
+		{"lbu", Op::LBU}, {"sb", Op::SB}
+	};
+
+	auto itr = threeReg.find(opcode);
+	if (opcode == "div" && args.size() == 3){
+		itr = threeReg.end();
+		instr.op = Op::DIV3;
+	} else if (itr != threeReg.end()){
+		instr.op = itr->second;
+	}
+	if (itr != threeReg.end() || instr.op == Op::DIV3){
+		// "op rd, rs, rt|imm" or the two operand shorthand
+		// "op rd, rt|imm" meaning "op rd, rd, rt|imm"
+		if (args.size() == 2){ args.insert(args.begin(), args[0]); }
+		if (args.size() != 3){ return false; }
+		instr.rd = parseReg(args[0]);
+		instr.rs = parseReg(args[1]);
+		instr.rt = parseReg(args[2]);
+		if (instr.rt < 0){
+			instr.useImm = true;
+			if (!parseImm(args[2], instr.imm)){ return false; }
+			instr.rt = 0;
+		}
+		return instr.rd >= 0 && instr.rs >= 0;
+	}
+
+	auto bItr = branches.find(opcode);
+	if (bItr != branches.end()){
+		if (args.size() != 3){ return false; }
+		instr.op = bItr->second;
+		instr.rs = parseReg(args[0]);
+		instr.rt = parseReg(args[1]);
+		if (instr.rt < 0){
+			instr.useImm = true;
+			instr.rt = 0;
+			if (!parseImm(args[1], instr.imm)){ return false; }
+		}
+		instr.label = args[2];
+		return instr.rs >= 0;
+	}
+
+	bItr = zeroBranches.find(opcode);
+	if (bItr != zeroBranches.end()){
+		if (args.size() != 2){ return false; }
+		instr.op = bItr->second;
+		instr.rs = parseReg(args[0]);
+		instr.label = args[1];
+		return instr.rs >= 0;
+	}
+
+	bItr = memory.find(opcode);
+	if (bItr != memory.end()){
+		if (args.size() != 2){ return false; }
+		instr.op = bItr->second;
+		instr.rt = parseReg(args[0]);
+		return instr.rt >= 0
+			&& parseAddr(args[1], instr.rs, instr.imm, instr.label);
+	}
+
+	if (opcode == "mult" || opcode == "multu"
+		|| opcode == "div" || opcode == "divu"){
+		if (args.size() != 2){ return false; }
+		instr.op = opcode == "mult" ? Op::MULT
+			: opcode == "multu" ? Op::MULTU
+			: opcode == "div" ? Op::DIV : Op::DIVU;
+		instr.rs = parseReg(args[0]);
+		instr.rt = parseReg(args[1]);
+		return instr.rs >= 0 && instr.rt >= 0;
+	}
+	if (opcode == "mflo" || opcode == "mfhi"){
+		// lilcc writes a trailing empty operand here
+		if (args.empty() || args.size() > 2){ return false; }
+		instr.op = opcode == "mflo" ? Op::MFLO : Op::MFHI;
+		instr.rd = parseReg(args[0]);
+		return instr.rd >= 0;
+	}
+	if (opcode == "neg" || opcode == "negu" || opcode == "not"
+		|| opcode == "move"){
+		if (args.size() != 2){ return false; }
+		instr.op = opcode == "move" ? Op::MOVE
+			: opcode == "not" ? Op::NOT : Op::NEG;
+		instr.rd = parseReg(args[0]);
+		instr.rs = parseReg(args[1]);
+		return instr.rd >= 0 && instr.rs >= 0;
+	}
+	if (opcode == "li" || opcode == "lui"){
+		if (args.size() != 2){ return false; }
+		instr.op = opcode == "li" ? Op::LI : Op::LUI;
+		instr.rd = parseReg(args[0]);
+		return instr.rd >= 0 && parseImm(args[1], instr.imm);
+	}
+	if (opcode == "la"){
+		if (args.size() != 2){ return false; }
+		instr.op = Op::LA;
+		instr.rd = parseReg(args[0]);
+		return instr.rd >= 0
+			&& parseAddr(args[1], instr.rs, instr.imm, instr.label);
+	}
+	if (opcode == "b" || opcode == "j" || opcode == "jal"){
+		if (args.size() != 1){ return false; }
+		instr.op = opcode == "jal" ? Op::JAL
+			: opcode == "j" ? Op::J : Op::B;
+		instr.label = args[0];
+		return true;
+	}
+	if (opcode == "jr" || opcode == "jalr"){
+		// lilcc writes a trailing empty operand after jr
+		if (args.empty() || args.size() > 2){ return false; }
+		instr.op = opcode == "jr" ? Op::JR : Op::JALR;
+		instr.rs = parseReg(args[0]);
+		return instr.rs >= 0;
+	}
+	if (opcode == "syscall" || opcode == "nop"){
+		instr.op = opcode == "syscall" ? Op::SYSCALL : Op::NOP;
+		return true;
+	}
+	return false;
+}
+
+bool LilC_Simulator::resolveLabels(){
+	bool ok = true;
+	for (Instr& instr : text){
+		if (instr.label.empty()){ continue; }
+		auto itr = labels.find(instr.label);
+		if (itr == labels.end()){
+			std::cerr << instr.line << ": undefined label "
+				<< instr.label << std::endl;
+			ok = false;
+			continue;
+		}
+		instr.target = itr->second;
+		if (instr.op == Op::LA || instr.op == Op::LW
+			|| instr.op == Op::SW || instr.op == Op::LB
+			|| instr.op == Op::LBU || instr.op == Op::SB){
+			instr.imm += static_cast<int32_t>(instr.target);
+		}
+	}
+	return ok;
+}
+
+uint8_t * LilC_Simulator::page(uint32_t addr){
+	uint32_t num = addr >> PAGE_BITS;
+	if (num == lastPageNum){ return lastPage; }
+	auto& slot = pages[num];
+	if (!slot){
+		slot.reset(new uint8_t[1u << PAGE_BITS]());
+	}
+	lastPageNum = num;
+	lastPage = slot.get();
+	return lastPage;
+}
+
+uint32_t LilC_Simulator::loadWord(uint32_t addr){
+	uint8_t * mem = page(addr) + (addr & ((1u << PAGE_BITS) - 1));
+	uint32_t value;
+	memcpy(&value, mem, 4);
+	return value;
+}
+
+void LilC_Simulator::storeWord(uint32_t addr, uint32_t value){
+	uint8_t * mem = page(addr) + (addr & ((1u << PAGE_BITS) - 1));
+	memcpy(mem, &value, 4);
+}
+
+uint8_t LilC_Simulator::loadByte(uint32_t addr){
+	return page(addr)[addr & ((1u << PAGE_BITS) - 1)];
+}
+
+void LilC_Simulator::storeByte(uint32_t addr, uint8_t value){
+	page(addr)[addr & ((1u << PAGE_BITS) - 1)] = value;
+}
+
+bool LilC_Simulator::fault(const Instr& instr, std::string msg){
+	std::cerr << "lilcsim: line " << instr.line << ": "
+		<< msg << std::endl;
+	halted = true;
+	return false;
+}
+
+bool LilC_Simulator::doSyscall(){
+	myStats.syscalls++;
+	switch (regs[2]){
+		case 1:
+			out << regs[4];
+			return true;
+		case 4: {
+			uint32_t addr = static_cast<uint32_t>(regs[4]);
+			for (uint8_t c = loadByte(addr); c != 0; c = loadByte(++addr)){
+				out << static_cast<char>(c);
+			}
+			return true;
+		}
+		case 5: {
+			int value = 0;
+			in >> value;
+			regs[2] = value;
+			return true;
+		}
+		case 10:
+			halted = true;
+			return true;
+		case 11:
+			out << static_cast<char>(regs[4]);
+			return true;
+		case 17:
+			myExitCode = regs[4];
+			halted = true;
+			return true;
+		default:
+			return false;
+	}
+}
+
+int32_t LilC_Simulator::stackImbalance() const {
+	return static_cast<int32_t>(STACK_TOP - static_cast<uint32_t>(regs[29]));
+}
+
+bool LilC_Simulator::run(uint64_t maxSteps){
+	uint32_t pc = labels["main"];
+	regs[29] = static_cast<int32_t>(STACK_TOP);
+	regs[28] = static_cast<int32_t>(DATA_BASE - 0x8000);
+	regs[31] = 0; // returning to address 0 ends the program
+
+	while (!halted){
+		uint32_t index = (pc - TEXT_BASE) >> 2;
+		if (pc == 0){ break; }
+		if ((pc & 3) != 0 || pc < TEXT_BASE || index >= text.size()){
+			std::cerr << "lilcsim: bad pc " << pc << std::endl;
+			return false;
+		}
+		if (maxSteps != 0 && myStats.instructions >= maxSteps){
+			std::cerr << "lilcsim: step limit reached" << std::endl;
+			return false;
+		}
+		const Instr& instr = text[index];
+		pc += 4;
+		myStats.instructions++;
+
+		uint32_t rsU = static_cast<uint32_t>(regs[instr.rs]);
+		int32_t rs = regs[instr.rs];
+		int32_t rt = instr.useImm ? instr.imm : regs[instr.rt];
+		uint32_t rtU = static_cast<uint32_t>(rt);
+		int32_t * rd = &regs[instr.rd];
+		bool taken = false;
+
+		switch (instr.op){
+			case Op::ADD:
+			case Op::ADDU:
+				*rd = static_cast<int32_t>(rsU + rtU); break;
+			case Op::SUB:
+			case Op::SUBU:
+				*rd = static_cast<int32_t>(rsU - rtU); break;
+			case Op::AND: *rd = rs & rt; break;
+			case Op::OR: *rd = rs | rt; break;
+			case Op::XOR: *rd = rs ^ rt; break;
+			case Op::NOR: *rd = ~(rs | rt); break;
+			case Op::SLT: *rd = rs < rt; break;
+			case Op::SLTU: *rd = rsU < rtU; break;
+			case Op::SEQ: *rd = rs == rt; break;
+			case Op::SNE: *rd = rs != rt; break;
+			case Op::SGT: *rd = rs > rt; break;
+			case Op::SGE: *rd = rs >= rt; break;
+			case Op::SLE: *rd = rs <= rt; break;
+			case Op::SLLV:
+			case Op::SLL:
+				*rd = static_cast<int32_t>(rsU << (rtU & 31)); break;
+			case Op::SRLV:
+			case Op::SRL:
+				*rd = static_cast<int32_t>(rsU >> (rtU & 31)); break;
+			case Op::SRAV:
+			case Op::SRA:
+				*rd = rs >> (rtU & 31); break;
+			case Op::MUL:
+				*rd = static_cast<int32_t>(rsU * rtU); break;
+			case Op::MULT: {
+				int64_t prod = static_cast<int64_t>(rs) * rt;
+				lo = static_cast<int32_t>(prod);
+				hi = static_cast<int32_t>(prod >> 32);
+				break;
+			}
+			case Op::MULTU: {
+				uint64_t prod = static_cast<uint64_t>(rsU) * rtU;
+				lo = static_cast<int32_t>(prod);
+				hi = static_cast<int32_t>(prod >> 32);
+				break;
+			}
+			case Op::DIV:
+			case Op::DIV3:
+			case Op::REM:
+				if (rt == 0){ return fault(instr, "division by zero"); }
+				if (rs == INT32_MIN && rt == -1){
+					lo = rs;
+					hi = 0;
+				} else {
+					lo = rs / rt;
+					hi = rs % rt;
+				}
+				if (instr.op == Op::DIV3){ *rd = lo; }
+				if (instr.op == Op::REM){ *rd = hi; }
+				break;
+			case Op::DIVU:
+				if (rtU == 0){ return fault(instr, "division by zero"); }
+				lo = static_cast<int32_t>(rsU / rtU);
+				hi = static_cast<int32_t>(rsU % rtU);
+				break;
+			case Op::MFLO: *rd = lo; break;
+			case Op::MFHI: *rd = hi; break;
+			case Op::NEG: *rd = static_cast<int32_t>(0u - rsU); break;
+			case Op::NOT: *rd = ~rs; break;
+			case Op::MOVE: *rd = rs; break;
+			case Op::LI: *rd = instr.imm; break;
+			case Op::LUI:
+				*rd = static_cast<int32_t>(
+					static_cast<uint32_t>(instr.imm) << 16);
+				break;
+			case Op::LA:
+				*rd = static_cast<int32_t>(rsU
+					+ static_cast<uint32_t>(instr.imm));
+				break;
+			case Op::LW:
+			case Op::LB:
+			case Op::LBU: {
+				uint32_t addr = rsU + static_cast<uint32_t>(instr.imm);
+				myStats.loads++;
+				if (instr.op == Op::LW){
+					if ((addr & 3) != 0){
+						return fault(instr, "unaligned load");
+					}
+					regs[instr.rt] = static_cast<int32_t>(loadWord(addr));
+				} else if (instr.op == Op::LB){
+					regs[instr.rt] = static_cast<int8_t>(loadByte(addr));
+				} else {
+					regs[instr.rt] = loadByte(addr);
+				}
+				break;
+			}
+			case Op::SW:
+			case Op::SB: {
+				uint32_t addr = rsU + static_cast<uint32_t>(instr.imm);
+				uint32_t value = static_cast<uint32_t>(regs[instr.rt]);
+				myStats.stores++;
+				if (instr.op == Op::SW){
+					if ((addr & 3) != 0){
+						return fault(instr, "unaligned store");
+					}
+					storeWord(addr, value);
+				} else {
+					storeByte(addr, static_cast<uint8_t>(value));
+				}
+				break;
+			}
+			case Op::BEQ: taken = rs == rt; break;
+			case Op::BNE: taken = rs != rt; break;
+			case Op::BLT: taken = rs < rt; break;
+			case Op::BGT: taken = rs > rt; break;
+			case Op::BLE: taken = rs <= rt; break;
+			case Op::BGE: taken = rs >= rt; break;
+			case Op::BEQZ: taken = rs == 0; break;
+			case Op::BNEZ: taken = rs != 0; break;
+			case Op::BLTZ: taken = rs < 0; break;
+			case Op::BGTZ: taken = rs > 0; break;
+			case Op::BLEZ: taken = rs <= 0; break;
+			case Op::BGEZ: taken = rs >= 0; break;
+			case Op::B:
+			case Op::J:
+				myStats.jumps++;
+				pc = instr.target;
+				break;
+			case Op::JAL:
+				myStats.jumps++;
+				myStats.calls++;
+				regs[31] = static_cast<int32_t>(pc);
+				pc = instr.target;
+				break;
+			case Op::JR:
+				myStats.jumps++;
+				pc = rsU;
+				break;
+			case Op::JALR:
+				myStats.jumps++;
+				myStats.calls++;
+				regs[31] = static_cast<int32_t>(pc);
+				pc = rsU;
+				break;
+			case Op::SYSCALL:
+				if (!doSyscall()){
+					return fault(instr, "unsupported syscall");
+				}
+				break;
+			case Op::NOP:
+				break;
+			default:
+				return fault(instr, "unimplemented instruction");
+		}
+
+		if (instr.op >= Op::BEQ && instr.op <= Op::BGEZ){
+			myStats.branches++;
+			if (taken){
+				myStats.branchesTaken++;
+				pc = instr.target;
+			}
+		}
+		regs[0] = 0;
+		uint32_t sp = static_cast<uint32_t>(regs[29]);
+		if (sp <= STACK_TOP && STACK_TOP - sp > myStats.maxStackDepth){
+			myStats.maxStackDepth = STACK_TOP - sp;
+		}
+	}
+	out.flush();
+	return true;
+}
+
+void LilC_Simulator::printStats(std::ostream& os) const {
+	os << "instructions: " << myStats.instructions << "\n"
+		<< "loads:        " << myStats.loads << "\n"
+		<< "stores:       " << myStats.stores << "\n"
+		<< "branches:     " << myStats.branches
+		<< " (" << myStats.branchesTaken << " taken)\n"
+		<< "jumps:        " << myStats.jumps
+		<< " (" << myStats.calls << " calls)\n"
+		<< "syscalls:     " << myStats.syscalls << "\n"
+		<< "max stack:    " << myStats.maxStackDepth << " bytes\n"
+		<< "sp at exit:   " << stackImbalance()
+		<< " bytes below start" << std::endl;
+}
+
+} // End namespace LILC
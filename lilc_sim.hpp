@@ -0,0 +1,119 @@
+#ifndef __LILC_SIM_HPP__
+#define __LILC_SIM_HPP__ 1
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LILC{
+
+// **************************************************************
+// A simulator for the subset of MIPS32 (plus the usual SPIM
+// pseudo-instructions) that lilcc emits. It assembles a .s file
+// into an instruction list and a data image, then runs it from
+// the "main" label and keeps dynamic instruction counts.
+//
+// Supported syscalls: 1 (print int), 4 (print string),
+// 5 (read int), 10 (exit), 11 (print char), 17 (exit2).
+// **************************************************************
+class LilC_Simulator {
+public:
+	struct Stats {
+		uint64_t instructions = 0;
+		uint64_t loads = 0;
+		uint64_t stores = 0;
+		uint64_t branches = 0;
+		uint64_t branchesTaken = 0;
+		uint64_t jumps = 0;
+		uint64_t calls = 0;
+		uint64_t syscalls = 0;
+		uint32_t maxStackDepth = 0;
+	};
+
+	LilC_Simulator(std::istream& inIn, std::ostream& outIn)
+	: in(inIn), out(outIn){ }
+
+	// Assemble the program; on failure, reports each bad line
+	// to std::cerr and returns false
+	bool load(std::istream& source);
+
+	// Run from main until exit. Returns false on a runtime
+	// fault or when maxSteps (if nonzero) is exceeded.
+	bool run(uint64_t maxSteps);
+
+	const Stats& stats() const { return myStats; }
+	int exitCode() const { return myExitCode; }
+	// bytes between the initial stack pointer and $sp at exit
+	int32_t stackImbalance() const;
+	void printStats(std::ostream& os) const;
+
+private:
+	enum class Op {
+		ADD, ADDU, SUB, SUBU, AND, OR, XOR, NOR, SLT, SLTU,
+		SLLV, SRLV, SRAV, MUL, SLL, SRL, SRA,
+		SEQ, SNE, SGT, SGE, SLE,
+		MULT, MULTU, DIV, DIVU, DIV3, REM, MFLO, MFHI,
+		NEG, NOT, MOVE, LI, LA, LUI,
+		LW, SW, LB, LBU, SB,
+		BEQ, BNE, BLT, BGT, BLE, BGE,
+		BEQZ, BNEZ, BLTZ, BGTZ, BLEZ, BGEZ,
+		B, J, JAL, JR, JALR,
+		SYSCALL, NOP
+	};
+
+	struct Instr {
+		Op op = Op::NOP;
+		int rd = 0;
+		int rs = 0;
+		int rt = 0;
+		bool useImm = false;
+		int32_t imm = 0;
+		// label operand, resolved to an address after loading
+		std::string label;
+		uint32_t target = 0;
+		int line = 0;
+	};
+
+	bool assembleLine(std::string text, int lineNum);
+	bool parseInstr(std::string opcode,
+		std::vector<std::string>& args, Instr& instr);
+	bool resolveLabels();
+
+	uint32_t loadWord(uint32_t addr);
+	void storeWord(uint32_t addr, uint32_t value);
+	uint8_t loadByte(uint32_t addr);
+	void storeByte(uint32_t addr, uint8_t value);
+	uint8_t * page(uint32_t addr);
+	bool doSyscall();
+	bool fault(const Instr& instr, std::string msg);
+
+	std::istream& in;
+	std::ostream& out;
+
+	std::vector<Instr> text;
+	std::unordered_map<std::string, uint32_t> labels;
+	uint32_t dataEnd = DATA_BASE;
+	bool inText = true;
+
+	std::unordered_map<uint32_t, std::unique_ptr<uint8_t[]>> pages;
+	uint32_t lastPageNum = 0xffffffff;
+	uint8_t * lastPage = nullptr;
+
+	int32_t regs[32] = {0};
+	int32_t hi = 0;
+	int32_t lo = 0;
+	bool halted = false;
+	int myExitCode = 0;
+	Stats myStats;
+
+	static const uint32_t TEXT_BASE = 0x00400000;
+	static const uint32_t DATA_BASE = 0x10010000;
+	static const uint32_t STACK_TOP = 0x7fffeffc;
+	static const uint32_t PAGE_BITS = 16;
+};
+
+} /* end namespace */
+#endif /* END __LILC_SIM_HPP__ */
@@ -0,0 +1,54 @@
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lilc_source.hpp"
+
+namespace LILC{
+
+void LilC_Source::Buf::set(const char * begin, const char * end){
+	// The get area is only ever read from
+	char * first = const_cast<char *>(begin);
+	setg(first, first, const_cast<char *>(end));
+}
+
+LilC_Source::~LilC_Source(){
+	if (mapped){
+		munmap(const_cast<char *>(myData), mySize);
+	}
+}
+
+bool LilC_Source::open(const char * filename){
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0){ return false; }
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)
+		&& info.st_size > 0){
+		size_t length = static_cast<size_t>(info.st_size);
+		void * mem = mmap(nullptr, length, PROT_READ,
+			MAP_PRIVATE, fd, 0);
+		if (mem != MAP_FAILED){
+			madvise(mem, length, MADV_SEQUENTIAL);
+			myData = static_cast<const char *>(mem);
+			mySize = length;
+			mapped = true;
+		}
+	}
+	close(fd);
+
+	if (!mapped){
+		std::ifstream in(filename, std::ios::binary);
+		if (!in.good()){ return false; }
+		copy.assign(std::istreambuf_iterator<char>(in),
+			std::istreambuf_iterator<char>());
+		myData = copy.data();
+		mySize = copy.size();
+	}
+	buf.set(myData, myData + mySize);
+	return true;
+}
+
+} // End namespace LILC
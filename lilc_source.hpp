@@ -0,0 +1,53 @@
+#ifndef __LILC_SOURCE_HPP__
+#define __LILC_SOURCE_HPP__ 1
+
+#include <cstddef>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace LILC{
+
+/* The text of an input file, mapped into memory read-only. The
+  scanner reads it through stream(), whose buffer is the mapping
+  itself, and tokens that carry text keep an (offset, length)
+  view into it instead of a copy; text() makes the string only
+  when a later stage asks for it. Inputs that cannot be mapped
+  (pipes, empty files) are read into memory instead.
+*/
+class LilC_Source{
+public:
+	LilC_Source() : myStream(&buf){ }
+	LilC_Source(const LilC_Source&) = delete;
+	LilC_Source& operator=(const LilC_Source&) = delete;
+	~LilC_Source();
+
+	// Returns false if the file can't be read
+	bool open(const char * filename);
+
+	const char * data() const { return myData; }
+	size_t size() const { return mySize; }
+	std::string text(size_t offset, size_t length) const {
+		return std::string(myData + offset, length);
+	}
+
+	std::istream& stream(){ return myStream; }
+
+private:
+	// Hands the mapped bytes to the stream without copying them
+	class Buf : public std::streambuf{
+	public:
+		void set(const char * begin, const char * end);
+	};
+
+	const char * myData = nullptr;
+	size_t mySize = 0;
+	bool mapped = false;
+	std::vector<char> copy;
+	Buf buf;
+	std::istream myStream;
+
+}; // end class LilC_Source
+} /* end namespace */
+#endif /* END __LILC_SOURCE_HPP__ */
@@ -0,0 +1,158 @@
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sys/resource.h>
+
+#include "lilc_stats.hpp"
+
+namespace {
+	// Updated by the replacement operator new below. lilcc is
+	// single threaded, so plain counters will do.
+	size_t allocCount = 0;
+	size_t allocBytes = 0;
+
+	void * countedAlloc(size_t size){
+		allocCount++;
+		allocBytes += size;
+		void * mem = std::malloc(size == 0 ? 1 : size);
+		if (mem == nullptr){ throw std::bad_alloc(); }
+		return mem;
+	}
+}
+
+void * operator new(size_t size){ return countedAlloc(size); }
+void * operator new[](size_t size){ return countedAlloc(size); }
+void operator delete(void * mem) noexcept { std::free(mem); }
+void operator delete[](void * mem) noexcept { std::free(mem); }
+void operator delete(void * mem, size_t) noexcept { std::free(mem); }
+void operator delete[](void * mem, size_t) noexcept { std::free(mem); }
+
+namespace LILC{
+
+LilC_PassStats::Sample LilC_PassStats::sample(){
+	Sample res;
+	res.time = std::chrono::steady_clock::now();
+	res.allocs = allocCount;
+	res.allocBytes = allocBytes;
+	return res;
+}
+
+LilC_PassStats::Pass& LilC_PassStats::find(const std::string& name){
+	for (Pass& pass : passes){
+		if (pass.name == name){ return pass; }
+	}
+	passes.push_back(Pass());
+	passes.back().name = name;
+	return passes.back();
+}
+
+void LilC_PassStats::record(const std::string& name, const Sample& start){
+	Sample end = sample();
+	Pass& pass = find(name);
+	pass.wallMs += std::chrono::duration<double, std::milli>(
+		end.time - start.time).count();
+	pass.allocs += end.allocs - start.allocs;
+	pass.allocBytes += end.allocBytes - start.allocBytes;
+	pass.peakRssKb = peakRssKb();
+}
+
+LilC_PassStats::Pass LilC_PassStats::get(const std::string& name) const {
+	for (const Pass& pass : passes){
+		if (pass.name == name){ return pass; }
+	}
+	Pass res;
+	res.name = name;
+	return res;
+}
+
+void LilC_PassStats::deduct(
+	const std::string& outer,
+	const std::string& inner,
+	const Pass& innerBefore
+){
+	Pass innerPass = get(inner);
+	Pass& outerPass = find(outer);
+	outerPass.wallMs -= innerPass.wallMs - innerBefore.wallMs;
+	outerPass.allocs -= innerPass.allocs - innerBefore.allocs;
+	outerPass.allocBytes -= innerPass.allocBytes - innerBefore.allocBytes;
+}
+
+long LilC_PassStats::peakRssKb(){
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0){ return 0; }
+	return usage.ru_maxrss;
+}
+
+void LilC_PassStats::printText(
+	std::ostream& out,
+	bool times,
+	bool mem
+) const {
+	double totalMs = 0;
+	size_t totalAllocs = 0;
+	size_t totalBytes = 0;
+	out << std::left << std::setw(18) << "pass";
+	if (times){ out << std::right << std::setw(12) << "wall ms"; }
+	if (mem){
+		out << std::right << std::setw(12) << "peak KB"
+			<< std::setw(10) << "allocs"
+			<< std::setw(12) << "bytes";
+	}
+	out << "\n";
+	for (const Pass& pass : passes){
+		out << std::left << std::setw(18) << pass.name << std::right;
+		if (times){
+			out << std::setw(12) << std::fixed
+				<< std::setprecision(3) << pass.wallMs;
+		}
+		if (mem){
+			out << std::setw(12) << pass.peakRssKb
+				<< std::setw(10) << pass.allocs
+				<< std::setw(12) << pass.allocBytes;
+		}
+		out << "\n";
+		totalMs += pass.wallMs;
+		totalAllocs += pass.allocs;
+		totalBytes += pass.allocBytes;
+	}
+	out << std::left << std::setw(18) << "total" << std::right;
+	if (times){
+		out << std::setw(12) << std::fixed
+			<< std::setprecision(3) << totalMs;
+	}
+	if (mem){
+		out << std::setw(12) << peakRssKb()
+			<< std::setw(10) << totalAllocs
+			<< std::setw(12) << totalBytes;
+	}
+	out << "\n";
+	if (mem){
+		out << "arena: " << arenaUsed << " bytes used, "
+			<< arenaReserved << " reserved\n";
+	}
+}
+
+void LilC_PassStats::printJson(std::ostream& out) const {
+	double totalMs = 0;
+	out << "{\"passes\": [";
+	bool first = true;
+	for (const Pass& pass : passes){
+		if (first){ first = false; }
+		else { out << ","; }
+		out << "\n  {\"name\": \"" << pass.name << "\""
+			<< ", \"wall_ms\": " << std::fixed
+			<< std::setprecision(3) << pass.wallMs
+			<< ", \"peak_rss_kb\": " << pass.peakRssKb
+			<< ", \"allocs\": " << pass.allocs
+			<< ", \"alloc_bytes\": " << pass.allocBytes << "}";
+		totalMs += pass.wallMs;
+	}
+	out << "\n ],\n \"total_wall_ms\": " << std::fixed
+		<< std::setprecision(3) << totalMs
+		<< ",\n \"peak_rss_kb\": " << peakRssKb()
+		<< ",\n \"arena_bytes_used\": " << arenaUsed
+		<< ",\n \"arena_bytes_reserved\": " << arenaReserved
+		<< "\n}\n";
+}
+
+} // End namespace LILC
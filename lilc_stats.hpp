@@ -0,0 +1,71 @@
+#ifndef __LILC_STATS_HPP__
+#define __LILC_STATS_HPP__ 1
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace LILC{
+
+/* Per-pass instrumentation for --time-passes and --mem-stats.
+  A pass is measured by taking a sample before and after it and
+  recording the difference: wall time, and the number and size of
+  heap allocations made through operator new (counted by the
+  replacement operator new in lilc_stats.cpp). Peak RSS is the
+  process high-water mark as of the end of the pass. Recording the
+  same pass twice adds to it, which is how the scanner's time is
+  collected one token at a time.
+*/
+class LilC_PassStats{
+public:
+	struct Sample {
+		std::chrono::steady_clock::time_point time;
+		size_t allocs;
+		size_t allocBytes;
+	};
+
+	struct Pass {
+		std::string name;
+		double wallMs = 0;
+		size_t allocs = 0;
+		size_t allocBytes = 0;
+		long peakRssKb = 0;
+	};
+
+	bool enabled() const { return isEnabled; }
+	void enable(){ isEnabled = true; }
+
+	static Sample sample();
+	void record(const std::string& name, const Sample& start);
+	// What has been recorded for name so far
+	Pass get(const std::string& name) const;
+	// Take what inner gained since innerBefore out of outer, for
+	// a pass that was partly measured inside an enclosing one
+	void deduct(const std::string& outer, const std::string& inner,
+		const Pass& innerBefore);
+
+	// Arena usage, reported alongside the passes
+	void setArenaBytes(size_t used, size_t reserved){
+		arenaUsed = used;
+		arenaReserved = reserved;
+	}
+
+	void printText(std::ostream& out, bool times, bool mem) const;
+	void printJson(std::ostream& out) const;
+
+	// The process's peak resident set size so far, in kilobytes
+	static long peakRssKb();
+
+private:
+	Pass& find(const std::string& name);
+
+	bool isEnabled = false;
+	std::vector<Pass> passes;
+	size_t arenaUsed = 0;
+	size_t arenaReserved = 0;
+
+}; // end class LilC_PassStats
+} /* end namespace */
+#endif /* END __LILC_STATS_HPP__ */
@@ -0,0 +1,48 @@
+#include "lilc_types.hpp"
+
+namespace LILC{
+
+const LilC_Type LilC_Type::ERROR_TYPE(LilC_Type::Kind::ERROR, "ERROR");
+const LilC_Type LilC_Type::INT_TYPE(LilC_Type::Kind::INT, "int");
+const LilC_Type LilC_Type::BOOL_TYPE(LilC_Type::Kind::BOOL, "bool");
+const LilC_Type LilC_Type::VOID_TYPE(LilC_Type::Kind::VOID, "void");
+const LilC_Type LilC_Type::STRING_TYPE(LilC_Type::Kind::STRING, "string");
+
+const LilC_Type * LilC_TypeTable::named(const std::string& typeString){
+	if (typeString == "int"){ return LilC_Type::intType(); }
+	if (typeString == "bool"){ return LilC_Type::boolType(); }
+	if (typeString == "void"){ return LilC_Type::voidType(); }
+	return intern(LilC_Type::Kind::STRUCT, typeString);
+}
+
+const LilC_Type * LilC_TypeTable::structDefn(const std::string& fields){
+	return intern(LilC_Type::Kind::STRUCT_DEFN, fields);
+}
+
+const LilC_Type * LilC_TypeTable::function(
+	const std::vector<const LilC_Type *>& formals,
+	const LilC_Type * ret
+){
+	std::string str = "";
+	bool first = true;
+	for (const LilC_Type * formal : formals){
+		if (first) { first = false; }
+		else { str += ","; }
+		str += formal->toString();
+	}
+	return intern(LilC_Type::Kind::FN, str + "->" + ret->toString());
+}
+
+const LilC_Type * LilC_TypeTable::intern(
+	LilC_Type::Kind kind,
+	const std::string& str
+){
+	std::string key = std::to_string(static_cast<int>(kind)) + ":" + str;
+	std::unique_ptr<LilC_Type>& slot = types[key];
+	if (!slot){
+		slot.reset(new LilC_Type(kind, str));
+	}
+	return slot.get();
+}
+
+} // End namespace LILC
@@ -2,43 +2,85 @@
 #define __LILC_TYPES_HPP__ 1
 
 #include <string>
-#include <cstddef>
-#include <istream>
-
-#include "err.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace LILC{
 
-/* This class mostly exists to abstract type identification 
-  out of type_analysis
+/* A Lil' C type. Types are hash-consed: the primitives are
+  singletons and LilC_TypeTable hands out exactly one object for
+  each struct and function type, so two types are equal exactly
+  when they are the same pointer. toString() gives the spelling
+  the unparser prints (int, P, {a,b,}, int,bool->void).
 */
-class LilC_Types{
+class LilC_Type{
 public:
-	static bool isPrimitive(std::string& typeString){
-		if (typeString == "bool"){
-			return true;
-		}
-		if (typeString == "void"){
-			return true;
-		}
-		if (typeString == "int"){
-			return true;
-		}
-		if (typeString == "string"){
-			return true;
-		}
-		return false;
-	}
-	static bool isFnSig(std::string typeString){
-		return typeString.find("->") != std::string::npos;
-	}
-	static bool isStructName(std::string typeString){
-		return typeString.find("{") != std::string::npos;
-	}
-	static bool isVoid(std::string typeString){
-		return typeString == "void";
+	enum class Kind {
+		ERROR,       // the result of an expression with a type error
+		INT, BOOL, VOID, STRING,
+		STRUCT,      // a variable of struct type
+		STRUCT_DEFN, // the name of a struct itself
+		FN
+	};
+
+	Kind getKind() const { return myKind; }
+	const std::string& toString() const { return myString; }
+
+	bool isError() const { return myKind == Kind::ERROR; }
+	bool isPrimitive() const {
+		return myKind == Kind::INT || myKind == Kind::BOOL
+			|| myKind == Kind::VOID || myKind == Kind::STRING;
 	}
+	bool isFnSig() const { return myKind == Kind::FN; }
+	bool isStructName() const { return myKind == Kind::STRUCT_DEFN; }
+	bool isVoid() const { return myKind == Kind::VOID; }
+
+	// The primitives
+	static const LilC_Type * error(){ return &ERROR_TYPE; }
+	static const LilC_Type * intType(){ return &INT_TYPE; }
+	static const LilC_Type * boolType(){ return &BOOL_TYPE; }
+	static const LilC_Type * voidType(){ return &VOID_TYPE; }
+	static const LilC_Type * stringType(){ return &STRING_TYPE; }
+
+private:
+	LilC_Type(Kind kind, std::string str)
+	: myKind(kind), myString(str){ }
+
+	Kind myKind;
+	std::string myString;
+
+	static const LilC_Type ERROR_TYPE;
+	static const LilC_Type INT_TYPE;
+	static const LilC_Type BOOL_TYPE;
+	static const LilC_Type VOID_TYPE;
+	static const LilC_Type STRING_TYPE;
+
+	friend class LilC_TypeTable;
+}; // end class LilC_Type
+
+/* Makes the struct and function types, one object per distinct
+  type. Owned by the symbol table, so the types live as long as
+  the symbols that refer to them.
+*/
+class LilC_TypeTable{
+public:
+	// The type named by a declaration: a primitive or a struct
+	const LilC_Type * named(const std::string& typeString);
+
+	// The type of a struct's name, given its spelling ({a,b,})
+	const LilC_Type * structDefn(const std::string& fields);
+
+	const LilC_Type * function(
+		const std::vector<const LilC_Type *>& formals,
+		const LilC_Type * ret);
+
+private:
+	const LilC_Type * intern(LilC_Type::Kind kind, const std::string& str);
+
+	// Keyed by kind and spelling, which identify a type
+	std::unordered_map<std::string, std::unique_ptr<LilC_Type>> types;
+}; // end class LilC_TypeTable
 
-}; // end class lilc_types
 } /* end namespace */
 #endif /* END __LILC_TYPES_HPP__ */
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+
+#include "lilc_sim.hpp"
+
+static int usage(){
+	std::cerr << "Usage: lilcsim [--stats] [--max-steps <n>]"
+		" [--input <file>] <program.s>" << std::endl;
+	return 2;
+}
+
+int
+main( const int argc, const char **argv )
+{
+	bool stats = false;
+	unsigned long long maxSteps = 0;
+	const char * inputFile = nullptr;
+	const char * programFile = nullptr;
+	for (int i = 1; i < argc; i++){
+		std::string arg = argv[i];
+		if (arg == "--stats"){
+			stats = true;
+		} else if (arg == "--max-steps" && i + 1 < argc){
+			maxSteps = strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--input" && i + 1 < argc){
+			inputFile = argv[++i];
+		} else if (programFile == nullptr && arg[0] != '-'){
+			programFile = argv[i];
+		} else {
+			return usage();
+		}
+	}
+	if (programFile == nullptr){ return usage(); }
+
+	std::ifstream program(programFile);
+	if (!program.good()){
+		std::cerr << "Bad input stream " << programFile << std::endl;
+		return 2;
+	}
+	std::ifstream inputStream;
+	if (inputFile != nullptr){
+		inputStream.open(inputFile);
+		if (!inputStream.good()){
+			std::cerr << "Bad input stream " << inputFile << std::endl;
+			return 2;
+		}
+	}
+
+	LILC::LilC_Simulator sim(
+		inputFile != nullptr ? inputStream : std::cin, std::cout);
+	if (!sim.load(program)){ return 2; }
+	bool ok = sim.run(maxSteps);
+	if (stats){
+		std::cerr << "-- lilcsim --" << std::endl;
+		sim.printStats(std::cerr);
+	}
+	if (!ok){ return 3; }
+	return sim.exitCode();
+}
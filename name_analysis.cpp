@@ -44,7 +44,7 @@ bool DeclListNode::nameAnalysisWithOffset(SymbolTable * symTab, int offset){
 		bool thisResult = decl->nameAnalysis(symTab);
 		result = thisResult && result;
 		has_main = decl->hasMain() || has_main;
-		if (result) {symTab->lookup(decl->getName())->setOffset(offset);}
+		if (result) {symTab->lookup(decl->getNameId())->setOffset(offset);}
 		offset = offset - 4;
 	}
 
@@ -63,7 +63,7 @@ bool DeclListNode::globalNameAnalysis(SymbolTable * symTab){
 		bool thisResult = decl->nameAnalysis(symTab);
 		result = thisResult && result;
 		has_main = decl->hasMain() || has_main;
-		if (result) {symTab->lookup(decl->getName())->setGlobal(true);}
+		if (result) {symTab->lookup(decl->getNameId())->setGlobal(true);}
 	}
 
 	return result;
@@ -129,7 +129,7 @@ std::string VarDeclNode::getTypeString(){
 }
 
 bool VarDeclNode::nameAnalysis(SymbolTable * symTab){
-	std::string name = myDeclaredID->getString();
+	int name = getNameId();
 	std::string ePos = getPosition();
 
 	if (myType->isVoid()){ return Err::badVoid(ePos); }
@@ -169,7 +169,7 @@ bool FnDeclNode::nameAnalysis(SymbolTable * symTab){
 	// we'll be putting the function symbol. We
 	// need to track this since we'll be changing
 	// the current scope in the next line.
-	ScopeTable * outerScope = symTab->currentScope();
+	int outerScope = symTab->currentScope();
 
 	//Create a new scope regardless of whether or
 	// not the function signature is valid. Doing
@@ -179,7 +179,7 @@ bool FnDeclNode::nameAnalysis(SymbolTable * symTab){
 	symTab->enterScope();
 
 	bool unique = true;
-	std::string name = myId->getString();
+	int name = myId->getNameId();
 	if (symTab->collides(name)){
 		Err::multiDecl(getPosition());
 		unique = false;
@@ -193,12 +193,12 @@ bool FnDeclNode::nameAnalysis(SymbolTable * symTab){
 		VarSymbol * retSymbol = this->makeRetSymbol(symTab);
 		auto argsSymbols = myFormals->getSymbols();
 
-		FuncSymbol * entry = new FuncSymbol(
-			argsSymbols, retSymbol
+		FuncSymbol * entry = symTab->make<FuncSymbol>(
+			argsSymbols, retSymbol, symTab->getTypes()
 		);
 		entry->setFormalsSize(myFormals->offsetSize());
 		entry->setLocalsSize(myBody->getLocalsSize());
-		outerScope->add(name, entry);
+		symTab->addAt(outerScope, name, entry);
 		myId->setSymbol(entry);
 		ok = true;
 	}
@@ -225,7 +225,7 @@ bool FormalsListNode::nameAnalysis(SymbolTable * symTab) {
 }
 
 bool FormalDeclNode::nameAnalysis(SymbolTable * symTab) {
-	std::string name = myDeclaredID->getString();
+	int name = myDeclaredID->getNameId();
 	std::string ePos = myDeclaredID->getPosition();
 
 	if (myType->isVoid()){ return Err::badVoid(ePos); }
@@ -258,13 +258,12 @@ std::string StructDeclNode::getTypeString(){
 }
 
 bool StructDeclNode::nameAnalysis(SymbolTable * symTab) {
-	std::string typeStr = getTypeString();
-
 	FieldMap * fieldMap = myDeclList->fieldNameAnalysis(symTab);
 	if (!fieldMap){ return false; }
 
-	StructSymbol * mySym = new StructSymbol(fieldMap);
-	if (!symTab->add(typeStr, mySym)){
+	StructSymbol * mySym = symTab->make<StructSymbol>(
+		fieldMap, symTab->getTypes());
+	if (!symTab->add(getNameId(), mySym)){
 		return Err::multiDecl(getPosition());
 	}
 	return true;
@@ -272,7 +271,7 @@ bool StructDeclNode::nameAnalysis(SymbolTable * symTab) {
 
 bool IdNode::nameAnalysis(SymbolTable * symTab) {
 	std::string ePos = getPosition();
-	mySymbol = symTab->lookup(myStrVal);
+	mySymbol = symTab->lookup(myNameId);
 	if(mySymbol == nullptr){
 		return Err::undeclaredID(ePos);
 	}
@@ -368,7 +367,7 @@ bool StmtListNode::nameAnalysisWithOffset(SymbolTable * symTab, int offset) {
 
 bool ExpListNode::nameAnalysis(SymbolTable * symTab) {
 	bool valid = true;
-	for(ExpNode * exp : myExps) {
+	for(ExpNode * exp : *myExps) {
 		valid = exp->nameAnalysis(symTab) && valid;
 	}
 	return valid;
@@ -0,0 +1,25 @@
+#include "name_table.hpp"
+
+namespace LILC{
+
+int NameTable::intern(const std::string& name){
+	auto found = ids.find(name);
+	if (found != ids.end()){ return found->second; }
+	int id = static_cast<int>(names.size());
+	auto inserted = ids.emplace(name, id).first;
+	names.push_back(&inserted->first);
+	return id;
+}
+
+int NameTable::intern(const char * text, size_t length){
+	scratch.assign(text, length);
+	return intern(scratch);
+}
+
+int NameTable::find(const std::string& name) const {
+	auto found = ids.find(name);
+	if (found == ids.end()){ return NO_NAME; }
+	return found->second;
+}
+
+} // End namespace LILC
@@ -0,0 +1,42 @@
+#ifndef __LILC_NAME_TABLE_HPP__
+#define __LILC_NAME_TABLE_HPP__ 1
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LILC{
+
+/* Interned identifiers. The scanner interns each identifier once
+  as it records the ID token; from then on a name is a small dense
+  id, so the symbol table can index bindings by it directly and
+  comparing names is comparing ints. The table owns the text and
+  hands out references that stay valid as long as it does.
+*/
+class NameTable{
+public:
+	// The id for name, adding it if it is new
+	int intern(const std::string& name);
+	// The same, for name given as length chars of text
+	int intern(const char * text, size_t length);
+
+	// The id for name, or NO_NAME if it was never interned
+	int find(const std::string& name) const;
+
+	const std::string& name(int id) const {
+		return *names[static_cast<size_t>(id)];
+	}
+	size_t size() const { return names.size(); }
+
+	static const int NO_NAME = -1;
+
+private:
+	std::unordered_map<std::string, int> ids;
+	// points at the keys of ids, which never move
+	std::vector<const std::string *> names;
+	// reused to look up text without a fresh string each time
+	std::string scratch;
+};
+
+} /* end namespace */
+#endif /* END __LILC_NAME_TABLE_HPP__ */
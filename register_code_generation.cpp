@@ -0,0 +1,265 @@
+#include "err.hpp"
+#include "ast.hpp"
+#include "symbol_table.hpp"
+
+// Code generation for -fregalloc: expressions are evaluated into
+// registers from the backend's pool instead of being pushed and
+// popped. Binary operators use Sethi-Ullman numbering to pick the
+// evaluation order, and spill to the stack only when the pool runs
+// dry.
+
+namespace LILC{
+
+int BinaryExpNode::regNeed(){
+	int need1 = myExp1->regNeed();
+	int need2 = myExp2->regNeed();
+	if (need1 == need2) { return need1 + 1; }
+	return need1 > need2 ? need1 : need2;
+}
+
+// Short-circuit operators release the left operand's register
+// before evaluating the right one
+int AndNode::regNeed(){
+	int need1 = myExp1->regNeed();
+	int need2 = myExp2->regNeed();
+	return need1 > need2 ? need1 : need2;
+}
+
+int OrNode::regNeed(){
+	int need1 = myExp1->regNeed();
+	int need2 = myExp2->regNeed();
+	return need1 > need2 ? need1 : need2;
+}
+
+/*
+* Evaluate both operands into registers. The operand that needs
+* more registers goes first (unless that would reorder side
+* effects), and if the second still doesn't fit in what is left,
+* the first result is spilled to the stack while it runs.
+*/
+void BinaryExpNode::genOperandsReg(
+	LilC_Backend* backend,
+	int& reg1,
+	int& reg2
+){
+	int need1 = myExp1->regNeed();
+	int need2 = myExp2->regNeed();
+	bool reorder = need2 > need1
+		&& !myExp1->hasSideEffects()
+		&& !myExp2->hasSideEffects();
+
+	ExpNode * first = reorder ? myExp2 : myExp1;
+	ExpNode * second = reorder ? myExp1 : myExp2;
+	int firstReg = first->codeGenReg(backend);
+	int secondReg;
+	if (second->regNeed() > backend->freeRegCount()) {
+		backend->genPush(firstReg);
+		backend->freeReg(firstReg);
+		secondReg = second->codeGenReg(backend);
+		firstReg = backend->allocReg();
+		backend->genPop(firstReg);
+	} else {
+		secondReg = second->codeGenReg(backend);
+	}
+
+	reg1 = reorder ? secondReg : firstReg;
+	reg2 = reorder ? firstReg : secondReg;
+}
+
+int StrLitNode::codeGenReg(LilC_Backend* backend) {
+	int reg = backend->allocReg();
+	backend->genStringLitAddr(reg, getString());
+	return reg;
+}
+
+int IntLitNode::codeGenReg(LilC_Backend* backend) {
+	int reg = backend->allocReg();
+	backend->generateImm(MipsOp::LI, reg, myInt);
+	return reg;
+}
+
+int TrueNode::codeGenReg(LilC_Backend* backend) {
+	int reg = backend->allocReg();
+	backend->generateImm(MipsOp::LI, reg, LilC_Backend::TRUE);
+	return reg;
+}
+
+int FalseNode::codeGenReg(LilC_Backend* backend) {
+	int reg = backend->allocReg();
+	backend->generateImm(MipsOp::LI, reg, LilC_Backend::FALSE);
+	return reg;
+}
+
+int IdNode::codeGenReg(LilC_Backend* backend) {
+	int reg = backend->allocReg();
+	backend->genLoad(reg, myStrVal, mySymbol->isGlobal(), mySymbol->getOffset());
+	return reg;
+}
+
+void IdNode::genStore(LilC_Backend* backend, int reg) {
+	backend->genStore(reg, myStrVal, mySymbol->isGlobal(), mySymbol->getOffset());
+}
+
+int AssignNode::codeGenReg(LilC_Backend* backend) {
+	backend->genComment(" Assign");
+	int reg = myExpRHS->codeGenReg(backend);
+	myExpLHS->genStore(backend, reg);
+	return reg;
+}
+
+int CallExpNode::codeGenReg(LilC_Backend* backend) {
+	std::vector<int> saved = backend->saveLiveRegs();
+	for (ExpNode * exp : *myExpList->getExps()) {
+		int reg = exp->codeGenReg(backend);
+		backend->genPush(reg);
+		backend->freeReg(reg);
+	}
+	myId->genJumpAndLink(backend);
+	backend->calleePopped(4 * static_cast<int>(myExpList->getExps()->size()));
+	backend->restoreLiveRegs(saved);
+	int reg = backend->allocReg();
+	backend->generate(MipsOp::MOVE, reg, LilC_Backend::V0);
+	return reg;
+}
+
+int UnaryMinusNode::codeGenReg(LilC_Backend* backend) {
+	int reg = myExp->codeGenReg(backend);
+	backend->generate(MipsOp::SUB, reg, LilC_Backend::ZERO, reg, "UnaryMinusNode");
+	return reg;
+}
+
+int NotNode::codeGenReg(LilC_Backend* backend) {
+	int reg = myExp->codeGenReg(backend);
+	backend->generateImm(MipsOp::XORI, reg, reg, 1, "Not Operation");
+	return reg;
+}
+
+int ShiftLeftNode::codeGenReg(LilC_Backend* backend) {
+	int reg = myExp->codeGenReg(backend);
+	backend->generateImm(MipsOp::SLL, reg, reg, bits);
+	return reg;
+}
+
+int ShiftRightNode::codeGenReg(LilC_Backend* backend) {
+	int reg = myExp->codeGenReg(backend);
+	backend->genDivPow2(reg, LilC_Backend::T1, bits);
+	return reg;
+}
+
+int PlusNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::ADD, reg1, reg1, reg2);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int MinusNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::SUB, reg1, reg1, reg2);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int TimesNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->genMult(reg1, reg2, reg1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int DivideNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->genDiv(reg1, reg2, reg1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int AndNode::codeGenReg(LilC_Backend* backend) {
+	backend->genComment(" AND");
+	MipsOperand exit = backend->nextLabel();
+	int reg = myExp1->codeGenReg(backend);
+	backend->generateBranch(MipsOp::BEQ, reg, LilC_Backend::ZERO, exit);
+	backend->freeReg(reg);
+	int reg2 = myExp2->codeGenReg(backend);
+	if (reg2 != reg) {
+		backend->claimReg(reg);
+		backend->generate(MipsOp::MOVE, reg, reg2);
+		backend->freeReg(reg2);
+	}
+	backend->genLabel(exit, "Exit And expression");
+	return reg;
+}
+
+int OrNode::codeGenReg(LilC_Backend* backend) {
+	backend->genComment(" OR");
+	MipsOperand exit = backend->nextLabel();
+	int reg = myExp1->codeGenReg(backend);
+	backend->generateBranch(MipsOp::BNE, reg, LilC_Backend::ZERO, exit);
+	backend->freeReg(reg);
+	int reg2 = myExp2->codeGenReg(backend);
+	if (reg2 != reg) {
+		backend->claimReg(reg);
+		backend->generate(MipsOp::MOVE, reg, reg2);
+		backend->freeReg(reg2);
+	}
+	backend->genLabel(exit, "Exit or expression");
+	return reg;
+}
+
+int EqualsNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::XOR, reg1, reg1, reg2);
+	backend->generateImm(MipsOp::SLTIU, reg1, reg1, 1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int NotEqualsNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::XOR, reg1, reg1, reg2);
+	backend->generate(MipsOp::SLTU, reg1, LilC_Backend::ZERO, reg1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int LessNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::SLT, reg1, reg1, reg2);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int GreaterNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::SLT, reg1, reg2, reg1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int LessEqNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::SLT, reg1, reg2, reg1);
+	backend->generateImm(MipsOp::XORI, reg1, reg1, 1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+int GreaterEqNode::codeGenReg(LilC_Backend* backend) {
+	int reg1, reg2;
+	genOperandsReg(backend, reg1, reg2);
+	backend->generate(MipsOp::SLT, reg1, reg1, reg2);
+	backend->generateImm(MipsOp::XORI, reg1, reg1, 1);
+	backend->freeReg(reg2);
+	return reg1;
+}
+
+} // End namespace LILC
@@ -1,5 +1,6 @@
 #include "err.hpp"
 #include "symbol_table.hpp"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 namespace LILC{
@@ -9,10 +10,6 @@ SymbolTableEntry::SymbolTableEntry(Kind kind) {
 	myKind = kind;
 }
 
-std::string VarSymbol::getTypeString(){
-	return this->typeString;
-}
-
 VarSymbol * VarSymbol::produce(
 	SymbolTable * symTab, 
 	std::string typeStr
@@ -23,27 +20,25 @@ VarSymbol * VarSymbol::produce(
 	} catch (int i){
 		return nullptr;
 	}
-	return new VarSymbol(typeStr, compositeType);
-}
-
-StructSymbol::StructSymbol( FieldMap * fields) 
-: SymbolTableEntry(Kind::STRUCT){
-	this->fields = fields;
+	return symTab->make<VarSymbol>(
+		symTab->getTypes().named(typeStr), compositeType);
 }
 
-StructSymbol * StructSymbol::getCompositeType(){
-	//Definitions do not have a type
-	return NULL;
-}
+StructSymbol::StructSymbol(FieldMap * fields, LilC_TypeTable& types)
+: SymbolTableEntry(Kind::STRUCT), fields(fields){
 
-std::string StructSymbol::getTypeString(){
 	std::string res = "{";
 	for (auto itr : *fields){
 		std::string key = itr.first;
 		res += key + ",";
 	}
 	res += "}";
-	return res;
+	this->type = types.structDefn(res);
+}
+
+StructSymbol * StructSymbol::getCompositeType(){
+	//Definitions do not have a type
+	return NULL;
 }
 
 StructSymbol * SymbolTable::lookupTypeDefn(std::string typeStr){
@@ -69,18 +64,28 @@ VarSymbol * StructSymbol::getField(std::string fieldName){
 
 FuncSymbol::FuncSymbol(
   std::list<VarSymbol *> * formalSymbols,
-  VarSymbol * retSymbol) 
+  VarSymbol * retSymbol,
+  LilC_TypeTable& types)
 : SymbolTableEntry(Kind::FUNC)
 {
 	if (formalSymbols == nullptr){
 		throw std::runtime_error("NULL formals");
 	}
-	this->formalSymbols = formalSymbols;
+	this->formalSymbols.reset(formalSymbols);
 	this->retSymbol = retSymbol;
+
+	std::vector<const LilC_Type *> formalTypes;
+	for (VarSymbol * paramSym : *formalSymbols){
+		formalTypes.push_back(paramSym->getType());
+	}
+	//An undefined return type has already been reported
+	const LilC_Type * retType = retSymbol == nullptr ?
+		LilC_Type::error() : retSymbol->getType();
+	this->type = types.function(formalTypes, retType);
 }
 
 std::list<VarSymbol *> * FuncSymbol::getFormalSymbols(){
-	return this->formalSymbols;
+	return this->formalSymbols.get();
 }
 
 VarSymbol * FuncSymbol::getRetSymbol(){
@@ -92,100 +97,88 @@ StructSymbol * FuncSymbol::getCompositeType(){
 	return NULL;
 }
 
-std::string FuncSymbol::getTypeString(){
-	std::string res = "";
-
-	bool first = true;
-	for (VarSymbol * paramSym : *formalSymbols){
-		if (first) { first = false; }
-		else { res += ","; }
-		res += paramSym->getTypeString();
-	}
-	return res + "->" + retSymbol->getTypeString();
-}
-
-
 Kind SymbolTableEntry::getKind() {
 	return myKind;
 }
 
-// ScopeTable
-ScopeTable::ScopeTable(){
-	map = new std::unordered_map<std::string, SymbolTableEntry *>();
-}
-
-SymbolTableEntry * ScopeTable::findEntry(std::string name){
-	HashMap<std::string, SymbolTableEntry *>::iterator itr;
-	itr = map->find(name);
-	if (itr == map->end()){ return nullptr; }
-	return itr->second;
-}
-
-Kind ScopeTable::getKind(std::string name) {
-	HashMap<std::string, SymbolTableEntry *>::iterator it = map->find(name);
-	return it->second->getKind(); 
-}
-
-void ScopeTable::add(std::string name, SymbolTableEntry * sym) {
-	map->insert(std::make_pair(name, sym));
-}
-
-std::string ScopeTable::toString(){
-	std::string res = "---SCOPE---\n";
-	HashMap<std::string, SymbolTableEntry *>::iterator it;
-	for (it = map->begin() ; it != map->end() ; ++it){
-		res += it->first + ":" + 
-		it->second->toString() + "\n";
-	}
-	return res;
-}
-
-SymbolTable::SymbolTable(){
-	scopeTables = new std::list<ScopeTable *>();
+SymbolTable::SymbolTable(const NameTable& namesIn) : names(namesIn){
 }
 
 std::string SymbolTable::toString(){
 	std::string res = "";
-	for (ScopeTable * scopeTab : *scopeTables){
-		res += scopeTab->toString();
+	for (size_t i = scopeLog.size(); i-- > 0; ){
+		res += "---SCOPE---\n";
+		// The binding made in this scope, not the innermost one,
+		// which may shadow it
+		for (int name : scopeLog[i]){
+			for (const Binding& binding : bindings[static_cast<size_t>(name)]){
+				if (binding.scope != static_cast<int>(i)){ continue; }
+				res += names.name(name) + ":"
+					+ binding.entry->toString() + "\n";
+			}
+		}
 	}
 	return res;
 }
 
-bool SymbolTable::collides(std::string name){
-	SymbolTableEntry * entry = currentScope()->findEntry(name);
-	return entry != nullptr;
+bool SymbolTable::collides(int name) const {
+	size_t idx = static_cast<size_t>(name);
+	return idx < bindings.size() && !bindings[idx].empty()
+		&& bindings[idx].back().scope == currentScope();
 }
 
-
-ScopeTable * SymbolTable::enterScope() {
-	ScopeTable * res = new ScopeTable();
-	scopeTables->push_front(res);
-	return res;
+void SymbolTable::enterScope() {
+	scopeLog.emplace_back();
 }
 
 void SymbolTable::exitScope() {
-	scopeTables->pop_front();
+	// A scope's bindings are always on top of their stacks
+	// once every scope nested in it has been exited. Only the
+	// bindings go; the symbols stay in the arena for the AST
+	for (int name : scopeLog.back()){
+		bindings[static_cast<size_t>(name)].pop_back();
+	}
+	scopeLog.pop_back();
 }
 
-ScopeTable * SymbolTable::currentScope(){
-	return scopeTables->front();
+int SymbolTable::currentScope() const {
+	return static_cast<int>(scopeLog.size()) - 1;
 }
 
-bool SymbolTable::add(std::string name, SymbolTableEntry * symbol) {
-	if (this->collides(name)){ return false; }
+bool SymbolTable::add(int name, SymbolTableEntry * symbol) {
+	return addAt(currentScope(), name, symbol);
+}
 
-	ScopeTable * cur = currentScope();
-	cur->add(name, symbol);
+bool SymbolTable::addAt(int scope, int name, SymbolTableEntry * symbol) {
+	size_t idx = static_cast<size_t>(name);
+	if (idx >= bindings.size()){
+		bindings.resize(std::max(idx + 1, names.size()));
+	}
+	std::vector<Binding>& stack = bindings[idx];
+	// Keep the stack ordered by scope; adding to an enclosing
+	// scope has to slide under any inner bindings
+	auto pos = stack.end();
+	while (pos != stack.begin() && (pos - 1)->scope >= scope){
+		if ((pos - 1)->scope == scope){ return false; }
+		--pos;
+	}
+	stack.insert(pos, Binding{scope, symbol});
+	scopeLog[static_cast<size_t>(scope)].push_back(name);
 	return true;
 }
 
-SymbolTableEntry * SymbolTable::lookup(std::string name) const {
-	for (ScopeTable * scope : *scopeTables){
-		SymbolTableEntry * res = scope->findEntry(name);
-		if (res != nullptr) { return res; }
+SymbolTableEntry * SymbolTable::lookup(int name) const {
+	size_t idx = static_cast<size_t>(name);
+	if (idx >= bindings.size() || bindings[idx].empty()){
+		return nullptr;
 	}
-	return nullptr;
+	return bindings[idx].back().entry;
+}
+
+SymbolTableEntry * SymbolTable::lookup(const std::string& name) const {
+	int id = names.find(name);
+	if (id == NameTable::NO_NAME){ return nullptr; }
+	return lookup(id);
 }
 
 } // End namespace LILC
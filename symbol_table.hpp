@@ -3,6 +3,12 @@
 #include <string>
 #include <unordered_map>
 #include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lilc_arena.hpp"
+#include "name_table.hpp"
+#include "lilc_types.hpp"
 
 namespace LILC{
 	class VarSymbol;
@@ -22,7 +28,6 @@ using namespace std;
 
 namespace LILC{
 
-class ScopeTable;
 class SymbolTable;
 class StructSymbol;
 
@@ -33,10 +38,12 @@ enum class DeclKind { VAR, FORMAL, FUNC, STRUCT };
 class SymbolTableEntry{
 	public:
 		SymbolTableEntry(Kind kind);
+		virtual ~SymbolTableEntry() = default;
 		Kind getKind();
-		ScopeTable * getScopeTable() const;
 
-		virtual std::string getTypeString() = 0;
+		virtual const LilC_Type * getType() = 0;
+		// the type's spelling, as the unparser prints it
+		std::string getTypeString() { return getType()->toString(); }
 		virtual StructSymbol * getCompositeType() = 0;
 		virtual std::string toString() {
 			return "Symbol";
@@ -55,17 +62,17 @@ class SymbolTableEntry{
 class VarSymbol : public SymbolTableEntry{
 	public:
 		VarSymbol(
-			std::string typeStringIn,
+			const LilC_Type * typeIn,
 			StructSymbol * structIn = nullptr
 		) : SymbolTableEntry(Kind::VAR) {
-			this->typeString = typeStringIn;
+			this->type = typeIn;
 			typeDefinition = structIn;
 		}
 		static VarSymbol * produce(
 			SymbolTable * symTab,
 			std::string typeStr);
 
-		virtual std::string getTypeString() override;
+		const LilC_Type * getType() override { return type; }
 		StructSymbol * getCompositeType() override{
 			return typeDefinition;
 		}
@@ -73,80 +80,94 @@ class VarSymbol : public SymbolTableEntry{
 			return "VAR:" + getTypeString();
 		}
 	private:
-		std::string typeString;
+		const LilC_Type * type;
 		StructSymbol * typeDefinition;
 };
 
 class StructSymbol : public SymbolTableEntry{
 	public:
-		StructSymbol(FieldMap * fields);
+		StructSymbol(FieldMap * fields, LilC_TypeTable& types);
 		VarSymbol * getField(std::string fieldName);
 		StructSymbol * getCompositeType() override;
-		std::string getTypeString() override;
+		const LilC_Type * getType() override { return type; }
 		std::string toString() override {
 			return this->getTypeString();
 		}
 	private:
-		FieldMap * fields;
-		std::string typeName;
+		std::unique_ptr<FieldMap> fields;
+		const LilC_Type * type;
 };
 
 class FuncSymbol : public SymbolTableEntry{
 	public:
 		FuncSymbol(
 		  std::list<VarSymbol *> * formalSymbols,
-		  VarSymbol * retSymbol
+		  VarSymbol * retSymbol,
+		  LilC_TypeTable& types
 		);
 		std::string toString() override {
 			return "FuncSymbol";
 		}
 		VarSymbol * getRetSymbol();
 		StructSymbol * getCompositeType() override;
-		std::string getTypeString() override;
+		const LilC_Type * getType() override { return type; }
 		std::list<VarSymbol *> * getFormalSymbols();
 		int getFormalsSize() {return formalsSize;}
 		void setFormalsSize(int size) {this->formalsSize = size;}
 		int getLocalsSize() {return localsSize;}
 		void setLocalsSize(int size) {this->localsSize = size;}
 	private:
-		std::list<VarSymbol *> * formalSymbols;
+		std::unique_ptr<std::list<VarSymbol *>> formalSymbols;
 		VarSymbol * retSymbol;
+		const LilC_Type * type;
 		int formalsSize = 0;
 		int localsSize = 0;
 };
 
-//A single scope
-class ScopeTable{
-	public:
-		ScopeTable();
-
-		Kind getKind(std::string name);
-		SymbolTableEntry * findEntry(std::string name);
-
-		void add(std::string name, SymbolTableEntry * entry);
-		void remove(std::string name);
-		virtual std::string toString();
-
-	private:
-		HashMap<std::string, SymbolTableEntry *>* map;
-};
-
+/*
+* Names in scope, indexed by interned name id. Each name has a
+* stack of bindings, innermost last, and each open scope logs the
+* names bound in it so exitScope can pop exactly those. Lookup is
+* a single index no matter how deeply scopes nest.
+*
+* The table owns the symbols it hands out (make). The AST keeps
+* pointing at them after their scope is exited, so a popped
+* symbol stays in the table's arena until the table is destroyed.
+*/
 class SymbolTable final {
 	public:
-		SymbolTable();
+		SymbolTable(const NameTable& names);
+
+		// A new symbol, freed along with the table
+		template <typename T, typename... Args>
+		T * make(Args&&... args){
+			return symbols.make<T>(std::forward<Args>(args)...);
+		}
 
-		ScopeTable * enterScope();
+		void enterScope();
 		void exitScope();
-		bool add(std::string name, SymbolTableEntry * ent);
-		SymbolTableEntry * lookup(std::string name) const;
-		bool collides(std::string name);
-		ScopeTable * currentScope();
+		// depth of the innermost open scope (0 is global)
+		int currentScope() const;
+		bool add(int name, SymbolTableEntry * ent);
+		// add to an enclosing scope that is still open
+		bool addAt(int scope, int name, SymbolTableEntry * ent);
+		SymbolTableEntry * lookup(int name) const;
+		SymbolTableEntry * lookup(const std::string& name) const;
+		bool collides(int name) const;
 		StructSymbol * lookupTypeDefn(std::string typeStr);
-		void show() const;
+		LilC_TypeTable& getTypes() { return types; }
 		virtual std::string toString();
 
 	private:
-		std::list<ScopeTable *> * scopeTables;
+		struct Binding {
+			int scope;
+			SymbolTableEntry * entry;
+		};
+		const NameTable& names;
+		std::vector<std::vector<Binding>> bindings;
+		std::vector<std::vector<int>> scopeLog;
+		LilC_TypeTable types;
+		LilC_Arena symbols;
 };
 
 
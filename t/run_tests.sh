@@ -0,0 +1,33 @@
+#!/bin/sh
+# Compile each test program at -O0, -O1 and -O2, run it under
+# lilcsim and compare what it prints with the expected output.
+# t/<name>.lilc reads t/<name>.in if there is one; its output must
+# match t/<name>.out at every level.
+#   t/run_tests.sh [lilcc] [lilcsim] <t/name.lilc>...
+LILCC=${1:-./lilcc}
+SIM=${2:-./lilcsim}
+shift 2
+DIR=$(mktemp -d /tmp/lilc_tests.XXXXXX)
+trap 'rm -rf "$DIR"' EXIT
+
+status=0
+for file in "$@"; do
+	base=${file%.lilc}
+	input=/dev/null
+	[ -f "$base.in" ] && input=$base.in
+	for level in -O0 -O1 -O2; do
+		if ! "$LILCC" $level -S "$DIR/prog.s" "$file" > "$DIR/compile.out" 2>&1; then
+			echo "FAIL $file $level: does not compile"
+			cat "$DIR/compile.out"
+			status=1
+			continue
+		fi
+		"$SIM" "$DIR/prog.s" < "$input" > "$DIR/prog.out" 2>&1
+		if ! diff -u "$base.out" "$DIR/prog.out"; then
+			echo "FAIL $file $level"
+			status=1
+		fi
+	done
+done
+[ $status -eq 0 ] && echo "all $# tests pass at -O0, -O1 and -O2"
+exit $status
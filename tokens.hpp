@@ -1,59 +1,124 @@
 #ifndef LILC_SEMANTIC_SYMBOL_H
 #define LILC_SEMANTIC_SYMBOL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "err.hpp"
-#include <iostream>
+#include "lilc_source.hpp"
+#include "name_table.hpp"
 
 namespace LILC{
 
-class Token {
-	public:
-		std::string name;
-		Token(size_t lineIn, size_t columnIn, int tag){ 
-			this->_tag = tag; 
-			this->line = lineIn;
-			this->column = columnIn;
-		}
-		int tag() { return _tag; }
-		size_t line;
-		size_t column;
-
-	protected:
-		int _tag;
-};
+class TokenBuffer;
 
-class NullaryToken : public Token {
-	public:
-		NullaryToken(size_t liIn, size_t colIn, int tag) 
-		: Token(liIn,colIn,tag) { };
-		int token() { return _tag; } 
-		
-};
+/* A token as the parser sees it: the buffer it lives in and its
+  index there. Plain data, so it can sit in the bison %union.
+*/
+struct TokenRef {
+	const TokenBuffer * buffer;
+	uint32_t index;
 
-class IntLitToken : public Token {
-	public:
-		IntLitToken(size_t line, size_t col, int value); //Defined in lilc_lexer.l
-		int value() { return _value; }
-	private:
-		int _value;
+	int tag() const;
+	size_t line() const;
+	size_t column() const;
+	// ID tokens: the interned name
+	int nameId() const;
+	const std::string& name() const;
+	// INTLITERAL tokens
+	int intValue() const;
+	// STRINGLITERAL tokens: the text, quotes and all, copied out
+	// of the source
+	std::string stringValue() const;
 };
 
-class IDToken : public Token {
-	public:
-		IDToken(size_t line, size_t col, std::string id); //Defined in lilc_lexer.l
-		std::string value() { return _value; }
-	private:
-		std::string _value;
-};
+/* The scanned token stream, as parallel arrays indexed by token
+  number: tag, line, column and a payload, about 14 bytes a token.
+  The payload is the name id of an ID token and an index into the
+  literal side tables for INTLITERAL and STRINGLITERAL tokens;
+  other tokens carry nothing. String literals stay in the source
+  as (offset, length) spans until something asks for their text.
+*/
+class TokenBuffer{
+public:
+	TokenBuffer(const LilC_Source& sourceIn, const NameTable& namesIn)
+	: source(sourceIn), names(namesIn){ }
+
+	// Each returns the new token's index
+	uint32_t add(int tag, size_t line, size_t column){
+		return push(tag, line, column, 0);
+	}
+	uint32_t addID(int tag, size_t line, size_t column, int nameId){
+		return push(tag, line, column, static_cast<uint32_t>(nameId));
+	}
+	uint32_t addInt(int tag, size_t line, size_t column, int value){
+		ints.push_back(value);
+		return push(tag, line, column,
+			static_cast<uint32_t>(ints.size() - 1));
+	}
+	uint32_t addString(int tag, size_t line, size_t column,
+		size_t offset, size_t length){
+		strings.push_back(Span{offset, length});
+		return push(tag, line, column,
+			static_cast<uint32_t>(strings.size() - 1));
+	}
+
+	size_t size() const { return tags.size(); }
+	TokenRef ref(uint32_t i) const { return TokenRef{this, i}; }
 
-class StringLitToken : public Token {
-	public:
-		StringLitToken(size_t line, size_t col, std::string value); //Defined in lilc_lexer.l
-		std::string value() { return _value; }
-	private:
-		std::string _value;
+	int tag(uint32_t i) const { return tags[i]; }
+	size_t line(uint32_t i) const { return lines[i]; }
+	size_t column(uint32_t i) const { return columns[i]; }
+	int nameId(uint32_t i) const {
+		return static_cast<int>(payloads[i]);
+	}
+	const std::string& name(uint32_t i) const {
+		return names.name(nameId(i));
+	}
+	int intValue(uint32_t i) const { return ints[payloads[i]]; }
+	std::string stringValue(uint32_t i) const {
+		const Span& span = strings[payloads[i]];
+		return source.text(span.offset, span.length);
+	}
+
+private:
+	struct Span {
+		size_t offset;
+		size_t length;
+	};
+
+	uint32_t push(int tag, size_t line, size_t column,
+		uint32_t payload){
+		tags.push_back(static_cast<uint16_t>(tag));
+		lines.push_back(static_cast<uint32_t>(line));
+		columns.push_back(static_cast<uint32_t>(column));
+		payloads.push_back(payload);
+		return static_cast<uint32_t>(tags.size() - 1);
+	}
+
+	const LilC_Source& source;
+	const NameTable& names;
+	std::vector<uint16_t> tags;
+	std::vector<uint32_t> lines;
+	std::vector<uint32_t> columns;
+	std::vector<uint32_t> payloads;
+	std::vector<int> ints;
+	std::vector<Span> strings;
 };
 
+inline int TokenRef::tag() const { return buffer->tag(index); }
+inline size_t TokenRef::line() const { return buffer->line(index); }
+inline size_t TokenRef::column() const { return buffer->column(index); }
+inline int TokenRef::nameId() const { return buffer->nameId(index); }
+inline const std::string& TokenRef::name() const {
+	return buffer->name(index);
+}
+inline int TokenRef::intValue() const { return buffer->intValue(index); }
+inline std::string TokenRef::stringValue() const {
+	return buffer->stringValue(index);
+}
+
 } //End namespace
 
 #endif
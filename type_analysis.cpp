@@ -61,39 +61,41 @@ bool StmtListNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 }
 
 bool AssignStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	return myAssign->expTypeAnalysis() != "ERROR";
+	return !myAssign->expTypeAnalysis()->isError();
 }
 
 bool PostIncStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	std::string type = myExp->expTypeAnalysis();
-	if (type == "ERROR"){ return false; }
-	if (type != "int"){
-		return TypeErr::badMath(getPosition()) != "ERROR";
+	const LilC_Type * type = myExp->expTypeAnalysis();
+	if (type->isError()){ return false; }
+	if (type != LilC_Type::intType()){
+		TypeErr::badMath(getPosition());
+		return false;
 	}
 	return true;
 }
 
 bool PostDecStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	std::string type = myExp->expTypeAnalysis();
-	if (type == "ERROR"){ return false; }
-	if (type != "int"){
-		return TypeErr::badMath(getPosition()) != "ERROR";
+	const LilC_Type * type = myExp->expTypeAnalysis();
+	if (type->isError()){ return false; }
+	if (type != LilC_Type::intType()){
+		TypeErr::badMath(getPosition());
+		return false;
 	}
 	return true;
 }
 
 bool ReadStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	std::string type = myExp->expTypeAnalysis();
-	if (type == "ERROR"){ return false; }
-	if (LilC_Types::isFnSig(type)){
+	const LilC_Type * type = myExp->expTypeAnalysis();
+	if (type->isError()){ return false; }
+	if (type->isFnSig()){
 		TypeErr::readFunction(myExp->getPosition());
 		return false;
 	}
-	if (LilC_Types::isStructName(type)){
+	if (type->isStructName()){
 		TypeErr::readStructName(myExp->getPosition());
 		return false;
 	}
-	if (!LilC_Types::isPrimitive(type)){
+	if (!type->isPrimitive()){
 		TypeErr::readStructVar(myExp->getPosition());
 		return false;
 	}
@@ -101,21 +103,21 @@ bool ReadStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 }
 
 bool WriteStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	auto type = myExp->expTypeAnalysis();
-	if (type == "ERROR"){ return false; }
-	if (LilC_Types::isFnSig(type)){
+	const LilC_Type * type = myExp->expTypeAnalysis();
+	if (type->isError()){ return false; }
+	if (type->isFnSig()){
 		TypeErr::writeFunction(myExp->getPosition());
 		return false;
 	}
-	if (LilC_Types::isStructName(type)){
+	if (type->isStructName()){
 		TypeErr::writeStructName(myExp->getPosition());
 		return false;
 	}
-	if (LilC_Types::isVoid(type)){
+	if (type->isVoid()){
 		TypeErr::writeVoid(myExp->getPosition());
 		return false;
 	}
-	if (!LilC_Types::isPrimitive(type)){
+	if (!type->isPrimitive()){
 		TypeErr::writeStructVar(myExp->getPosition());
 		return false;
 	}
@@ -124,9 +126,9 @@ bool WriteStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 }
 
 bool IfStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	std::string expType = this->myExp->expTypeAnalysis();
+	const LilC_Type * expType = this->myExp->expTypeAnalysis();
 	bool result = true;
-	if (expType != "bool"){
+	if (expType != LilC_Type::boolType()){
 		TypeErr::badIfCond(getPosition());
 		result = false;
 	}
@@ -134,9 +136,9 @@ bool IfStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 }
 
 bool IfElseStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	std::string expType = this->myExp->expTypeAnalysis();
+	const LilC_Type * expType = this->myExp->expTypeAnalysis();
 	bool result = true;
-	if (expType != "bool"){
+	if (expType != LilC_Type::boolType()){
 		TypeErr::badIfCond(getPosition());
 		result = false;
 	}
@@ -147,9 +149,9 @@ bool IfElseStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 }
 
 bool WhileStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	std::string expType = this->myExp->expTypeAnalysis();
+	const LilC_Type * expType = this->myExp->expTypeAnalysis();
 	bool result = true;
-	if (expType != "bool"){
+	if (expType != LilC_Type::boolType()){
 		TypeErr::badIfCond(getPosition());
 		result = false;
 	}
@@ -157,24 +159,24 @@ bool WhileStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 }
 
 bool CallStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
-	return myCallExp->expTypeAnalysis() != "ERROR";
+	return !myCallExp->expTypeAnalysis()->isError();
 }
 
 bool ReturnStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 	VarSymbol * retSym = fnSym->getRetSymbol();
-	std::string retType = retSym->getTypeString();
-	if (retType == "ERROR"){ return false; }
+	const LilC_Type * retType = retSym->getType();
+	if (retType->isError()){ return false; }
 
 	if (myExp == NULL){
-		if (retType == "void"){ return true; }
+		if (retType->isVoid()){ return true; }
 		TypeErr::missingReturnValue("0,0");
 		return false;
 	}
-	std::string expType = myExp->expTypeAnalysis();
-	if (expType == "ERROR"){ return false; }
+	const LilC_Type * expType = myExp->expTypeAnalysis();
+	if (expType->isError()){ return false; }
 
 	if (retType != expType){
-		if (retType == "void"){
+		if (retType->isVoid()){
 			TypeErr::returnFromVoid(myExp->getPosition());
 			return false;
 		}
@@ -184,46 +186,46 @@ bool ReturnStmtNode::stmtTypeAnalysis(FuncSymbol * fnSym){
 	return retType == expType;
 }
 
-std::string IdNode::expTypeAnalysis(){
+const LilC_Type * IdNode::expTypeAnalysis(){
 	SymbolTableEntry * mySym = getSymbol();
 	if (mySym == NULL){
 		throw InternalError("Id without a symbol");
 	}
-	return mySym->getTypeString();
+	return mySym->getType();
 }
 
-std::string StrLitNode::expTypeAnalysis(){
-	return "string";
+const LilC_Type * StrLitNode::expTypeAnalysis(){
+	return LilC_Type::stringType();
 }
 
-std::string IntLitNode::expTypeAnalysis(){
-	return "int";
+const LilC_Type * IntLitNode::expTypeAnalysis(){
+	return LilC_Type::intType();
 }
 
-std::string BinaryExpNode::expectedResType(){
+const LilC_Type * BinaryExpNode::expectedResType(){
 	switch (this->binOpKind()){
 		case BinOpKind::MATH:
-			return "int";
+			return LilC_Type::intType();
 		case BinOpKind::LOG:
-			return "bool";
+			return LilC_Type::boolType();
 		case BinOpKind::REL:
-			return "bool";
+			return LilC_Type::boolType();
 		default:
 			throw InternalError(
 				"Unknown binary operation kind");
 	}
 }
 
-bool BinaryExpNode::acceptsOperandType(std::string opIn){
+bool BinaryExpNode::acceptsOperandType(const LilC_Type * opIn){
 	switch (this->binOpKind()){
 		case BinOpKind::MATH:
-			if (opIn == "int"){ return true; }
+			if (opIn == LilC_Type::intType()){ return true; }
 			return false;
 		case BinOpKind::LOG:
-			if (opIn == "bool"){ return true; }
+			if (opIn == LilC_Type::boolType()){ return true; }
 			return false;
 		case BinOpKind::REL:
-			if (opIn == "int"){ return true; }
+			if (opIn == LilC_Type::intType()){ return true; }
 			return false;
 		default:
 			throw InternalError(
@@ -231,7 +233,7 @@ bool BinaryExpNode::acceptsOperandType(std::string opIn){
 	}
 }
 
-std::string BinaryExpNode::reportOpErr(std::string ePos){
+const LilC_Type * BinaryExpNode::reportOpErr(std::string ePos){
 	switch (this->binOpKind()){
 		case BinOpKind::MATH:
 			return TypeErr::badMath(ePos);
@@ -245,13 +247,13 @@ std::string BinaryExpNode::reportOpErr(std::string ePos){
 	}
 }
 
-std::string BinaryExpNode::expTypeAnalysis(){
+const LilC_Type * BinaryExpNode::expTypeAnalysis(){
 	std::string pos1 = myExp1->getPosition();
 	std::string pos2 = myExp2->getPosition();
-	std::string actualType1 = myExp1->expTypeAnalysis();
-	std::string actualType2 = myExp2->expTypeAnalysis();
-	if (actualType1 == "ERROR" || actualType2 == "ERROR"){
-		return "ERROR";
+	const LilC_Type * actualType1 = myExp1->expTypeAnalysis();
+	const LilC_Type * actualType2 = myExp2->expTypeAnalysis();
+	if (actualType1->isError() || actualType2->isError()){
+		return LilC_Type::error();
 	}
 
 	bool resOk = true;
@@ -264,10 +266,10 @@ std::string BinaryExpNode::expTypeAnalysis(){
 		resOk = false;
 	}
 
-	if (!resOk){ return "ERROR"; }
+	if (!resOk){ return LilC_Type::error(); }
 	else { return expectedResType(); }
 
-	return "ERROR";
+	return LilC_Type::error();
 }
 
 BinOpKind NotEqualsNode::binOpKind() {
@@ -278,33 +280,33 @@ BinOpKind EqualsNode::binOpKind() {
 	throw InternalError("Check the binOp kind of a ==");
 }
 
-static std::string eqTypeAnalysis(
-	std::string lhsType,
-	std::string rhsType,
+static const LilC_Type * eqTypeAnalysis(
+	const LilC_Type * lhsType,
+	const LilC_Type * rhsType,
 	std::string pos
 ){
-	if (lhsType == "ERROR" || rhsType == "ERROR"){
-		return "ERROR";
+	if (lhsType->isError() || rhsType->isError()){
+		return LilC_Type::error();
 	}
 	if (lhsType != rhsType){
 		return TypeErr::typeMismatch(pos);
 	}
-	if (LilC_Types::isFnSig(lhsType)){
+	if (lhsType->isFnSig()){
 		return TypeErr::funEq(pos);
 	}
-	if (LilC_Types::isStructName(lhsType)){
+	if (lhsType->isStructName()){
 		return TypeErr::structNameEq(pos);
 	}
-	if (LilC_Types::isVoid(lhsType)){
+	if (lhsType->isVoid()){
 		return TypeErr::voidEq(pos);
 	}
-	if (!LilC_Types::isPrimitive(lhsType)){
+	if (!lhsType->isPrimitive()){
 		return TypeErr::structVarEq(pos);
 	}
-	return "bool";
+	return LilC_Type::boolType();
 }
 
-std::string EqualsNode::expTypeAnalysis(){
+const LilC_Type * EqualsNode::expTypeAnalysis(){
 	return eqTypeAnalysis(
 		myExp1->expTypeAnalysis(),
 		myExp2->expTypeAnalysis(),
@@ -312,7 +314,7 @@ std::string EqualsNode::expTypeAnalysis(){
 		);
 }
 
-std::string NotEqualsNode::expTypeAnalysis(){
+const LilC_Type * NotEqualsNode::expTypeAnalysis(){
 	return eqTypeAnalysis(
 		myExp1->expTypeAnalysis(),
 		myExp2->expTypeAnalysis(),
@@ -320,23 +322,23 @@ std::string NotEqualsNode::expTypeAnalysis(){
 		);
 }
 
-std::string TrueNode::expTypeAnalysis(){
-	return "bool";
+const LilC_Type * TrueNode::expTypeAnalysis(){
+	return LilC_Type::boolType();
 }
 
-std::string FalseNode::expTypeAnalysis(){
-	return "bool";
+const LilC_Type * FalseNode::expTypeAnalysis(){
+	return LilC_Type::boolType();
 }
 
-std::string DotAccessNode::expTypeAnalysis(){
+const LilC_Type * DotAccessNode::expTypeAnalysis(){
 	SymbolTableEntry * entry = myId->getSymbol();
-	return entry->getTypeString();
+	return entry->getType();
 }
 
-std::string AssignNode::expTypeAnalysis(){
+const LilC_Type * AssignNode::expTypeAnalysis(){
 	std::string errPos = myExpLHS->getPosition();
-	std::string lhsType = myExpLHS->expTypeAnalysis();
-	std::string rhsType = myExpRHS->expTypeAnalysis();
+	const LilC_Type * lhsType = myExpLHS->expTypeAnalysis();
+	const LilC_Type * rhsType = myExpRHS->expTypeAnalysis();
 	//The spec isn't crystal clear whether a type that could
 	// NEVER be an assign operand should raise a report
 	// if the other operand is error. In keeping with the
@@ -344,17 +346,17 @@ std::string AssignNode::expTypeAnalysis(){
 	// raises just 1 error regardless of the type of x, this
 	// implementation doesn't raise an error on x even if it's
 	// a function, etc.
-	if (lhsType == "ERROR" || rhsType == "ERROR"){
-		return "ERROR";
+	if (lhsType->isError() || rhsType->isError()){
+		return LilC_Type::error();
 	}
 	if (lhsType == rhsType){
-		if (LilC_Types::isFnSig(lhsType)){
+		if (lhsType->isFnSig()){
 			return TypeErr::assignFunction(errPos);
 		}
-		if (LilC_Types::isStructName(lhsType)){
+		if (lhsType->isStructName()){
 			return TypeErr::assignStructName(errPos);
 		}
-		if (!LilC_Types::isPrimitive(lhsType)){
+		if (!lhsType->isPrimitive()){
 			return TypeErr::assignStructVar(errPos);
 		}
 		return lhsType;
@@ -362,7 +364,7 @@ std::string AssignNode::expTypeAnalysis(){
 	return TypeErr::typeMismatch(errPos);
 }
 
-std::string CallExpNode::expTypeAnalysis(){
+const LilC_Type * CallExpNode::expTypeAnalysis(){
 	std::string errPos = myId->getPosition();
 	SymbolTableEntry * rawSym = myId->getSymbol();
 	if (rawSym->getKind() != Kind::FUNC){
@@ -370,11 +372,11 @@ std::string CallExpNode::expTypeAnalysis(){
 	}
 	FuncSymbol * fnSym = dynamic_cast<FuncSymbol *>(rawSym);
 	VarSymbol * retVar = fnSym->getRetSymbol();
-	std::string retType = retVar->getTypeString();
+	const LilC_Type * retType = retVar->getType();
 
 	std::list<VarSymbol *> * formals =
 		fnSym->getFormalSymbols();
-	std::list<ExpNode *> * args = myExpList->getExps();
+	NodeList<ExpNode *> * args = myExpList->getExps();
 	//Count args
 	size_t numArgs = args->size();
 	if (numArgs != formals->size()){
@@ -388,19 +390,19 @@ std::string CallExpNode::expTypeAnalysis(){
 			VarSymbol * formal = *formalItr;
 			std::string argErrPos = arg->getPosition();
 
-			std::string actualType =
+			const LilC_Type * actualType =
 				arg->expTypeAnalysis();
-			std::string formalType =
-				formal->getTypeString();
-			if (actualType == "ERROR"){
-				return "ERROR";
+			const LilC_Type * formalType =
+				formal->getType();
+			if (actualType->isError()){
+				return LilC_Type::error();
 			}
-			if (formalType == "ERROR"){
-				return "ERROR";
+			if (formalType->isError()){
+				return LilC_Type::error();
 			}
 			if (actualType != formalType){
 				TypeErr::argMismatch(argErrPos);
-				retType = "ERROR";
+				retType = LilC_Type::error();
 			}
 			argItr++;
 			formalItr++;
@@ -411,17 +413,17 @@ std::string CallExpNode::expTypeAnalysis(){
 
 
 
-std::string NotNode::expTypeAnalysis(){
-	std::string expType = myExp->expTypeAnalysis();
-	if (expType == "ERROR"){ return expType; }
-	if (expType == "bool"){ return expType; }
+const LilC_Type * NotNode::expTypeAnalysis(){
+	const LilC_Type * expType = myExp->expTypeAnalysis();
+	if (expType->isError()){ return expType; }
+	if (expType == LilC_Type::boolType()){ return expType; }
 	return TypeErr::badLogical(myExp->getPosition());
 }
 
-std::string UnaryMinusNode::expTypeAnalysis(){
-	std::string expType = myExp->expTypeAnalysis();
-	if (expType == "ERROR"){ return expType; }
-	if (expType == "int"){ return expType; }
+const LilC_Type * UnaryMinusNode::expTypeAnalysis(){
+	const LilC_Type * expType = myExp->expTypeAnalysis();
+	if (expType->isError()){ return expType; }
+	if (expType == LilC_Type::intType()){ return expType; }
 	return TypeErr::badMath(myExp->getPosition());
 }
 
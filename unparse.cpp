@@ -1,271 +1,305 @@
 #include "ast.hpp"
+#include "ast_visitor.hpp"
 #include "symbol_table.hpp"
 
 namespace LILC{
 
-void ProgramNode::unparse(std::ostream& out, int indent){
-	myDeclList->unparse(out, indent);
-}
+namespace {
+
+class Unparser : public ASTVisitor<Unparser>{
+public:
+	Unparser(std::ostream& outIn) : out(outIn){ }
 
-void DeclListNode::unparse(std::ostream& out, int indent){
-	for (std::list<DeclNode *>::iterator
-		it=myDecls->begin();
-		it != myDecls->end(); ++it){
-	    DeclNode * elt = *it;
-	    elt->unparse(out, indent);
+	// Unparse node at the given indentation
+	void unparse(ASTNode * node, int indentIn){
+		int saved = indent;
+		indent = indentIn;
+		visit(node);
+		indent = saved;
 	}
-}
 
-void FormalsListNode::unparse(std::ostream& out, int indent){
-	bool first = true;
-	for (FormalDeclNode * formal : *myFormals){
-		if (first){ first = false; }
-		else { out << ", "; }
-		formal->unparse(out, indent);
+	void visitNode(ASTNode * node){
+		throw InternalError("unparse: unexpected node at "
+			+ node->getPosition());
 	}
-}
 
-void FnBodyNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "\n{\n";
-	myDeclList->unparse(out, indent+4);
-	myStmtList->unparse(out,indent+4);
-	out << "}\n";
-}
+	void visitProgram(ProgramNode * node){
+		unparse(node->getDeclList(), indent);
+	}
 
-void ExpListNode::unparse(std::ostream& out, int indent){
-	bool first = true;
-	for (ExpNode * exp : myExps){
-		if (first) { first = false; }
-		else { out << ","; }
-		exp->unparse(out, indent);
+	void visitDeclList(DeclListNode * node){
+		for (DeclNode * decl : node->getDecls()){
+			unparse(decl, indent);
+		}
 	}
-}
 
-void StmtListNode::unparse(std::ostream& out, int indent){
-	for (std::list<StmtNode *>::iterator it=myStmts->begin();
-		it != myStmts->end(); ++it){
-	    StmtNode * elt = *it;
-	    elt->unparse(out, indent);
+	void visitFormalsList(FormalsListNode * node){
+		bool first = true;
+		for (FormalDeclNode * formal : node->getFormals()){
+			if (first){ first = false; }
+			else { out << ", "; }
+			unparse(formal, indent);
+		}
 	}
-}
 
-void StmtNode::unparse(std::ostream& out, int indent){
-}
+	void visitFnBody(FnBodyNode * node){
+		doIndent();
+		out << "\n{\n";
+		unparse(node->getDeclList(), indent+4);
+		unparse(node->getStmtList(), indent+4);
+		out << "}\n";
+	}
 
-void VarDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myType->unparse(out, 0);
-	out << " ";
-	out << myDeclaredID->getString();
-	out << ";\n";
-}
+	void visitExpList(ExpListNode * node){
+		bool first = true;
+		for (ExpNode * exp : *node->getExps()){
+			if (first) { first = false; }
+			else { out << ","; }
+			unparse(exp, indent);
+		}
+	}
 
-void FnDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myRetType->unparse(out, 0);
-	out << " ";
-	out << myId->getString();
-	out << "(";
-	myFormals->unparse(out, 0);
-	out << ")";
-	myBody->unparse(out, 0);
-}
+	void visitStmtList(StmtListNode * node){
+		for (StmtNode * stmt : node->getStmts()){
+			unparse(stmt, indent);
+		}
+	}
 
-void FormalDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myType->unparse(out, 0);
-	out << " " << myDeclaredID->getString() << ", " << mySymbol->getOffset();
-}
+	void visitVarDecl(VarDeclNode * node){
+		doIndent();
+		unparse(node->getTypeNode(), 0);
+		out << " ";
+		out << node->getName();
+		out << ";\n";
+	}
 
-void StructDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "struct ";
-	out << myDeclaredID->getString();
-	out << "\n{\n";
-	myDeclList->unparse(out,indent+4);
-	out << "};\n";
-}
+	void visitFnDecl(FnDeclNode * node){
+		doIndent();
+		unparse(node->getRetType(), 0);
+		out << " ";
+		out << node->getName();
+		out << "(";
+		unparse(node->getFormals(), 0);
+		out << ")";
+		unparse(node->getBody(), 0);
+	}
 
-void AssignStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myAssign->unparse(out,0);
-	out << ";\n";
-}
+	void visitFormalDecl(FormalDeclNode * node){
+		doIndent();
+		unparse(node->getTypeNode(), 0);
+		out << " " << node->getName() << ", "
+			<< node->getSymbol()->getOffset();
+	}
 
-void PostIncStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp->unparse(out,0);
-	out << "++;\n";
-}
+	void visitStructDecl(StructDeclNode * node){
+		doIndent();
+		out << "struct ";
+		out << node->getName();
+		out << "\n{\n";
+		unparse(node->getDeclList(), indent+4);
+		out << "};\n";
+	}
 
-void PostDecStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp->unparse(out,0);
-	out << "--;\n";
-}
+	void visitAssignStmt(AssignStmtNode * node){
+		doIndent();
+		unparse(node->getAssign(), 0);
+		out << ";\n";
+	}
 
-void ReadStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "output >> ";
-	myExp->unparse(out,0);
-	out << ";\n";
-}
+	void visitPostIncStmt(PostIncStmtNode * node){
+		doIndent();
+		unparse(node->getExp(), 0);
+		out << "++;\n";
+	}
 
-void WriteStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "input << ";
-	myExp->unparse(out,0);
-	out << ";\n";
-}
+	void visitPostDecStmt(PostDecStmtNode * node){
+		doIndent();
+		unparse(node->getExp(), 0);
+		out << "--;\n";
+	}
 
-void IfStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "if(";
-	myExp->unparse(out,0);
-	out << ") {\n";
-	myDecls->unparse(out,indent+4);
-	myStmts->unparse(out,indent+4);
-	doIndent(out, indent);
-	out << "}\n";
-}
+	void visitReadStmt(ReadStmtNode * node){
+		doIndent();
+		out << "output >> ";
+		unparse(node->getExp(), 0);
+		out << ";\n";
+	}
 
-void IfElseStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "if(";
-	myExp->unparse(out,0);
-	out << ") {\n";
-	myDeclsT->unparse(out,indent+4);
-	myStmtsT->unparse(out,indent+4);
-	doIndent(out, indent);
-	out << "}\n";
-	doIndent(out, indent);
-	out << "else {\n";
-	myDeclsF->unparse(out,indent+4);
-	myStmtsF->unparse(out,indent+4);
-	doIndent(out, indent);
-	out << "}\n";
-}
+	void visitWriteStmt(WriteStmtNode * node){
+		doIndent();
+		out << "input << ";
+		unparse(node->getExp(), 0);
+		out << ";\n";
+	}
 
-void WhileStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "while(";
-	myExp->unparse(out,0);
-	out << ") {\n";
-	myDecls->unparse(out,indent+4);
-	myStmts->unparse(out,indent+4);
-	doIndent(out, indent);
-	out << "}\n";
-}
+	void visitIfStmt(IfStmtNode * node){
+		doIndent();
+		out << "if(";
+		unparse(node->getExp(), 0);
+		out << ") {\n";
+		unparse(node->getDeclList(), indent+4);
+		unparse(node->getStmtList(), indent+4);
+		doIndent();
+		out << "}\n";
+	}
 
-void CallStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myCallExp->unparse(out,0);
-	out << ";\n";
-}
+	void visitIfElseStmt(IfElseStmtNode * node){
+		doIndent();
+		out << "if(";
+		unparse(node->getExp(), 0);
+		out << ") {\n";
+		unparse(node->getThenDeclList(), indent+4);
+		unparse(node->getThenStmtList(), indent+4);
+		doIndent();
+		out << "}\n";
+		doIndent();
+		out << "else {\n";
+		unparse(node->getElseDeclList(), indent+4);
+		unparse(node->getElseStmtList(), indent+4);
+		doIndent();
+		out << "}\n";
+	}
 
-void ReturnStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "return ";
-	if(myExp != nullptr) {
-		myExp->unparse(out,0);
+	void visitWhileStmt(WhileStmtNode * node){
+		doIndent();
+		out << "while(";
+		unparse(node->getExp(), 0);
+		out << ") {\n";
+		unparse(node->getDeclList(), indent+4);
+		unparse(node->getStmtList(), indent+4);
+		doIndent();
+		out << "}\n";
 	}
-	out << ";\n";
-}
 
-void IdNode::unparse(std::ostream& out, int indent){
-	out << myStrVal;
-	if(mySymbol != nullptr) {
-		out << "(" << mySymbol->getTypeString() << ")";
-	} else {
-		throw std::runtime_error("IdNode has no symbol");
-		// error!
+	void visitCallStmt(CallStmtNode * node){
+		doIndent();
+		unparse(node->getCallExp(), 0);
+		out << ";\n";
 	}
-}
 
-void IntNode::unparse(std::ostream& out, int indent){
-	out << "int";
-}
+	void visitReturnStmt(ReturnStmtNode * node){
+		doIndent();
+		out << "return ";
+		if (node->getExp() != nullptr) {
+			unparse(node->getExp(), 0);
+		}
+		out << ";\n";
+	}
 
-void BoolNode::unparse(std::ostream& out, int indent){
-	out << "bool";
-}
+	void visitId(IdNode * node){
+		out << node->getString();
+		if (node->getSymbol() != nullptr) {
+			out << "(" << node->getSymbol()->getTypeString() << ")";
+		} else {
+			throw std::runtime_error("IdNode has no symbol");
+		}
+	}
 
-void VoidNode::unparse(std::ostream& out, int indent){
-	out << "void";
-}
+	void visitIntType(IntNode *){ out << "int"; }
+	void visitBoolType(BoolNode *){ out << "bool"; }
+	void visitVoidType(VoidNode *){ out << "void"; }
 
-void StructNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "struct " << this->myId->getString();
-}
+	void visitStructType(StructNode * node){
+		doIndent();
+		out << "struct " << node->getId()->getString();
+	}
 
-void IntLitNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << myInt;
-}
+	void visitIntLit(IntLitNode * node){
+		doIndent();
+		out << node->getValue();
+	}
 
-void StrLitNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << myString;
-}
+	void visitStrLit(StrLitNode * node){
+		doIndent();
+		out << node->getString();
+	}
 
-void TrueNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "true";
-}
+	void visitTrue(TrueNode *){
+		doIndent();
+		out << "true";
+	}
 
-void FalseNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "false";
-}
+	void visitFalse(FalseNode *){
+		doIndent();
+		out << "false";
+	}
 
-void DotAccessNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp->unparse(out, 0);
-	out << ".";
-	myId->unparse(out, 0);
-}
+	void visitDotAccess(DotAccessNode * node){
+		doIndent();
+		unparse(node->getExp(), 0);
+		out << ".";
+		unparse(node->getId(), 0);
+	}
 
-void AssignNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExpLHS->unparse(out, 0);
-	out << " = ";
-	myExpRHS->unparse(out, 0);
-}
+	void visitAssign(AssignNode * node){
+		doIndent();
+		unparse(node->getLHS(), 0);
+		out << " = ";
+		unparse(node->getRHS(), 0);
+	}
 
-void CallExpNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myId->unparse(out, 0);
-	out << "(";
-	myExpList->unparse(out, 0);
-	out << ")";
-}
+	void visitCallExp(CallExpNode * node){
+		doIndent();
+		unparse(node->getId(), 0);
+		out << "(";
+		unparse(node->getExpList(), 0);
+		out << ")";
+	}
 
-void UnaryMinusNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "(";
-	out << "-";
-	myExp->unparse(out, 0);
-	out << ")";
-}
+	void visitUnaryMinus(UnaryMinusNode * node){
+		doIndent();
+		out << "(";
+		out << "-";
+		unparse(node->getExp(), 0);
+		out << ")";
+	}
 
-void NotNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "(";
-	out << "!";
-	myExp->unparse(out, 0);
-	out << ")";
-}
+	void visitNot(NotNode * node){
+		doIndent();
+		out << "(";
+		out << "!";
+		unparse(node->getExp(), 0);
+		out << ")";
+	}
 
-void BinaryExpNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "(";
-	myExp1->unparse(out, 0);
-	out << myOp();
-	myExp2->unparse(out, 0);
-	out << ")";
-}
+	void visitShiftLeft(ShiftLeftNode * node){
+		doIndent();
+		out << "(";
+		unparse(node->getExp(), 0);
+		out << "*" << (1 << node->getBits());
+		out << ")";
+	}
 
+	void visitShiftRight(ShiftRightNode * node){
+		doIndent();
+		out << "(";
+		unparse(node->getExp(), 0);
+		out << "/" << (1 << node->getBits());
+		out << ")";
+	}
+
+	void visitBinary(BinaryExpNode * node){
+		doIndent();
+		out << "(";
+		unparse(node->getExp1(), 0);
+		out << node->myOp();
+		unparse(node->getExp2(), 0);
+		out << ")";
+	}
+
+private:
+	void doIndent(){
+		for (int k = 0 ; k < indent; k++){ out << " "; }
+	}
+
+	std::ostream& out;
+	int indent = 0;
+};
+
+} // end anonymous namespace
+
+void ProgramNode::unparse(std::ostream& out, int indent){
+	Unparser(out).unparse(this, indent);
+}
 
 } // End namespace LIL' C